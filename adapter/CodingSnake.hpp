@@ -41,12 +41,21 @@
 #include <sstream>
 #include <thread>
 #include <chrono>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
 
 // Third-party dependencies
 // SSL is intentionally disabled to keep setup simple and avoid OpenSSL dependency
 #include "third_party/httplib.h"
 #include "third_party/json.hpp"
 
+// Rules engine for forward simulation (dependency-free, shared with the server)
+#include "SnakeRules.hpp"
+
 using std::string;
 using std::vector;
 using std::map;
@@ -120,6 +129,127 @@ struct Point {
     }
 };
 
+/**
+ * @brief Snake body stored as a ring buffer (index 0 is the head).
+ *
+ * Moving a snake is push_front() + pop_back(), both O(1); the buffer only
+ * reallocates when the snake outgrows its capacity. Reads look like a
+ * vector: size(), operator[], front(), back() and range-for.
+ */
+class SnakeBody {
+private:
+    vector<Point> ring_;        // Capacity is zero or a power of two
+    size_t head_;               // Slot of blocks[0]
+    size_t size_;
+    
+public:
+    class const_iterator {
+    private:
+        const SnakeBody* body_;
+        size_t index_;
+        
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef Point value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef const Point* pointer;
+        typedef const Point& reference;
+        
+        const_iterator() : body_(nullptr), index_(0) {}
+        const_iterator(const SnakeBody* body, size_t index) : body_(body), index_(index) {}
+        
+        reference operator*() const { return (*body_)[index_]; }
+        pointer operator->() const { return &(*body_)[index_]; }
+        const_iterator& operator++() { ++index_; return *this; }
+        const_iterator operator++(int) { const_iterator old = *this; ++index_; return old; }
+        bool operator==(const const_iterator& other) const { return index_ == other.index_ && body_ == other.body_; }
+        bool operator!=(const const_iterator& other) const { return !(*this == other); }
+    };
+    
+    SnakeBody() : head_(0), size_(0) {}
+    
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+    
+    const Point& operator[](size_t i) const { return ring_[(head_ + i) & (ring_.size() - 1)]; }
+    Point& operator[](size_t i) { return ring_[(head_ + i) & (ring_.size() - 1)]; }
+    const Point& front() const { return (*this)[0]; }
+    const Point& back() const { return (*this)[size_ - 1]; }
+    
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const { return const_iterator(this, size_); }
+    
+    /**
+    * @brief Add a block before the head (the snake moved).
+     */
+    void push_front(const Point& p) {
+        if (size_ == ring_.size()) {
+            grow();
+        }
+        head_ = (head_ + ring_.size() - 1) & (ring_.size() - 1);
+        ring_[head_] = p;
+        ++size_;
+    }
+    
+    /**
+    * @brief Add a block after the tail.
+     */
+    void push_back(const Point& p) {
+        if (size_ == ring_.size()) {
+            grow();
+        }
+        ring_[(head_ + size_) & (ring_.size() - 1)] = p;
+        ++size_;
+    }
+    
+    void pop_front() {
+        head_ = (head_ + 1) & (ring_.size() - 1);
+        --size_;
+    }
+    
+    void pop_back() { --size_; }
+    
+    void clear() {
+        head_ = 0;
+        size_ = 0;
+    }
+    
+    template <typename InputIt>
+    void assign(InputIt first, InputIt last) {
+        clear();
+        for (; first != last; ++first) {
+            push_back(*first);
+        }
+    }
+    
+    /**
+    * @brief Check whether a position is on the body.
+     */
+    bool contains(const Point& p) const {
+        for (size_t i = 0; i < size_; ++i) {
+            if ((*this)[i] == p) return true;
+        }
+        return false;
+    }
+    
+    /**
+    * @brief Copy out as a vector (head first).
+     */
+    operator vector<Point>() const {
+        return vector<Point>(begin(), end());
+    }
+    
+private:
+    void grow() {
+        vector<Point> next(ring_.empty() ? 8 : ring_.size() * 2);
+        for (size_t i = 0; i < size_; ++i) {
+            next[i] = (*this)[i];
+        }
+        ring_.swap(next);
+        head_ = 0;
+    }
+};
+
 /**
  * @brief Snake (player).
  */
@@ -128,7 +258,7 @@ struct Snake {
     string name;                // Player name
     string color;               // Snake color
     Point head;                 // Head position
-    vector<Point> blocks;       // All snake blocks (blocks[0] is the head)
+    SnakeBody blocks;           // All snake blocks (blocks[0] is the head)
     int length;                 // Snake length
     int invincible_rounds;      // Remaining invincible rounds
     
@@ -138,10 +268,7 @@ struct Snake {
     * @brief Check whether a position is on the snake body.
      */
     bool contains(const Point& p) const {
-        for (const auto& block : blocks) {
-            if (block == p) return true;
-        }
-        return false;
+        return blocks.contains(p);
     }
     
     /**
@@ -158,6 +285,11 @@ struct Snake {
 
 /**
  * @brief Game state passed to the decision function.
+ *
+ * Besides the player map and food set, the state keeps a flat width x height
+ * occupancy grid (block count and one occupying snake per cell) and a food
+ * bitmap. They are updated incrementally by every mutator below, so
+ * hasObstacle() / hasFood() / getOccupant() are O(1) array reads.
  */
 class GameState {
 private:
@@ -169,9 +301,37 @@ private:
     int current_round_;
     long long next_round_timestamp_;
     
+    vector<int> cell_counts_;             // Snake blocks on each cell (row-major)
+    vector<const Snake*> cell_owner_;     // One snake on each cell, nullptr if empty
+    vector<unsigned char> food_cells_;    // 1 if the cell has food
+    
 public:
     GameState()
-        : map_width_(50), map_height_(50), current_round_(0), next_round_timestamp_(0) {}
+        : map_width_(50), map_height_(50), current_round_(0), next_round_timestamp_(0) {
+        rebuildGrids();
+    }
+    
+    // Grid owners point into players_, so copies rebuild them for their own map
+    GameState(const GameState& other)
+        : players_(other.players_), foods_(other.foods_), my_id_(other.my_id_),
+          map_width_(other.map_width_), map_height_(other.map_height_),
+          current_round_(other.current_round_), next_round_timestamp_(other.next_round_timestamp_) {
+        rebuildGrids();
+    }
+    
+    GameState& operator=(const GameState& other) {
+        if (this != &other) {
+            players_ = other.players_;
+            foods_ = other.foods_;
+            my_id_ = other.my_id_;
+            map_width_ = other.map_width_;
+            map_height_ = other.map_height_;
+            current_round_ = other.current_round_;
+            next_round_timestamp_ = other.next_round_timestamp_;
+            rebuildGrids();
+        }
+        return *this;
+    }
     
     /**
     * @brief Set my player ID.
@@ -184,6 +344,7 @@ public:
     void setMapSize(int width, int height) {
         map_width_ = width;
         map_height_ = height;
+        rebuildGrids();
     }
     
     /**
@@ -207,6 +368,34 @@ public:
         return it->second;
     }
     
+    /**
+    * @brief Get my snake without copying.
+    *
+    * The reference stays valid until the state is next updated.
+     */
+    const Snake& getMySnakeRef() const {
+        auto it = players_.find(my_id_);
+        if (it == players_.end()) {
+            throw SnakeException("Player not found");
+        }
+        return it->second;
+    }
+    
+    /**
+    * @brief Get my player ID.
+     */
+    const string& getMyId() const { return my_id_; }
+    
+    /**
+    * @brief Get all players keyed by ID, without copying (includes self).
+     */
+    const map<string, Snake>& getPlayerMap() const { return players_; }
+    
+    /**
+    * @brief Get all foods without copying.
+     */
+    const set<Point>& getFoodSet() const { return foods_; }
+    
     /**
     * @brief Get all players (including self).
      */
@@ -269,17 +458,31 @@ public:
     * @brief Check whether a position has an obstacle (any snake body block).
      */
     bool hasObstacle(int x, int y) const {
-        Point p(x, y);
-        for (const auto& pair : players_) {
-            if (pair.second.contains(p)) {
-                return true;
-            }
-        }
-        return false;
+        return isValidPos(x, y) && cell_counts_[y * map_width_ + x] > 0;
+    }
+    
+    /**
+    * @brief Check whether a position has food.
+     */
+    bool hasFood(int x, int y) const {
+        return isValidPos(x, y) && food_cells_[y * map_width_ + x] != 0;
+    }
+    
+    /**
+    * @brief Get a snake occupying a position (nullptr if empty).
+    *
+    * When several snakes overlap (invincible snakes pass through others),
+    * any one of them is returned.
+     */
+    const Snake* getOccupant(int x, int y) const {
+        return isValidPos(x, y) ? cell_owner_[y * map_width_ + x] : nullptr;
     }
     
     /**
     * @brief Find player by ID.
+    *
+    * Changing the blocks through this pointer bypasses the occupancy grid;
+    * use addOrUpdatePlayer() or advancePlayer() instead.
      */
     Snake* findPlayerById(const string& id) {
         auto it = players_.find(id);
@@ -289,39 +492,572 @@ public:
         return nullptr;
     }
     
+    /**
+    * @brief Find player by ID (read-only).
+     */
+    const Snake* findPlayerById(const string& id) const {
+        auto it = players_.find(id);
+        if (it != players_.end()) {
+            return &(it->second);
+        }
+        return nullptr;
+    }
+    
     /**
     * @brief Clear all players.
      */
-    void clearPlayers() { players_.clear(); }
+    void clearPlayers() {
+        for (const auto& pair : players_) {
+            for (const auto& block : pair.second.blocks) {
+                const int idx = cellIndex(block);
+                if (idx >= 0) {
+                    cell_counts_[idx] = 0;
+                    cell_owner_[idx] = nullptr;
+                }
+            }
+        }
+        players_.clear();
+    }
     
     /**
     * @brief Add or update a player.
      */
     void addOrUpdatePlayer(const Snake& snake) {
-        players_[snake.id] = snake;
+        auto it = players_.find(snake.id);
+        if (it == players_.end()) {
+            it = players_.insert(std::make_pair(snake.id, snake)).first;
+        } else {
+            releaseBlocks(it->second);
+            it->second = snake;
+        }
+        for (const auto& block : it->second.blocks) {
+            occupyCell(block, it->second);
+        }
+    }
+    
+    /**
+    * @brief Apply one round of movement to a player.
+    *
+    * Moves the head (dropping tail blocks beyond new_length), or extends the
+    * tail when the snake grew in place.
+    * @return false if the player is unknown.
+     */
+    bool advancePlayer(const string& id, const Point& new_head, int new_length, int invincible_rounds) {
+        auto it = players_.find(id);
+        if (it == players_.end()) {
+            return false;
+        }
+        Snake& snake = it->second;
+        
+        if (snake.head != new_head) {
+            // Head moved
+            snake.blocks.push_front(new_head);
+            occupyCell(new_head, snake);
+            while (static_cast<int>(snake.blocks.size()) > new_length) {
+                const Point tail = snake.blocks.back();
+                snake.blocks.pop_back();
+                releaseCell(tail, snake, false);
+            }
+        } else if (static_cast<int>(snake.blocks.size()) != new_length) {
+            // Length changed (food eaten)
+            if (snake.blocks.empty()) {
+                snake.blocks.push_back(snake.head);
+                occupyCell(snake.head, snake);
+            }
+            while (static_cast<int>(snake.blocks.size()) < new_length) {
+                const Point tail = snake.blocks.back();
+                snake.blocks.push_back(tail);
+                occupyCell(tail, snake);
+            }
+        }
+        
+        snake.head = new_head;
+        snake.length = new_length;
+        snake.invincible_rounds = invincible_rounds;
+        return true;
     }
     
     /**
     * @brief Remove a player.
      */
     void removePlayer(const string& id) {
-        players_.erase(id);
+        auto it = players_.find(id);
+        if (it == players_.end()) {
+            return;
+        }
+        releaseBlocks(it->second);
+        players_.erase(it);
     }
     
     /**
     * @brief Clear all foods.
      */
-    void clearFoods() { foods_.clear(); }
+    void clearFoods() {
+        for (const auto& food : foods_) {
+            const int idx = cellIndex(food);
+            if (idx >= 0) {
+                food_cells_[idx] = 0;
+            }
+        }
+        foods_.clear();
+    }
     
     /**
     * @brief Add food.
      */
-    void addFood(const Point& p) { foods_.insert(p); }
+    void addFood(const Point& p) {
+        foods_.insert(p);
+        const int idx = cellIndex(p);
+        if (idx >= 0) {
+            food_cells_[idx] = 1;
+        }
+    }
     
     /**
     * @brief Remove food.
      */
-    void removeFood(const Point& p) { foods_.erase(p); }
+    void removeFood(const Point& p) {
+        foods_.erase(p);
+        const int idx = cellIndex(p);
+        if (idx >= 0) {
+            food_cells_[idx] = 0;
+        }
+    }
+    
+private:
+    int cellIndex(const Point& p) const {
+        return isValidPos(p.x, p.y) ? p.y * map_width_ + p.x : -1;
+    }
+    
+    void occupyCell(const Point& p, const Snake& snake) {
+        const int idx = cellIndex(p);
+        if (idx < 0) {
+            return;
+        }
+        if (cell_counts_[idx]++ == 0) {
+            cell_owner_[idx] = &snake;
+        }
+    }
+    
+    /**
+    * @brief Release one block of a snake.
+    * @param leaving True if the snake is being removed as a whole.
+     */
+    void releaseCell(const Point& p, const Snake& snake, bool leaving) {
+        const int idx = cellIndex(p);
+        if (idx < 0 || cell_counts_[idx] == 0) {
+            return;
+        }
+        if (--cell_counts_[idx] == 0) {
+            cell_owner_[idx] = nullptr;
+        } else if (cell_owner_[idx] == &snake && (leaving || !snake.contains(p))) {
+            // Overlapping snakes are rare: find who else is still on this cell
+            cell_owner_[idx] = findOccupant(p, &snake);
+        }
+    }
+    
+    void releaseBlocks(const Snake& snake) {
+        for (const auto& block : snake.blocks) {
+            releaseCell(block, snake, true);
+        }
+    }
+    
+    const Snake* findOccupant(const Point& p, const Snake* exclude) const {
+        for (const auto& pair : players_) {
+            if (&pair.second != exclude && pair.second.contains(p)) {
+                return &pair.second;
+            }
+        }
+        return nullptr;
+    }
+    
+    void rebuildGrids() {
+        const size_t cells = static_cast<size_t>(std::max(0, map_width_)) * std::max(0, map_height_);
+        cell_counts_.assign(cells, 0);
+        cell_owner_.assign(cells, nullptr);
+        food_cells_.assign(cells, 0);
+        for (const auto& pair : players_) {
+            for (const auto& block : pair.second.blocks) {
+                occupyCell(block, pair.second);
+            }
+        }
+        for (const auto& food : foods_) {
+            const int idx = cellIndex(food);
+            if (idx >= 0) {
+                food_cells_[idx] = 1;
+            }
+        }
+    }
+};
+
+// ============================================================================
+// Forward simulation
+// ============================================================================
+
+/**
+ * @brief Load a GameState into a rules engine state for rollouts.
+ *
+ * Players take slots 0..n-1 in getPlayerMap() order and their IDs are written
+ * to slot_ids. The heading is inferred from the first two blocks (MOVE_NONE
+ * for one-block snakes) and pending growth, which clients cannot see, is
+ * taken as zero. Every snake can grow by at least growth_headroom cells
+ * before hitting max_length. The engine is reshaped only when the map size
+ * changes, there are more players than slots or that headroom runs out; a
+ * reshape reserves twice the headroom. Loading into the same RulesState
+ * every round therefore rarely allocates.
+ *
+ * @return The slot of my snake, or -1 if I am not on the board.
+ */
+inline int loadRules(const GameState& state, snake_rules::RulesState& rules,
+                     vector<string>& slot_ids, int growth_headroom = 64) {
+    const map<string, Snake>& players = state.getPlayerMap();
+    int longest = 1;
+    for (const auto& entry : players) {
+        longest = std::max(longest, static_cast<int>(entry.second.blocks.size()));
+    }
+    const int slots = static_cast<int>(players.size());
+    if (!rules.hasShape(state.getMapWidth(), state.getMapHeight(), slots, longest + growth_headroom)) {
+        rules.reset(state.getMapWidth(), state.getMapHeight(), slots, longest + 2 * growth_headroom);
+    } else {
+        rules.clear();
+    }
+    rules.setRound(state.getCurrentRound());
+
+    slot_ids.clear();
+    int my_slot = -1;
+    static thread_local vector<snake_rules::Cell> body;
+    for (const auto& entry : players) {
+        const Snake& snake = entry.second;
+        const int slot = static_cast<int>(slot_ids.size());
+        slot_ids.push_back(snake.id);
+        if (snake.id == state.getMyId()) {
+            my_slot = slot;
+        }
+        if (snake.blocks.empty()) {
+            continue;
+        }
+
+        body.clear();
+        for (const auto& block : snake.blocks) {
+            body.push_back(snake_rules::Cell(block.x, block.y));
+        }
+        snake_rules::Move heading = snake_rules::MOVE_NONE;
+        if (body.size() > 1) {
+            const int dx = body[0].x - body[1].x;
+            const int dy = body[0].y - body[1].y;
+            if (dx > 0) heading = snake_rules::MOVE_RIGHT;
+            else if (dx < 0) heading = snake_rules::MOVE_LEFT;
+            else if (dy > 0) heading = snake_rules::MOVE_DOWN;
+            else if (dy < 0) heading = snake_rules::MOVE_UP;
+        }
+        rules.placeSnake(slot, body.data(), static_cast<int>(body.size()), heading,
+                         snake.invincible_rounds, 0);
+    }
+    for (const auto& food : state.getFoodSet()) {
+        rules.addFood(food.x, food.y);
+    }
+    return my_slot;
+}
+
+// ============================================================================
+// Delta parsing
+// ============================================================================
+
+/**
+ * @brief One player entry of a delta update.
+ */
+struct DeltaPlayer {
+    string id;
+    string name;
+    string color;
+    Point head;
+    bool has_head;
+    int length;
+    int invincible_rounds;
+    vector<Point> blocks;       // Only sent for joined players
+    
+    DeltaPlayer() { reset(); }
+    
+    void reset() {
+        id.clear();
+        name.clear();
+        color.clear();
+        head = Point();
+        has_head = false;
+        length = 0;
+        invincible_rounds = 0;
+        blocks.clear();
+    }
+};
+
+/**
+ * @brief A decoded delta response.
+ *
+ * Entries are reused between rounds (counts mark the live prefix), so once
+ * the buffers have grown to the usual round size, decoding does not allocate.
+ */
+struct DeltaUpdate {
+    int code;
+    string msg;
+    bool has_delta;
+    int round;
+    long long timestamp;
+    long long next_round_timestamp;
+    vector<DeltaPlayer> players;
+    size_t player_count;
+    vector<DeltaPlayer> joined;
+    size_t joined_count;
+    vector<string> died;
+    size_t died_count;
+    vector<Point> added_foods;
+    vector<Point> removed_foods;
+    
+    DeltaUpdate() { reset(); }
+    
+    void reset() {
+        code = -1;
+        msg.clear();
+        has_delta = false;
+        round = 0;
+        timestamp = 0;
+        next_round_timestamp = 0;
+        player_count = 0;
+        joined_count = 0;
+        died_count = 0;
+        added_foods.clear();
+        removed_foods.clear();
+    }
+};
+
+/**
+ * @brief SAX handler decoding {"code", "msg", "data": {"delta_state": ...}}
+ * straight into a DeltaUpdate, without building a json DOM.
+ *
+ * Unknown keys are skipped, so new server fields do not break old clients.
+ */
+class DeltaSaxParser {
+public:
+    /**
+    * @brief Decode a response body.
+    * @return false if the body is not valid JSON.
+     */
+    bool parse(const std::string& body, DeltaUpdate& out) {
+        out.reset();
+        out_ = &out;
+        player_ = nullptr;
+        scopes_.clear();
+        key_ = K_NONE;
+        return json::sax_parse(body, this);
+    }
+    
+    // ---- nlohmann::json SAX interface ----
+    
+    bool null() { return true; }
+    bool boolean(bool) { return true; }
+    bool number_integer(json::number_integer_t value) { return onInteger(static_cast<long long>(value)); }
+    bool number_unsigned(json::number_unsigned_t value) { return onInteger(static_cast<long long>(value)); }
+    bool number_float(json::number_float_t value, const json::string_t&) { return onInteger(static_cast<long long>(value)); }
+    bool binary(json::binary_t&) { return true; }
+    
+    bool string(json::string_t& value) {
+        switch (top()) {
+            case S_ROOT:
+                if (key_ == K_MSG) out_->msg = value;
+                break;
+            case S_PLAYER:
+            case S_JOINED_PLAYER:
+                if (key_ == K_ID) player_->id = value;
+                else if (key_ == K_NAME) player_->name = value;
+                else if (key_ == K_COLOR) player_->color = value;
+                break;
+            case S_DIED:
+                if (out_->died_count == out_->died.size()) {
+                    out_->died.push_back(std::string());
+                }
+                out_->died[out_->died_count++] = value;
+                break;
+            default:
+                break;
+        }
+        return true;
+    }
+    
+    bool key(json::string_t& k) {
+        key_ = K_NONE;
+        switch (top()) {
+            case S_ROOT:
+                if (k == "code") key_ = K_CODE;
+                else if (k == "msg") key_ = K_MSG;
+                else if (k == "data") key_ = K_DATA;
+                break;
+            case S_DATA:
+                if (k == "delta_state") key_ = K_DELTA;
+                break;
+            case S_DELTA:
+                if (k == "round") key_ = K_ROUND;
+                else if (k == "timestamp") key_ = K_TIMESTAMP;
+                else if (k == "next_round_timestamp") key_ = K_NEXT_TS;
+                else if (k == "players") key_ = K_PLAYERS;
+                else if (k == "joined_players") key_ = K_JOINED;
+                else if (k == "died_players") key_ = K_DIED;
+                else if (k == "added_foods") key_ = K_ADDED;
+                else if (k == "removed_foods") key_ = K_REMOVED;
+                break;
+            case S_PLAYER:
+            case S_JOINED_PLAYER:
+                if (k == "id") key_ = K_ID;
+                else if (k == "head") key_ = K_HEAD;
+                else if (k == "length") key_ = K_LENGTH;
+                else if (k == "invincible_rounds") key_ = K_INVINCIBLE;
+                else if (k == "name") key_ = K_NAME;
+                else if (k == "color") key_ = K_COLOR;
+                else if (k == "blocks") key_ = K_BLOCKS;
+                break;
+            case S_POINT:
+                if (k == "x") key_ = K_X;
+                else if (k == "y") key_ = K_Y;
+                break;
+            default:
+                break;
+        }
+        return true;
+    }
+    
+    bool start_object(std::size_t) {
+        Scope next = S_SKIP;
+        const Scope parent = top();
+        if (scopes_.empty()) {
+            next = S_ROOT;
+        } else if (parent == S_ROOT && key_ == K_DATA) {
+            next = S_DATA;
+        } else if (parent == S_DATA && key_ == K_DELTA) {
+            next = S_DELTA;
+            out_->has_delta = true;
+        } else if (parent == S_PLAYERS) {
+            next = S_PLAYER;
+            player_ = acquire(out_->players, out_->player_count);
+        } else if (parent == S_JOINED) {
+            next = S_JOINED_PLAYER;
+            player_ = acquire(out_->joined, out_->joined_count);
+        } else if ((parent == S_PLAYER || parent == S_JOINED_PLAYER) && key_ == K_HEAD) {
+            next = S_POINT;
+            point_target_ = T_HEAD;
+        } else if (parent == S_BLOCKS || parent == S_ADDED || parent == S_REMOVED) {
+            next = S_POINT;
+            point_target_ = parent == S_BLOCKS ? T_BLOCK : (parent == S_ADDED ? T_ADDED : T_REMOVED);
+        }
+        if (next == S_POINT) {
+            point_ = Point();
+        }
+        scopes_.push_back(next);
+        key_ = K_NONE;
+        return true;
+    }
+    
+    bool end_object() {
+        const Scope closed = top();
+        scopes_.pop_back();
+        if (closed == S_POINT) {
+            switch (point_target_) {
+                case T_HEAD:
+                    player_->head = point_;
+                    player_->has_head = true;
+                    break;
+                case T_BLOCK:
+                    player_->blocks.push_back(point_);
+                    break;
+                case T_ADDED:
+                    out_->added_foods.push_back(point_);
+                    break;
+                case T_REMOVED:
+                    out_->removed_foods.push_back(point_);
+                    break;
+            }
+        }
+        return true;
+    }
+    
+    bool start_array(std::size_t) {
+        Scope next = S_SKIP;
+        const Scope parent = top();
+        if (parent == S_DELTA) {
+            if (key_ == K_PLAYERS) next = S_PLAYERS;
+            else if (key_ == K_JOINED) next = S_JOINED;
+            else if (key_ == K_DIED) next = S_DIED;
+            else if (key_ == K_ADDED) next = S_ADDED;
+            else if (key_ == K_REMOVED) next = S_REMOVED;
+        } else if ((parent == S_PLAYER || parent == S_JOINED_PLAYER) && key_ == K_BLOCKS) {
+            next = S_BLOCKS;
+        }
+        scopes_.push_back(next);
+        key_ = K_NONE;
+        return true;
+    }
+    
+    bool end_array() {
+        scopes_.pop_back();
+        return true;
+    }
+    
+    bool parse_error(std::size_t, const std::string&, const nlohmann::detail::exception&) {
+        return false;
+    }
+    
+private:
+    enum Scope {
+        S_SKIP, S_ROOT, S_DATA, S_DELTA,
+        S_PLAYERS, S_JOINED, S_PLAYER, S_JOINED_PLAYER,
+        S_BLOCKS, S_DIED, S_ADDED, S_REMOVED, S_POINT
+    };
+    enum Key {
+        K_NONE, K_CODE, K_MSG, K_DATA, K_DELTA,
+        K_ROUND, K_TIMESTAMP, K_NEXT_TS, K_PLAYERS, K_JOINED, K_DIED, K_ADDED, K_REMOVED,
+        K_ID, K_NAME, K_COLOR, K_HEAD, K_LENGTH, K_INVINCIBLE, K_BLOCKS, K_X, K_Y
+    };
+    enum PointTarget { T_HEAD, T_BLOCK, T_ADDED, T_REMOVED };
+    
+    DeltaUpdate* out_ = nullptr;
+    DeltaPlayer* player_ = nullptr;
+    vector<Scope> scopes_;
+    Key key_ = K_NONE;
+    Point point_;
+    PointTarget point_target_ = T_HEAD;
+    
+    Scope top() const { return scopes_.empty() ? S_SKIP : scopes_.back(); }
+    
+    static DeltaPlayer* acquire(vector<DeltaPlayer>& entries, size_t& count) {
+        if (count == entries.size()) {
+            entries.push_back(DeltaPlayer());
+        }
+        DeltaPlayer* entry = &entries[count++];
+        entry->reset();
+        return entry;
+    }
+    
+    bool onInteger(long long value) {
+        switch (top()) {
+            case S_ROOT:
+                if (key_ == K_CODE) out_->code = static_cast<int>(value);
+                break;
+            case S_DELTA:
+                if (key_ == K_ROUND) out_->round = static_cast<int>(value);
+                else if (key_ == K_TIMESTAMP) out_->timestamp = value;
+                else if (key_ == K_NEXT_TS) out_->next_round_timestamp = value;
+                break;
+            case S_PLAYER:
+            case S_JOINED_PLAYER:
+                if (key_ == K_LENGTH) player_->length = static_cast<int>(value);
+                else if (key_ == K_INVINCIBLE) player_->invincible_rounds = static_cast<int>(value);
+                break;
+            case S_POINT:
+                if (key_ == K_X) point_.x = static_cast<int>(value);
+                else if (key_ == K_Y) point_.y = static_cast<int>(value);
+                break;
+            default:
+                break;
+        }
+        return true;
+    }
 };
 
 // ============================================================================
@@ -339,6 +1075,8 @@ struct SnakeConfig {
     bool auto_respawn;                  // Auto respawn after death
     float respawn_delay_sec;            // Respawn delay (seconds)
     bool verbose;                       // Enable verbose log
+    bool use_step_endpoint;             // Submit move and wait for next round in one request
+    int decision_margin_ms;             // runAnytime(): send the move this long before the round ends
     
     SnakeConfig() 
         : server_url("http://localhost:18080"),
@@ -347,7 +1085,9 @@ struct SnakeConfig {
           timeout_ms(5000),
           auto_respawn(true),
           respawn_delay_sec(2.0f),
-          verbose(false) {}
+          verbose(false),
+          use_step_endpoint(true),
+          decision_margin_ms(50) {}
     
     explicit SnakeConfig(const string& url) : SnakeConfig() {
         server_url = url;
@@ -355,13 +1095,541 @@ struct SnakeConfig {
 };
 
 // ============================================================================
-// Main class: CodingSnake
+// Shared world state: WorldFeed
 // ============================================================================
 
 /**
- * @brief Main class for snake gameplay.
+ * @brief World state shared by every bot session in one process.
+ *
+ * One background thread long-polls the map endpoints and keeps the decoded
+ * updates since the last full map. Each attached CodingSnake replays them into
+ * its own GameState (no HTTP request, no JSON parsing), decides on its own
+ * thread and still sends its own move. Map requests and decoding happen once
+ * per round per process, however many bots are attached.
+ *
+ * Usage example:
+ * ```cpp
+ * WorldFeed world("http://localhost:18080");
+ * CodingSnake a("http://localhost:18080");
+ * a.login("uid1", "paste1");
+ * a.join("BotA");
+ * a.attachWorld(world);
+ * std::thread t([&a]() { a.run(decideA); });
+ * // ... more bots attached to the same world ...
+ * ```
+ */
+class WorldFeed {
+    friend class CodingSnake;
+    
+private:
+    SnakeConfig config_;
+    std::unique_ptr<httplib::Client> client_;
+    DeltaSaxParser parser_;
+    int round_time_ms_;
+    
+    mutable std::mutex mutex_;
+    std::condition_variable cv_;
+    std::shared_ptr<const json> full_;                  // map_state of the last full map
+    int full_round_;                                    // Round of full_, -1 before the first fetch
+    vector<std::shared_ptr<const DeltaUpdate> > deltas_; // Rounds full_round_ + 1, + 2, ... in order
+    int latest_round_;
+    bool started_;
+    bool stopping_;
+    std::thread thread_;
+    
+public:
+    /**
+    * @brief Constructor.
+    * @param url Server URL.
+     */
+    explicit WorldFeed(const string& url)
+        : config_(url), round_time_ms_(1000), full_round_(-1), latest_round_(-1),
+          started_(false), stopping_(false) {
+        initHttpClient();
+    }
+    
+    /**
+    * @brief Constructor.
+    * @param config Config object (server URL, timeouts, full map refresh interval).
+     */
+    explicit WorldFeed(const SnakeConfig& config)
+        : config_(config), round_time_ms_(1000), full_round_(-1), latest_round_(-1),
+          started_(false), stopping_(false) {
+        initHttpClient();
+    }
+    
+    ~WorldFeed() {
+        stop();
+    }
+    
+    /**
+    * @brief Start the fetch thread (called by the first attached bot).
+     */
+    void start() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (started_ || stopping_) {
+            return;
+        }
+        started_ = true;
+        thread_ = std::thread(&WorldFeed::fetchLoop, this);
+    }
+    
+    /**
+    * @brief Stop the fetch thread; attached bots return from run().
+     */
+    void stop() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (stopping_) {
+                return;
+            }
+            stopping_ = true;
+        }
+        cv_.notify_all();
+        client_->stop();  // Abort a pending long-poll
+        if (thread_.joinable()) {
+            thread_.join();
+        }
+    }
+    
+    /**
+    * @brief Whether stop() has been called.
+     */
+    bool stopped() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return stopping_;
+    }
+    
+    /**
+    * @brief Newest round seen by the feed (-1 before the first fetch).
+     */
+    int latestRound() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return latest_round_;
+    }
+    
+private:
+    /**
+    * @brief Collect the updates a state at `round` needs to catch up.
+    * @param round Round of the caller's state.
+    * @param timeout_ms How long to wait for a newer round.
+    * @param full Set to the full map to apply first, or null if the deltas suffice.
+    * @param deltas Receives the deltas to apply after `full`, in order.
+    * @return false if no newer round arrived in time or the feed stopped.
+     */
+    bool collectAfter(int round, int timeout_ms,
+                      std::shared_ptr<const json>& full,
+                      vector<std::shared_ptr<const DeltaUpdate> >& deltas) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        cv_.wait_for(lock, std::chrono::milliseconds(std::max(0, timeout_ms)), [this, round]() {
+            return stopping_ || latest_round_ > round;
+        });
+        if (stopping_ || latest_round_ <= round) {
+            return false;
+        }
+        
+        size_t first = 0;
+        if (round < full_round_) {
+            full = full_;
+        } else {
+            full.reset();
+            first = static_cast<size_t>(round - full_round_);
+        }
+        deltas.assign(deltas_.begin() + first, deltas_.end());
+        return true;
+    }
+    
+    void initHttpClient() {
+        client_ = std::unique_ptr<httplib::Client>(new httplib::Client(config_.server_url));
+        client_->set_connection_timeout(0, config_.timeout_ms * 1000);
+        client_->set_read_timeout(config_.timeout_ms / 1000, 0);
+        client_->set_write_timeout(config_.timeout_ms / 1000, 0);
+        client_->set_keep_alive(true);
+        client_->set_tcp_nodelay(true);  // Small requests on a kept-alive connection must not wait for delayed ACKs
+    }
+    
+    int longPollTimeoutMs() const {
+        return std::max(100, std::min(round_time_ms_ * 2, config_.timeout_ms / 2));
+    }
+    
+    void fetchLoop() {
+        try {
+            fetchRoundTime();
+        } catch (const std::exception&) {
+            // Keep the default round time
+        }
+        
+        bool need_full = true;
+        while (!stopped()) {
+            bool ok = false;
+            // An exception escaping this thread would terminate every bot in the process;
+            // treat it as a failed fetch and start over from a full map
+            try {
+                if (need_full || roundsSinceFull() >= config_.full_map_refresh_rounds) {
+                    ok = fetchFull();
+                    need_full = !ok;
+                } else {
+                    ok = fetchDelta(need_full);
+                }
+            } catch (const std::exception&) {
+                ok = false;
+            }
+            
+            if (!ok) {
+                need_full = true;
+                std::unique_lock<std::mutex> lock(mutex_);
+                cv_.wait_for(lock, std::chrono::milliseconds(100), [this]() { return stopping_; });
+            }
+        }
+    }
+    
+    int roundsSinceFull() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return latest_round_ - full_round_;
+    }
+    
+    void fetchRoundTime() {
+        auto res = client_->Get("/api/status");
+        if (!res || res->status != 200) {
+            return;
+        }
+        json data = json::parse(res->body, nullptr, false);
+        if (!data.is_discarded() && data.is_object() && data.value("code", -1) == 0 &&
+            data.contains("data") && data["data"].is_object()) {
+            const json round_time = data["data"].value("round_time", json());
+            if (round_time.is_number_integer()) {
+                round_time_ms_ = round_time.get<int>();
+            }
+        }
+    }
+    
+    /**
+    * @brief Fetch the full map and restart the delta log from it.
+     */
+    bool fetchFull() {
+        auto res = client_->Get("/api/game/map");
+        if (!res || res->status != 200) {
+            return false;
+        }
+        
+        json data = json::parse(res->body, nullptr, false);
+        if (data.is_discarded() || !data.is_object() || data.value("code", -1) != 0 ||
+            !data.contains("data") || !data["data"].is_object()) {
+            return false;
+        }
+        json& body = data["data"];
+        if (!body.contains("map_state") || !body["map_state"].is_object() ||
+            !body["map_state"].contains("round") || !body["map_state"]["round"].is_number_integer()) {
+            return false;
+        }
+        
+        std::shared_ptr<const json> map_state(new json(std::move(body["map_state"])));
+        const int round = (*map_state)["round"].get<int>();
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            full_ = map_state;
+            full_round_ = round;
+            deltas_.clear();
+            latest_round_ = round;
+        }
+        cv_.notify_all();
+        return true;
+    }
+    
+    /**
+    * @brief Long-poll the next delta and append it to the log.
+    * @param need_full Set when a round was skipped and a full map is needed.
+    * @return false on a network or decoding error.
+     */
+    bool fetchDelta(bool& need_full) {
+        const int after_round = latestRound();
+        const string path = "/api/game/map/delta?after_round=" + std::to_string(after_round) +
+                            "&timeout_ms=" + std::to_string(longPollTimeoutMs());
+        
+        auto res = client_->Get(path.c_str());
+        if (!res || res->status != 200) {
+            return false;
+        }
+        
+        // Bots hold on to published deltas, so each round gets a fresh buffer
+        std::shared_ptr<DeltaUpdate> delta(new DeltaUpdate());
+        if (!parser_.parse(res->body, *delta) || delta->code != 0 || !delta->has_delta) {
+            return false;
+        }
+        
+        if (delta->round <= after_round) {
+            return true;  // Long-poll timed out without a new round
+        }
+        if (delta->round > after_round + 1) {
+            need_full = true;  // A round was skipped, the log would have a gap
+            return true;
+        }
+        
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            deltas_.push_back(delta);
+            latest_round_ = delta->round;
+        }
+        cv_.notify_all();
+        return true;
+    }
+};
+
+// ============================================================================
+// Anytime decisions: DecisionContext / AnytimeDecider
+// ============================================================================
+
+/**
+ * @brief Time budget and answer slot for one anytime decision.
+ *
+ * The decision function submits a cheap answer first and better ones as its
+ * search deepens; the SDK sends whichever answer is newest when the budget
+ * runs out. Once timeUp() returns true the move is already on its way and
+ * further work is wasted.
+ */
+class DecisionContext {
+    friend class AnytimeDecider;
+    
+private:
+    typedef std::chrono::steady_clock Clock;
+    
+    Clock::time_point deadline_;
+    long long budget_ms_;
+    int round_;
+    std::atomic<bool> expired_;
+    
+    mutable std::mutex mutex_;
+    string best_;
+    bool has_best_;
+    
+public:
+    DecisionContext() : budget_ms_(0), round_(0), expired_(false), has_best_(false) {}
+    
+    /**
+    * @brief Record the best direction found so far (thread-safe).
+     */
+    void submit(const string& direction) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        best_ = direction;
+        has_best_ = true;
+    }
+    
+    /**
+    * @brief Milliseconds left before the SDK sends the move (never negative).
+     */
+    long long remainingMs() const {
+        const long long left = std::chrono::duration_cast<std::chrono::milliseconds>(
+            deadline_ - Clock::now()).count();
+        return std::max(0LL, left);
+    }
+    
+    /**
+    * @brief Whether the budget is used up and the answer has been taken.
+     */
+    bool timeUp() const {
+        return expired_.load() || Clock::now() >= deadline_;
+    }
+    
+    /**
+    * @brief Whole budget of this decision (ms).
+     */
+    long long budgetMs() const { return budget_ms_; }
+    
+    /**
+    * @brief Round being decided.
+     */
+    int round() const { return round_; }
+    
+private:
+    void begin(Clock::time_point deadline, long long budget_ms, int round) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        deadline_ = deadline;
+        budget_ms_ = budget_ms;
+        round_ = round;
+        best_.clear();
+        has_best_ = false;
+        expired_.store(false);
+    }
+    
+    bool best(string& out) const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (has_best_) {
+            out = best_;
+        }
+        return has_best_;
+    }
+};
+
+/**
+ * @brief Runs an anytime decision function on a worker thread.
+ *
+ * Each round the worker searches on its own copy of the state, so the game
+ * loop can send the move and apply the next update while a search that
+ * overran its budget is still unwinding.
+ */
+class AnytimeDecider {
+public:
+    typedef std::function<void(const GameState&, DecisionContext&)> Func;
+    typedef std::chrono::steady_clock Clock;
+    
+private:
+    Func func_;
+    GameState state_;           // Worker's copy of the state
+    DecisionContext context_;
+    string last_answer_;
+    string error_;              // Message of the last exception thrown by func_
+    
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    bool has_job_;
+    bool busy_;
+    bool stopping_;
+    std::thread thread_;
+    
+public:
+    explicit AnytimeDecider(const Func& func)
+        : func_(func), last_answer_("right"), has_job_(false), busy_(false), stopping_(false) {
+        thread_ = std::thread(&AnytimeDecider::workerLoop, this);
+    }
+    
+    ~AnytimeDecider() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+        }
+        context_.expired_.store(true);
+        cv_.notify_all();
+        if (thread_.joinable()) {
+            thread_.join();
+        }
+    }
+    
+    /**
+    * @brief Decide one round.
+    *
+    * Returns as soon as the function finishes, or at the deadline with its
+    * newest answer. If nothing was submitted by then, a fallback move is
+    * returned instead: the current heading when it is free, otherwise any
+    * free neighbour of the head.
+    * @param stale Set when the previous round's search had not finished yet
+    *              and its answer is reused.
+    * @param fallback Set when the function had no answer and the fallback was used.
+    * @param error Set to the message if the function threw.
+     */
+    string decide(const GameState& state, Clock::time_point deadline, long long budget_ms,
+                  bool& stale, bool& fallback, string& error) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        stale = false;
+        fallback = false;
+        error.clear();
+        
+        if (busy_ && !cv_.wait_until(lock, deadline, [this]() { return !busy_; })) {
+            stale = true;
+            return last_answer_;
+        }
+        
+        state_ = state;
+        context_.begin(deadline, budget_ms, state.getCurrentRound());
+        error_.clear();
+        has_job_ = true;
+        busy_ = true;
+        cv_.notify_all();
+        
+        string answer;
+        cv_.wait_until(lock, deadline, [this]() { return !busy_; });
+        context_.expired_.store(true);
+        
+        if (context_.best(answer)) {
+            last_answer_ = answer;
+        } else {
+            // No answer by the deadline, or the function returned without one
+            answer = fallbackMove(state);
+            fallback = true;
+        }
+        error = error_;
+        return answer;
+    }
+    
+private:
+    /**
+    * @brief Move sent when the function has no answer: keep the heading if its
+    *        cell is free, else take the first free neighbour of the head.
+     */
+    static string fallbackMove(const GameState& state) {
+        static const char* const kDirections[] = {"up", "down", "left", "right"};
+        static const int kDx[] = {0, 0, -1, 1};
+        static const int kDy[] = {-1, 1, 0, 0};
+        
+        const map<string, Snake>& players = state.getPlayerMap();
+        auto it = players.find(state.getMyId());
+        if (it == players.end() || it->second.blocks.empty()) {
+            return "right";
+        }
+        const SnakeBody& body = it->second.blocks;
+        const Point& head = body[0];
+        
+        int heading = -1;
+        if (body.size() >= 2) {
+            for (int d = 0; d < 4; ++d) {
+                if (head.x - body[1].x == kDx[d] && head.y - body[1].y == kDy[d]) {
+                    heading = d;
+                }
+            }
+        }
+        auto isFree = [&](int d) {
+            const int x = head.x + kDx[d];
+            const int y = head.y + kDy[d];
+            return state.isValidPos(x, y) && !state.hasObstacle(x, y);
+        };
+        
+        if (heading >= 0 && isFree(heading)) {
+            return kDirections[heading];
+        }
+        for (int d = 0; d < 4; ++d) {
+            if (isFree(d)) {
+                return kDirections[d];
+            }
+        }
+        return heading >= 0 ? kDirections[heading] : "right";
+    }
+    
+    void workerLoop() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (true) {
+            cv_.wait(lock, [this]() { return stopping_ || has_job_; });
+            if (stopping_) {
+                return;
+            }
+            has_job_ = false;
+            
+            lock.unlock();
+            string error;
+            try {
+                func_(state_, context_);
+            } catch (const std::exception& e) {
+                error = e.what();
+            }
+            lock.lock();
+            
+            error_ = error;
+            busy_ = false;
+            cv_.notify_all();
+        }
+    }
+};
+
+// ============================================================================
+// Main class: CodingSnake
+// ============================================================================
+
+class SnakeFleet;
+
+/**
+ * @brief Main class for snake gameplay.
  */
 class CodingSnake {
+    friend class SnakeFleet;
+    
 private:
     SnakeConfig config_;
     GameState state_;
@@ -380,10 +1648,22 @@ private:
     
     bool initialized_;          // Whether initialized
     bool in_game_;              // Whether currently in game
+    bool step_supported_;       // Cleared when the server has no /api/game/step
     
     // HTTP client
     std::unique_ptr<httplib::Client> client_;
     
+    // Delta decoding buffers, reused every round
+    DeltaSaxParser delta_parser_;
+    DeltaUpdate delta_update_;
+    
+    // Shared world state (optional): replaces this session's own map requests
+    WorldFeed* world_;
+    vector<std::shared_ptr<const DeltaUpdate> > world_deltas_;
+    
+    // Worker for runAnytime()
+    std::unique_ptr<AnytimeDecider> anytime_;
+    
 public:
     /**
     * @brief Constructor.
@@ -392,7 +1672,7 @@ public:
     explicit CodingSnake(const string& url) 
         : config_(url), round_time_ms_(1000), last_full_refresh_(0),
                     server_clock_offset_ms_(0), has_clock_sync_(false), best_clock_sync_rtt_ms_(1 << 30),
-                    initialized_(false), in_game_(false) {
+                    initialized_(false), in_game_(false), step_supported_(true), world_(nullptr) {
         initHttpClient();
     }
     
@@ -403,7 +1683,7 @@ public:
     explicit CodingSnake(const SnakeConfig& config)
         : config_(config), round_time_ms_(1000), last_full_refresh_(0),
                     server_clock_offset_ms_(0), has_clock_sync_(false), best_clock_sync_rtt_ms_(1 << 30),
-                    initialized_(false), in_game_(false) {
+                    initialized_(false), in_game_(false), step_supported_(true), world_(nullptr) {
         initHttpClient();
     }
     
@@ -414,6 +1694,13 @@ public:
         config_.verbose = verbose;
     }
     
+    /**
+    * @brief Round duration reported by the server (ms); 1000 until join() has run.
+     */
+    int getRoundTimeMs() const {
+        return round_time_ms_;
+    }
+    
     /**
     * @brief Log in and get key.
     * @param uid Luogu user ID.
@@ -432,113 +1719,390 @@ public:
                                   "application/json");
         
         if (!res) {
-            throw SnakeException("Login request failed: network error");
+            throw SnakeException("Login request failed: network error");
+        }
+        
+        json data = json::parse(res->body);
+        
+        if (data["code"].get<int>() != 0) {
+            throw SnakeException("Login failed: " + data["msg"].get<string>());
+        }
+        
+        key_ = data["data"]["key"].get<string>();
+        log("SUCCESS", "ok Login successful");
+    }
+    
+    /**
+    * @brief Join game.
+    * @param name Player name.
+    * @param color Snake color (optional, random by default).
+     */
+    void join(const string& name, const string& color = "") {
+        player_name_ = name;
+        player_color_ = color.empty() ? generateRandomColor() : color;
+        
+        joinGameInternal();
+        
+        // Fetch server status
+        fetchServerStatus();
+        
+        initialized_ = true;
+    }
+    
+    /**
+    * @brief Take map updates from a shared WorldFeed instead of polling the server.
+    *
+    * The session keeps its own GameState and still sends its own moves; the
+    * feed must outlive run().
+     */
+    void attachWorld(WorldFeed& world) {
+        world_ = &world;
+        world.start();
+    }
+    
+    /**
+    * @brief Run game loop.
+    * @param decide_func Decision function with signature string(const GameState&).
+     */
+    void run(std::function<string(const GameState&)> decide_func) {
+        if (!initialized_) {
+            throw SnakeException("Please call login() and join() first");
+        }
+        
+        log("INFO", "Game started!");
+        
+        if (world_ != nullptr) {
+            runWorldLoop(decide_func);
+            return;
+        }
+        
+        if (config_.use_step_endpoint && step_supported_) {
+            if (runStepLoop(decide_func)) {
+                return;
+            }
+            log("WARNING", "Server has no step endpoint, falling back to polling");
+        }
+        
+        int move_count = 0;
+        int last_decision_round = -1;
+        
+        try {
+            while (true) {
+                // CRITICAL: Wait first, then fetch map immediately
+                // This ensures we fetch the latest state at the start of each round
+                waitForNextRoundWindow();
+                
+                // Immediately update map state after waiting
+                if (!updateMapState()) {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+                    continue;
+                }
+                
+                // Check if still alive
+                if (!in_game_) {
+                    if (config_.auto_respawn) {
+                        log("WARNING", "Dead, preparing to respawn...");
+                        respawn();
+                        last_decision_round = -1;
+                        continue;
+                    } else {
+                        log("INFO", "Game over");
+                        break;
+                    }
+                }
+
+                const int current_round = state_.getCurrentRound();
+                if (current_round == last_decision_round) {
+                    // Already processed this round, continue to next iteration
+                    continue;
+                }
+                
+                // Call user decision function
+                string direction;
+                try {
+                    direction = decide_func(state_);
+                } catch (const std::exception& e) {
+                    log("ERROR", string("Decision function error: ") + e.what());
+                    direction = "right";  // Default direction
+                }
+                
+                // Send move command immediately
+                if (sendMove(direction)) {
+                    move_count++;
+                    last_decision_round = current_round;
+                    
+                    if (config_.verbose && move_count % 10 == 0) {
+                        Snake my = state_.getMySnake();
+                        log("INFO", "Round " + std::to_string(state_.getCurrentRound()) +
+                            " | Length: " + std::to_string(my.length) +
+                            " | Moves: " + std::to_string(move_count));
+                    }
+                } else {
+                    // Mark as processed even if send failed to avoid repeated attempts
+                    last_decision_round = current_round;
+                }
+            }
+        } catch (const std::exception& e) {
+            log("ERROR", string("Game loop error: ") + e.what());
+            throw;
+        }
+    }
+    
+    /**
+    * @brief Run game loop with a deadline-aware (anytime) decision function.
+    *
+    * The function gets a DecisionContext with the time left before the round
+    * ends (from the synced server clock, minus config decision_margin_ms) and
+    * may submit() improving answers, e.g. one per iterative-deepening level.
+    * The newest answer is sent when the budget runs out, even if the search
+    * is still running; the search should return once ctx.timeUp() is true.
+    * The function runs on a worker thread with its own copy of the state.
+    * @param decide_func Function with signature void(const GameState&, DecisionContext&).
+     */
+    void runAnytime(std::function<void(const GameState&, DecisionContext&)> decide_func) {
+        anytime_ = std::unique_ptr<AnytimeDecider>(new AnytimeDecider(decide_func));
+        run([this](const GameState& state) { return decideBeforeDeadline(state); });
+    }
+    
+private:
+    /**
+    * @brief One anytime decision, answered at the round's deadline.
+     */
+    string decideBeforeDeadline(const GameState& state) {
+        long long budget_ms;
+        const long long next_ts = state.getNextRoundTimestamp();
+        if (next_ts > 0) {
+            budget_ms = next_ts - estimatedServerNowMs() - config_.decision_margin_ms;
+        } else {
+            budget_ms = round_time_ms_ - config_.decision_margin_ms;
+        }
+        budget_ms = std::max(0LL, std::min(budget_ms, static_cast<long long>(round_time_ms_)));
+        
+        const AnytimeDecider::Clock::time_point deadline =
+            AnytimeDecider::Clock::now() + std::chrono::milliseconds(budget_ms);
+        
+        bool stale = false;
+        bool fallback = false;
+        string error;
+        const string direction = anytime_->decide(state, deadline, budget_ms, stale, fallback, error);
+        if (stale) {
+            log("WARNING", "Previous search is still running, reusing its last answer");
+        }
+        if (fallback) {
+            log("WARNING", "No answer submitted before the deadline, sending fallback move " + direction);
+        }
+        if (!error.empty()) {
+            log("ERROR", "Decision function error: " + error);
+        }
+        return direction;
+    }
+    
+    /**
+    * @brief Game loop on a shared WorldFeed: replay its updates, decide, send the move.
+     */
+    void runWorldLoop(const std::function<string(const GameState&)>& decide_func) {
+        int move_count = 0;
+        int last_decision_round = -1;
+        
+        while (true) {
+            // Catch up with whatever the feed already has, without waiting
+            syncWorld(0);
+            
+            if (!in_game_) {
+                if (!config_.auto_respawn) {
+                    log("INFO", "Game over");
+                    return;
+                }
+                log("WARNING", "Dead, preparing to respawn...");
+                respawn();
+                last_decision_round = -1;
+                continue;
+            }
+            
+            const int current_round = state_.getCurrentRound();
+            if (current_round == last_decision_round) {
+                // Wait for the next round
+                if (!syncWorld(longPollTimeoutMs()) && world_->stopped()) {
+                    log("INFO", "World feed stopped");
+                    return;
+                }
+                continue;
+            }
+            
+            string direction;
+            try {
+                direction = decide_func(state_);
+            } catch (const std::exception& e) {
+                log("ERROR", string("Decision function error: ") + e.what());
+                direction = "right";  // Default direction
+            }
+            
+            last_decision_round = current_round;
+            if (sendMove(direction)) {
+                move_count++;
+                if (config_.verbose && move_count % 10 == 0) {
+                    log("INFO", "Round " + std::to_string(current_round) +
+                        " | Length: " + std::to_string(state_.getMySnakeRef().length) +
+                        " | Moves: " + std::to_string(move_count));
+                }
+            }
+        }
+    }
+    
+    /**
+    * @brief Apply the feed's updates newer than the local state.
+    * @return false if nothing newer arrived within timeout_ms.
+     */
+    bool syncWorld(int timeout_ms) {
+        std::shared_ptr<const json> full;
+        if (!world_->collectAfter(state_.getCurrentRound(), timeout_ms, full, world_deltas_)) {
+            return false;
+        }
+        
+        if (full) {
+            parseFullMapState(*full);
+            last_full_refresh_ = state_.getCurrentRound();
+        }
+        for (size_t i = 0; i < world_deltas_.size(); ++i) {
+            applyDelta(*world_deltas_[i]);
+        }
+        world_deltas_.clear();  // Release the feed's buffers
+        return true;
+    }
+    
+    /**
+    * @brief Game loop on POST /api/game/step: one request per round.
+    *
+    * Each step submits the move for the current round and returns the
+    * delta of the round that applies it, so no clock-based waiting is needed.
+    * @return false if the server does not support the step endpoint.
+     */
+    bool runStepLoop(const std::function<string(const GameState&)>& decide_func) {
+        int move_count = 0;
+        
+        // The map from join() may already be a few rounds old
+        if (!fetchFullMap()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        }
+        
+        while (true) {
+            if (!in_game_) {
+                if (config_.auto_respawn) {
+                    log("WARNING", "Dead, preparing to respawn...");
+                    respawn();
+                    fetchFullMap();
+                    continue;
+                } else {
+                    log("INFO", "Game over");
+                    return true;
+                }
+            }
+            
+            if (state_.getCurrentRound() - last_full_refresh_ >= config_.full_map_refresh_rounds) {
+                fetchFullMap();
+                continue;
+            }
+            
+            const int decision_round = state_.getCurrentRound();
+            
+            string direction;
+            try {
+                direction = decide_func(state_);
+            } catch (const std::exception& e) {
+                log("ERROR", string("Decision function error: ") + e.what());
+                direction = "right";  // Default direction
+            }
+            
+            const int result = sendStep(direction);
+            if (result == STEP_UNSUPPORTED) {
+                step_supported_ = false;
+                return false;
+            }
+            if (result == STEP_OK) {
+                move_count++;
+                if (config_.verbose && move_count % 10 == 0) {
+                    Snake my = state_.getMySnake();
+                    log("INFO", "Round " + std::to_string(state_.getCurrentRound()) +
+                        " | Length: " + std::to_string(my.length) +
+                        " | Moves: " + std::to_string(move_count));
+                }
+            } else if (result == STEP_FAILED) {
+                if (!fetchFullMap()) {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+                }
+                continue;
+            }
+            
+            // Timed out, or a move was already queued: wait for the round to advance
+            // so the next decision is never made twice on the same state
+            while (in_game_ && state_.getCurrentRound() <= decision_round) {
+                if (!fetchDeltaMap(decision_round)) {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+                }
+            }
+        }
+    }
+    
+    enum StepResult {
+        STEP_OK,            // Move accepted, state updated with the returned delta
+        STEP_REJECTED,      // Move not accepted this round (already submitted, etc.)
+        STEP_FAILED,        // Network or server error
+        STEP_UNSUPPORTED    // Server has no /api/game/step route
+    };
+    
+    /**
+    * @brief Submit a move and wait for the round that applies it.
+     */
+    int sendStep(const string& direction) {
+        json payload = {
+            {"token", token_},
+            {"direction", direction},
+            {"timeout_ms", longPollTimeoutMs()}
+        };
+        
+        const long long request_start_ms = currentSystemTimeMs();
+        auto res = client_->Post("/api/game/step",
+                                  payload.dump(),
+                                  "application/json");
+        const long long response_recv_ms = currentSystemTimeMs();
+        
+        if (!res) {
+            return STEP_FAILED;
         }
         
-        json data = json::parse(res->body);
-        
-        if (data["code"].get<int>() != 0) {
-            throw SnakeException("Login failed: " + data["msg"].get<string>());
+        if (!delta_parser_.parse(res->body, delta_update_) || delta_update_.code < 0) {
+            // A route the server does not know returns a non-JSON 404 page
+            return res->status == 404 ? STEP_UNSUPPORTED : STEP_FAILED;
         }
         
-        key_ = data["data"]["key"].get<string>();
-        log("SUCCESS", "ok Login successful");
-    }
-    
-    /**
-    * @brief Join game.
-    * @param name Player name.
-    * @param color Snake color (optional, random by default).
-     */
-    void join(const string& name, const string& color = "") {
-        player_name_ = name;
-        player_color_ = color.empty() ? generateRandomColor() : color;
-        
-        joinGameInternal();
+        const int code = delta_update_.code;
+        if (code == 401 || code == 404) {
+            // Session is gone: the player died
+            in_game_ = false;
+            return STEP_REJECTED;
+        }
+        if (code != 0) {
+            return code == 429 ? STEP_REJECTED : STEP_FAILED;
+        }
+        if (!delta_update_.has_delta) {
+            return STEP_FAILED;
+        }
         
-        // Fetch server status
-        fetchServerStatus();
+        if (delta_update_.timestamp > 0) {
+            updateClockOffset(delta_update_.timestamp, request_start_ms, response_recv_ms);
+        }
+        applyDelta(delta_update_);
         
-        initialized_ = true;
+        return STEP_OK;
     }
     
     /**
-    * @brief Run game loop.
-    * @param decide_func Decision function with signature string(const GameState&).
+    * @brief Server-side wait bound for long-poll requests (ms).
      */
-    void run(std::function<string(const GameState&)> decide_func) {
-        if (!initialized_) {
-            throw SnakeException("Please call login() and join() first");
-        }
-        
-        log("INFO", "Game started!");
-        
-        int move_count = 0;
-        int last_decision_round = -1;
-        
-        try {
-            while (true) {
-                // CRITICAL: Wait first, then fetch map immediately
-                // This ensures we fetch the latest state at the start of each round
-                waitForNextRoundWindow();
-                
-                // Immediately update map state after waiting
-                if (!updateMapState()) {
-                    std::this_thread::sleep_for(std::chrono::milliseconds(100));
-                    continue;
-                }
-                
-                // Check if still alive
-                if (!in_game_) {
-                    if (config_.auto_respawn) {
-                        log("WARNING", "Dead, preparing to respawn...");
-                        respawn();
-                        last_decision_round = -1;
-                        continue;
-                    } else {
-                        log("INFO", "Game over");
-                        break;
-                    }
-                }
-
-                const int current_round = state_.getCurrentRound();
-                if (current_round == last_decision_round) {
-                    // Already processed this round, continue to next iteration
-                    continue;
-                }
-                
-                // Call user decision function
-                string direction;
-                try {
-                    direction = decide_func(state_);
-                } catch (const std::exception& e) {
-                    log("ERROR", string("Decision function error: ") + e.what());
-                    direction = "right";  // Default direction
-                }
-                
-                // Send move command immediately
-                if (sendMove(direction)) {
-                    move_count++;
-                    last_decision_round = current_round;
-                    
-                    if (config_.verbose && move_count % 10 == 0) {
-                        Snake my = state_.getMySnake();
-                        log("INFO", "Round " + std::to_string(state_.getCurrentRound()) +
-                            " | Length: " + std::to_string(my.length) +
-                            " | Moves: " + std::to_string(move_count));
-                    }
-                } else {
-                    // Mark as processed even if send failed to avoid repeated attempts
-                    last_decision_round = current_round;
-                }
-            }
-        } catch (const std::exception& e) {
-            log("ERROR", string("Game loop error: ") + e.what());
-            throw;
-        }
+    int longPollTimeoutMs() const {
+        return std::max(100, std::min(round_time_ms_ * 2, config_.timeout_ms / 2));
     }
     
-private:
     /**
     * @brief Initialize HTTP client.
      */
@@ -556,6 +2120,8 @@ private:
         client_->set_connection_timeout(0, config_.timeout_ms * 1000);
         client_->set_read_timeout(config_.timeout_ms / 1000, 0);
         client_->set_write_timeout(config_.timeout_ms / 1000, 0);
+        client_->set_keep_alive(true);
+        client_->set_tcp_nodelay(true);
     }
     
     /**
@@ -673,28 +2239,33 @@ private:
     
     /**
     * @brief Fetch delta map.
+    * @param after_round If non-negative, long-poll until the round exceeds it.
      */
-    bool fetchDeltaMap() {
+    bool fetchDeltaMap(int after_round = -1) {
+        string path = "/api/game/map/delta";
+        if (after_round >= 0) {
+            path += "?after_round=" + std::to_string(after_round) +
+                    "&timeout_ms=" + std::to_string(longPollTimeoutMs());
+        }
+        
         const long long request_start_ms = currentSystemTimeMs();
-        auto res = client_->Get("/api/game/map/delta");
+        auto res = client_->Get(path.c_str());
         const long long response_recv_ms = currentSystemTimeMs();
         
         if (!res || res->status != 200) {
             return fetchFullMap();  // Fallback to full map on failure
         }
         
-        json data = json::parse(res->body);
-        
-        if (data["code"].get<int>() != 0) {
+        if (!delta_parser_.parse(res->body, delta_update_) ||
+            delta_update_.code != 0 || !delta_update_.has_delta) {
             return fetchFullMap();
         }
-
-        const auto& delta_state = data["data"]["delta_state"];
-        if (delta_state.contains("timestamp")) {
-            updateClockOffset(delta_state["timestamp"].get<long long>(), request_start_ms, response_recv_ms);
+        
+        if (delta_update_.timestamp > 0) {
+            updateClockOffset(delta_update_.timestamp, request_start_ms, response_recv_ms);
         }
         
-        parseDeltaState(data["data"]["delta_state"]);
+        applyDelta(delta_update_);
         
         return true;
     }
@@ -788,99 +2359,60 @@ private:
     }
     
     /**
-    * @brief Parse delta state.
+    * @brief Apply a decoded delta to the local state.
      */
-    void parseDeltaState(const json& delta) {
-        int new_round = delta["round"].get<int>();
-        if (delta.contains("next_round_timestamp")) {
-            state_.setNextRoundTimestamp(delta["next_round_timestamp"].get<long long>());
+    void applyDelta(const DeltaUpdate& delta) {
+        if (delta.next_round_timestamp > 0) {
+            state_.setNextRoundTimestamp(delta.next_round_timestamp);
         }
         
         // Check for dropped frames
-        if (new_round > state_.getCurrentRound() + 1) {
+        if (delta.round > state_.getCurrentRound() + 1) {
             log("WARNING", "Frame drop detected, refreshing full map");
             fetchFullMap();
             return;
         }
         
-        state_.setCurrentRound(new_round);
+        state_.setCurrentRound(delta.round);
         
         // Remove dead players
-        if (delta.contains("died_players")) {
-            for (const auto& id : delta["died_players"]) {
-                state_.removePlayer(id.get<string>());
-            }
+        for (size_t i = 0; i < delta.died_count; ++i) {
+            state_.removePlayer(delta.died[i]);
         }
         
         // Add newly joined players
-        if (delta.contains("joined_players")) {
-            for (const auto& p : delta["joined_players"]) {
-                Snake snake;
-                snake.id = p["id"].get<string>();
-                snake.name = p["name"].get<string>();
-                snake.color = p.value("color", "#FFFFFF");
-                snake.head = Point(p["head"]["x"].get<int>(), p["head"]["y"].get<int>());
-                snake.length = p["length"].get<int>();
-                snake.invincible_rounds = p.value("invincible_rounds", 0);
-                
-                for (const auto& b : p["blocks"]) {
-                    snake.blocks.push_back(Point(b["x"].get<int>(), b["y"].get<int>()));
-                }
-
-                if (snake.blocks.empty()) {
-                    snake.blocks.push_back(snake.head);
-                }
-                
-                state_.addOrUpdatePlayer(snake);
+        for (size_t i = 0; i < delta.joined_count; ++i) {
+            const DeltaPlayer& p = delta.joined[i];
+            Snake snake;
+            snake.id = p.id;
+            snake.name = p.name;
+            snake.color = p.color.empty() ? "#FFFFFF" : p.color;
+            snake.head = p.head;
+            snake.length = p.length;
+            snake.invincible_rounds = p.invincible_rounds;
+            snake.blocks.assign(p.blocks.begin(), p.blocks.end());
+            if (snake.blocks.empty()) {
+                snake.blocks.push_back(snake.head);
             }
+            state_.addOrUpdatePlayer(snake);
         }
         
         // Update simplified player info
-        if (delta.contains("players")) {
-            for (const auto& p : delta["players"]) {
-                string id = p["id"].get<string>();
-                Snake* snake = state_.findPlayerById(id);
-                
-                if (snake) {
-                    Point new_head(p["head"]["x"].get<int>(), p["head"]["y"].get<int>());
-                    int new_length = p["length"].get<int>();
-                    
-                    // Update blocks
-                    if (snake->head != new_head) {
-                        // Head moved
-                        snake->blocks.insert(snake->blocks.begin(), new_head);
-                        while (static_cast<int>(snake->blocks.size()) > new_length) {
-                            snake->blocks.pop_back();
-                        }
-                    } else if (static_cast<int>(snake->blocks.size()) != new_length) {
-                        // Length changed (food eaten)
-                        if (snake->blocks.empty()) {
-                            snake->blocks.push_back(snake->head);
-                        }
-                        while (static_cast<int>(snake->blocks.size()) < new_length) {
-                            snake->blocks.push_back(snake->blocks.back());
-                        }
-                    }
-                    
-                    snake->head = new_head;
-                    snake->length = new_length;
-                    snake->invincible_rounds = p.value("invincible_rounds", 0);
-                }
+        for (size_t i = 0; i < delta.player_count; ++i) {
+            const DeltaPlayer& p = delta.players[i];
+            if (p.has_head) {
+                state_.advancePlayer(p.id, p.head, p.length, p.invincible_rounds);
             }
         }
         
         // Remove foods
-        if (delta.contains("removed_foods")) {
-            for (const auto& f : delta["removed_foods"]) {
-                state_.removeFood(Point(f["x"].get<int>(), f["y"].get<int>()));
-            }
+        for (size_t i = 0; i < delta.removed_foods.size(); ++i) {
+            state_.removeFood(delta.removed_foods[i]);
         }
         
         // Add foods
-        if (delta.contains("added_foods")) {
-            for (const auto& f : delta["added_foods"]) {
-                state_.addFood(Point(f["x"].get<int>(), f["y"].get<int>()));
-            }
+        for (size_t i = 0; i < delta.added_foods.size(); ++i) {
+            state_.addFood(delta.added_foods[i]);
         }
         
         // Check whether self is still in game
@@ -993,4 +2525,298 @@ private:
     }
 };
 
+// ============================================================================
+// Multi-bot host: SnakeFleet
+// ============================================================================
+
+/**
+ * @brief Runs several bots in one loop with shared state and batched moves.
+ *
+ * All bots see the same map, so the fleet keeps a single GameState (owned by
+ * the first bot's session), calls each bot's decision function in turn and
+ * submits every move with one POST /api/game/moves. Per round the whole fleet
+ * costs one long-poll delta request and one batch request.
+ *
+ * Usage example:
+ * ```cpp
+ * SnakeFleet fleet("http://localhost:18080");
+ * fleet.addBot("uid1", "paste1", "BotA", "#FF0000", decideA);
+ * fleet.addBot("uid2", "paste2", "BotB", "#00FF00", decideB);
+ * fleet.run();
+ * ```
+ */
+class SnakeFleet {
+private:
+    struct Member {
+        std::unique_ptr<CodingSnake> game;                // Session of this bot
+        std::function<string(const GameState&)> decide;   // Decision function
+        bool in_game;                                     // Whether the bot is on the map
+        long long rejoin_at_ms;                           // Local time of the next rejoin attempt
+    };
+    
+    SnakeConfig config_;
+    vector<Member> members_;
+    bool batch_supported_;      // Cleared when the server has no /api/game/moves
+    
+public:
+    /**
+    * @brief Constructor.
+    * @param url Server URL.
+     */
+    explicit SnakeFleet(const string& url)
+        : config_(url), batch_supported_(true) {}
+    
+    /**
+    * @brief Constructor.
+    * @param config Config object shared by all bots.
+     */
+    explicit SnakeFleet(const SnakeConfig& config)
+        : config_(config), batch_supported_(true) {}
+    
+    /**
+    * @brief Set verbose logging.
+     */
+    void setVerbose(bool verbose) {
+        config_.verbose = verbose;
+        for (size_t i = 0; i < members_.size(); ++i) {
+            members_[i].game->setVerbose(verbose);
+        }
+    }
+    
+    /**
+    * @brief Log in and join one bot.
+    * @param uid Luogu user ID.
+    * @param paste Luogu clipboard suffix.
+    * @param name Player name.
+    * @param color Snake color (empty for random).
+    * @param decide_func Decision function of this bot.
+    * @return Number of bots in the fleet.
+     */
+    size_t addBot(const string& uid, const string& paste,
+                  const string& name, const string& color,
+                  std::function<string(const GameState&)> decide_func) {
+        Member member;
+        member.game = std::unique_ptr<CodingSnake>(new CodingSnake(config_));
+        member.game->login(uid, paste);
+        member.game->join(name, color);
+        member.decide = decide_func;
+        member.in_game = true;
+        member.rejoin_at_ms = 0;
+        members_.push_back(std::move(member));
+        return members_.size();
+    }
+    
+    /**
+    * @brief Number of bots in the fleet.
+     */
+    size_t size() const {
+        return members_.size();
+    }
+    
+    /**
+    * @brief Round duration reported by the server (ms); 1000 before the first addBot().
+     */
+    int roundTimeMs() const {
+        return members_.empty() ? 1000 : members_.front().game->getRoundTimeMs();
+    }
+    
+    /**
+    * @brief Run the shared game loop for all bots.
+     */
+    void run() {
+        if (members_.empty()) {
+            throw SnakeException("Please call addBot() first");
+        }
+        
+        CodingSnake& leader = *members_.front().game;
+        leader.log("INFO", "Fleet started with " + std::to_string(members_.size()) + " bots");
+        
+        if (!leader.fetchFullMap()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        }
+        
+        while (true) {
+            if (rejoinDueMembers()) {
+                leader.fetchFullMap();
+            }
+            
+            markDeadMembers();
+            if (!config_.auto_respawn && countInGame() == 0) {
+                leader.log("INFO", "Game over");
+                return;
+            }
+            
+            if (leader.state_.getCurrentRound() - leader.last_full_refresh_ >= config_.full_map_refresh_rounds) {
+                leader.fetchFullMap();
+            }
+            
+            const int decision_round = leader.state_.getCurrentRound();
+            submitDecisions();
+            
+            // Long-poll until the next round is visible
+            while (leader.state_.getCurrentRound() <= decision_round) {
+                if (!leader.fetchDeltaMap(decision_round)) {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+                }
+            }
+        }
+    }
+    
+private:
+    /**
+    * @brief Call every live bot's decision function and submit the moves.
+     */
+    void submitDecisions() {
+        CodingSnake& leader = *members_.front().game;
+        GameState& state = leader.state_;
+        
+        vector<size_t> indices;
+        vector<string> directions;
+        for (size_t i = 0; i < members_.size(); ++i) {
+            Member& m = members_[i];
+            if (!m.in_game) {
+                continue;
+            }
+            
+            state.setMyId(m.game->player_id_);
+            string direction;
+            try {
+                direction = m.decide(state);
+            } catch (const std::exception& e) {
+                leader.log("ERROR", string("Decision function error: ") + e.what());
+                direction = "right";  // Default direction
+            }
+            indices.push_back(i);
+            directions.push_back(direction);
+        }
+        state.setMyId(leader.player_id_);
+        
+        if (indices.empty()) {
+            return;
+        }
+        
+        if (batch_supported_ && sendMoves(indices, directions)) {
+            return;
+        }
+        
+        // Fallback: one request per bot on its own connection
+        for (size_t k = 0; k < indices.size(); ++k) {
+            Member& m = members_[indices[k]];
+            m.game->sendMove(directions[k]);
+            if (!m.game->in_game_) {
+                markDead(m);
+            }
+        }
+    }
+    
+    /**
+    * @brief Submit all moves with POST /api/game/moves.
+    * @return false if the batch was not delivered.
+     */
+    bool sendMoves(const vector<size_t>& indices, const vector<string>& directions) {
+        CodingSnake& leader = *members_.front().game;
+        
+        json moves = json::array();
+        for (size_t k = 0; k < indices.size(); ++k) {
+            moves.push_back({
+                {"token", members_[indices[k]].game->token_},
+                {"direction", directions[k]}
+            });
+        }
+        json payload = {{"moves", moves}};
+        
+        auto res = leader.client_->Post("/api/game/moves",
+                                        payload.dump(),
+                                        "application/json");
+        if (!res) {
+            return false;
+        }
+        
+        json data = json::parse(res->body, nullptr, false);
+        if (data.is_discarded() || !data.is_object() || !data.contains("code")) {
+            if (res->status == 404) {
+                // A route the server does not know returns a non-JSON 404 page
+                leader.log("WARNING", "Server has no batch move endpoint, sending moves one by one");
+                batch_supported_ = false;
+            }
+            return false;
+        }
+        if (data["code"].get<int>() != 0) {
+            return false;
+        }
+        
+        const json& results = data["data"]["results"];
+        for (size_t k = 0; k < indices.size() && k < results.size(); ++k) {
+            const int code = results[k]["code"].get<int>();
+            if (code == 401 || code == 404) {
+                // Session is gone: the player died
+                markDead(members_[indices[k]]);
+            }
+        }
+        return true;
+    }
+    
+    /**
+    * @brief Mark bots whose snake is no longer on the shared map as dead.
+     */
+    void markDeadMembers() {
+        GameState& state = members_.front().game->state_;
+        for (size_t i = 0; i < members_.size(); ++i) {
+            Member& m = members_[i];
+            if (m.in_game && state.findPlayerById(m.game->player_id_) == nullptr) {
+                markDead(m);
+            }
+        }
+    }
+    
+    void markDead(Member& m) {
+        if (!m.in_game) {
+            return;
+        }
+        m.in_game = false;
+        m.game->in_game_ = false;
+        m.rejoin_at_ms = m.game->currentSystemTimeMs() +
+                         static_cast<long long>(config_.respawn_delay_sec * 1000);
+        m.game->log("WARNING", m.game->player_name_ + " died");
+    }
+    
+    /**
+    * @brief Rejoin dead bots whose respawn delay has passed.
+    * @return true if any bot joined the game.
+     */
+    bool rejoinDueMembers() {
+        if (!config_.auto_respawn) {
+            return false;
+        }
+        
+        bool joined = false;
+        for (size_t i = 0; i < members_.size(); ++i) {
+            Member& m = members_[i];
+            if (m.in_game || m.game->currentSystemTimeMs() < m.rejoin_at_ms) {
+                continue;
+            }
+            try {
+                m.game->joinGameInternal();
+                m.in_game = true;
+                joined = true;
+            } catch (const std::exception& e) {
+                m.game->log("ERROR", string("Rejoin failed: ") + e.what());
+                m.rejoin_at_ms = m.game->currentSystemTimeMs() +
+                                 static_cast<long long>(config_.respawn_delay_sec * 1000);
+            }
+        }
+        return joined;
+    }
+    
+    size_t countInGame() const {
+        size_t count = 0;
+        for (size_t i = 0; i < members_.size(); ++i) {
+            if (members_[i].in_game) {
+                ++count;
+            }
+        }
+        return count;
+    }
+};
+
 #endif // CODING_SNAKE_HPP
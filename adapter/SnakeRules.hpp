@@ -0,0 +1,490 @@
+/**
+ * SnakeRules.hpp - Embeddable CodingSnake rules engine
+ *
+ * A dependency-free, header-only implementation of one server round
+ * (GameManager::tick) for forward simulation. The whole state lives in a few
+ * flat arrays sized once by reset(), so:
+ *   - step() never allocates;
+ *   - cloning is a plain copy-assignment, which reuses the destination's
+ *     buffers when both states have the same shape.
+ *
+ * Round order (the server's GameManager::tick runs these phases through this
+ * engine):
+ *   1. apply moves (a move opposite to the current heading is ignored)
+ *   2. predict self collisions against the pre-move body, tail included
+ *   3. move every snake; pending growth keeps the tail
+ *   4. collisions: wall / self / other snake. Invincible snakes neither die
+ *      nor block. Deaths are collected first, then applied in slot order;
+ *      the kill goes to the first other live, non-invincible snake (in slot
+ *      order) whose body covers the victim's head. Every in-bounds body cell
+ *      of a dead snake becomes food.
+ *   5. heads on food eat it (growth + 1)
+ *   6. invincibility counts down, the round number increments
+ *
+ * Food spawning is random on the server and is left to the caller
+ * (addFood() between steps).
+ *
+ * Each snake keeps at most max_length cells; growth beyond that keeps the
+ * length unchanged. Size max_length with headroom for the rounds you plan
+ * to simulate.
+ *
+ * Requires C++11 only. Shared by the server, the SDK and bots.
+ */
+
+#ifndef CODING_SNAKE_RULES_HPP
+#define CODING_SNAKE_RULES_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace snake_rules {
+
+enum Move {
+    MOVE_NONE = 0,      // keep the current heading
+    MOVE_UP,
+    MOVE_DOWN,
+    MOVE_LEFT,
+    MOVE_RIGHT
+};
+
+enum DeathCause {
+    DEATH_NONE = 0,
+    DEATH_WALL,
+    DEATH_SELF,
+    DEATH_SNAKE
+};
+
+/**
+ * @brief Parse "up"/"down"/"left"/"right"; anything else is MOVE_NONE.
+ */
+inline Move parseMove(const std::string& s) {
+    if (s == "up") return MOVE_UP;
+    if (s == "down") return MOVE_DOWN;
+    if (s == "left") return MOVE_LEFT;
+    if (s == "right") return MOVE_RIGHT;
+    return MOVE_NONE;
+}
+
+/**
+ * @brief Wire name of a move; MOVE_NONE maps to an empty string.
+ */
+inline const char* moveName(Move m) {
+    switch (m) {
+        case MOVE_UP: return "up";
+        case MOVE_DOWN: return "down";
+        case MOVE_LEFT: return "left";
+        case MOVE_RIGHT: return "right";
+        default: return "";
+    }
+}
+
+inline bool isOpposite(Move a, Move b) {
+    return (a == MOVE_UP && b == MOVE_DOWN) || (a == MOVE_DOWN && b == MOVE_UP) ||
+           (a == MOVE_LEFT && b == MOVE_RIGHT) || (a == MOVE_RIGHT && b == MOVE_LEFT);
+}
+
+struct Cell {
+    int x;
+    int y;
+
+    Cell() : x(0), y(0) {}
+    Cell(int x_, int y_) : x(x_), y(y_) {}
+
+    bool operator==(const Cell& other) const { return x == other.x && y == other.y; }
+    bool operator!=(const Cell& other) const { return !(*this == other); }
+};
+
+inline Cell advance(Cell c, Move m) {
+    switch (m) {
+        case MOVE_UP: --c.y; break;
+        case MOVE_DOWN: ++c.y; break;
+        case MOVE_LEFT: --c.x; break;
+        case MOVE_RIGHT: ++c.x; break;
+        default: break;
+    }
+    return c;
+}
+
+/**
+ * @brief Complete game state for simulation: fixed snake slots, ring-buffer
+ * bodies and per-cell occupancy / food grids.
+ */
+class RulesState {
+public:
+    RulesState()
+        : width_(0), height_(0), max_snakes_(0), max_length_(0), round_(0), food_count_(0) {}
+
+    RulesState(int width, int height, int max_snakes, int max_length)
+        : width_(0), height_(0), max_snakes_(0), max_length_(0), round_(0), food_count_(0) {
+        reset(width, height, max_snakes, max_length);
+    }
+
+    /**
+     * @brief Set the shape and clear everything. The only call that allocates.
+     */
+    void reset(int width, int height, int max_snakes, int max_length) {
+        width_ = std::max(0, width);
+        height_ = std::max(0, height);
+        max_snakes_ = std::max(0, max_snakes);
+        max_length_ = std::max(1, max_length);
+
+        const std::size_t cells = static_cast<std::size_t>(width_) * height_;
+        const std::size_t slots = static_cast<std::size_t>(max_snakes_);
+        occupied_.assign(cells, 0);
+        solid_.assign(cells, 0);
+        food_.assign(cells, 0);
+        body_.assign(slots * max_length_, Cell());
+        start_.assign(slots, 0);
+        length_.assign(slots, 0);
+        growth_.assign(slots, 0);
+        invincible_.assign(slots, 0);
+        killer_.assign(slots, -1);
+        death_length_.assign(slots, 0);
+        dir_.assign(slots, static_cast<std::uint8_t>(MOVE_NONE));
+        alive_.assign(slots, 0);
+        death_.assign(slots, static_cast<std::uint8_t>(DEATH_NONE));
+        ate_.assign(slots, 0);
+        self_hit_.assign(slots, 0);
+        round_ = 0;
+        food_count_ = 0;
+    }
+
+    /**
+     * @brief Remove all snakes and food but keep the shape (no allocation).
+     */
+    void clear() {
+        std::fill(occupied_.begin(), occupied_.end(), 0);
+        std::fill(solid_.begin(), solid_.end(), 0);
+        std::fill(food_.begin(), food_.end(), 0);
+        std::fill(length_.begin(), length_.end(), 0);
+        std::fill(alive_.begin(), alive_.end(), 0);
+        clearEvents();
+        round_ = 0;
+        food_count_ = 0;
+    }
+
+    bool hasShape(int width, int height, int max_snakes, int max_length) const {
+        return width_ == width && height_ == height && max_snakes_ >= max_snakes &&
+               max_length_ >= max_length;
+    }
+
+    // ------------------------------------------------------------------
+    // Setup
+    // ------------------------------------------------------------------
+
+    /**
+     * @brief Put a live snake into a slot, replacing whatever was there.
+     * @param body Cells from head to tail; only the first max_length are kept.
+     * @return false if the slot is out of range or the body is empty.
+     */
+    bool placeSnake(int slot, const Cell* body, int length, Move direction,
+                    int invincible_rounds, int growth_pending) {
+        if (slot < 0 || slot >= max_snakes_ || length <= 0) {
+            return false;
+        }
+        removeSnake(slot);
+        const int n = std::min(length, max_length_);
+        std::copy(body, body + n, body_.begin() + static_cast<std::ptrdiff_t>(slot) * max_length_);
+        start_[slot] = 0;
+        length_[slot] = n;
+        dir_[slot] = static_cast<std::uint8_t>(direction);
+        invincible_[slot] = std::max(0, invincible_rounds);
+        growth_[slot] = std::max(0, growth_pending);
+        alive_[slot] = 1;
+        for (int k = 0; k < n; ++k) {
+            mark(blockAt(slot, k), invincible_[slot] == 0, 1);
+        }
+        return true;
+    }
+
+    /**
+     * @brief Take a snake off the board without dropping food (player left).
+     */
+    void removeSnake(int slot) {
+        if (slot < 0 || slot >= max_snakes_ || !alive_[slot]) {
+            return;
+        }
+        for (int k = 0; k < length_[slot]; ++k) {
+            mark(blockAt(slot, k), invincible_[slot] == 0, -1);
+        }
+        alive_[slot] = 0;
+        length_[slot] = 0;
+    }
+
+    bool addFood(int x, int y) {
+        if (!inBounds(x, y) || food_[cellIndex(x, y)]) {
+            return false;
+        }
+        food_[cellIndex(x, y)] = 1;
+        ++food_count_;
+        return true;
+    }
+
+    bool removeFood(int x, int y) {
+        if (!inBounds(x, y) || !food_[cellIndex(x, y)]) {
+            return false;
+        }
+        food_[cellIndex(x, y)] = 0;
+        --food_count_;
+        return true;
+    }
+
+    void setRound(int round) { round_ = round; }
+
+    // ------------------------------------------------------------------
+    // Queries
+    // ------------------------------------------------------------------
+
+    int width() const { return width_; }
+    int height() const { return height_; }
+    int maxSnakes() const { return max_snakes_; }
+    int maxLength() const { return max_length_; }
+    int round() const { return round_; }
+
+    bool inBounds(int x, int y) const { return x >= 0 && x < width_ && y >= 0 && y < height_; }
+
+    bool alive(int slot) const { return alive_[slot] != 0; }
+    int length(int slot) const { return length_[slot]; }
+    Cell head(int slot) const { return blockAt(slot, 0); }
+    // k-th body cell, 0 is the head
+    Cell block(int slot, int k) const { return blockAt(slot, k); }
+    Move direction(int slot) const { return static_cast<Move>(dir_[slot]); }
+    int invincibleRounds(int slot) const { return invincible_[slot]; }
+    int growthPending(int slot) const { return growth_[slot]; }
+
+    bool containsCell(int slot, const Cell& c) const {
+        for (int k = 0; k < length_[slot]; ++k) {
+            if (blockAt(slot, k) == c) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    int aliveCount() const {
+        int n = 0;
+        for (int s = 0; s < max_snakes_; ++s) {
+            n += alive_[s];
+        }
+        return n;
+    }
+
+    bool hasFood(int x, int y) const { return inBounds(x, y) && food_[cellIndex(x, y)] != 0; }
+    int foodCount() const { return food_count_; }
+
+    // Any live snake (invincible or not) covers the cell
+    bool occupied(int x, int y) const { return inBounds(x, y) && occupied_[cellIndex(x, y)] != 0; }
+    // A live, non-invincible snake covers the cell (kills on entry)
+    bool solid(int x, int y) const { return inBounds(x, y) && solid_[cellIndex(x, y)] != 0; }
+
+    // Food cells in row-major order: fn(x, y)
+    template <typename Fn>
+    void forEachFood(Fn fn) const {
+        if (food_count_ == 0) {
+            return;
+        }
+        for (int y = 0; y < height_; ++y) {
+            for (int x = 0; x < width_; ++x) {
+                if (food_[cellIndex(x, y)]) {
+                    fn(x, y);
+                }
+            }
+        }
+    }
+
+    // Events of the most recent step()
+    DeathCause deathCause(int slot) const { return static_cast<DeathCause>(death_[slot]); }
+    int killer(int slot) const { return killer_[slot]; }
+    // Length of a snake that died in the last step, as it was when it died
+    int deathLength(int slot) const { return death_length_[slot]; }
+    bool ate(int slot) const { return ate_[slot] != 0; }
+
+    // ------------------------------------------------------------------
+    // Simulation
+    // ------------------------------------------------------------------
+
+    /**
+     * @brief Advance one round.
+     * @param moves One entry per slot (maxSnakes()); entries of empty slots
+     *              are ignored, MOVE_NONE keeps the current heading.
+     */
+    void step(const Move* moves) {
+        clearEvents();
+
+        // 1. Apply moves
+        for (int s = 0; s < max_snakes_; ++s) {
+            if (!alive_[s] || moves[s] == MOVE_NONE) {
+                continue;
+            }
+            const Move current = static_cast<Move>(dir_[s]);
+            if (current != MOVE_NONE && isOpposite(current, moves[s])) {
+                continue;
+            }
+            dir_[s] = static_cast<std::uint8_t>(moves[s]);
+        }
+
+        // 2. Predict self collisions on the pre-move body
+        for (int s = 0; s < max_snakes_; ++s) {
+            if (!alive_[s] || dir_[s] == MOVE_NONE || length_[s] <= 1) {
+                continue;
+            }
+            const Cell next = advance(blockAt(s, 0), static_cast<Move>(dir_[s]));
+            self_hit_[s] = containsCell(s, next) ? 1 : 0;
+        }
+
+        // 3. Move
+        for (int s = 0; s < max_snakes_; ++s) {
+            if (!alive_[s] || dir_[s] == MOVE_NONE) {
+                continue;
+            }
+            const bool solid = invincible_[s] == 0;
+            const Cell next = advance(blockAt(s, 0), static_cast<Move>(dir_[s]));
+            bool grow = false;
+            if (growth_[s] > 0) {
+                --growth_[s];
+                grow = length_[s] < max_length_;
+            }
+            if (!grow) {
+                mark(blockAt(s, length_[s] - 1), solid, -1);
+                --length_[s];
+            }
+            start_[s] = start_[s] == 0 ? max_length_ - 1 : start_[s] - 1;
+            body_[static_cast<std::size_t>(s) * max_length_ + start_[s]] = next;
+            ++length_[s];
+            mark(next, solid, 1);
+        }
+
+        // 4. Collisions: collect first, then apply
+        for (int s = 0; s < max_snakes_; ++s) {
+            if (!alive_[s] || invincible_[s] > 0) {
+                continue;
+            }
+            const Cell h = blockAt(s, 0);
+            if (!inBounds(h.x, h.y)) {
+                death_[s] = DEATH_WALL;
+            } else if (self_hit_[s]) {
+                death_[s] = DEATH_SELF;
+            } else if (solid_[cellIndex(h.x, h.y)] > 1) {
+                death_[s] = DEATH_SNAKE;
+            }
+        }
+        for (int s = 0; s < max_snakes_; ++s) {
+            if (death_[s] == DEATH_NONE) {
+                continue;
+            }
+            if (death_[s] == DEATH_SNAKE) {
+                const Cell h = blockAt(s, 0);
+                for (int k = 0; k < max_snakes_; ++k) {
+                    if (k != s && alive_[k] && invincible_[k] == 0 && containsCell(k, h)) {
+                        killer_[s] = k;
+                        break;
+                    }
+                }
+            }
+            kill(s);
+        }
+
+        // 5. Eat
+        for (int s = 0; s < max_snakes_; ++s) {
+            if (!alive_[s]) {
+                continue;
+            }
+            const Cell h = blockAt(s, 0);
+            if (removeFood(h.x, h.y)) {
+                ++growth_[s];
+                ate_[s] = 1;
+            }
+        }
+
+        // 6. Invincibility; a snake whose shield drops starts blocking
+        for (int s = 0; s < max_snakes_; ++s) {
+            if (!alive_[s] || invincible_[s] == 0) {
+                continue;
+            }
+            if (--invincible_[s] == 0) {
+                for (int k = 0; k < length_[s]; ++k) {
+                    const Cell c = blockAt(s, k);
+                    if (inBounds(c.x, c.y)) {
+                        ++solid_[cellIndex(c.x, c.y)];
+                    }
+                }
+            }
+        }
+
+        ++round_;
+    }
+
+private:
+    std::size_t cellIndex(int x, int y) const {
+        return static_cast<std::size_t>(y) * width_ + x;
+    }
+
+    Cell blockAt(int slot, int k) const {
+        int i = start_[slot] + k;
+        if (i >= max_length_) {
+            i -= max_length_;
+        }
+        return body_[static_cast<std::size_t>(slot) * max_length_ + i];
+    }
+
+    void mark(const Cell& c, bool solid, int delta) {
+        if (!inBounds(c.x, c.y)) {
+            return;
+        }
+        const std::size_t i = cellIndex(c.x, c.y);
+        occupied_[i] = static_cast<std::uint16_t>(occupied_[i] + delta);
+        if (solid) {
+            solid_[i] = static_cast<std::uint16_t>(solid_[i] + delta);
+        }
+    }
+
+    void kill(int slot) {
+        death_length_[slot] = length_[slot];
+        for (int k = 0; k < length_[slot]; ++k) {
+            const Cell c = blockAt(slot, k);
+            addFood(c.x, c.y);
+        }
+        removeSnake(slot);
+    }
+
+    void clearEvents() {
+        std::fill(death_.begin(), death_.end(), static_cast<std::uint8_t>(DEATH_NONE));
+        std::fill(killer_.begin(), killer_.end(), -1);
+        std::fill(death_length_.begin(), death_length_.end(), 0);
+        std::fill(ate_.begin(), ate_.end(), 0);
+        std::fill(self_hit_.begin(), self_hit_.end(), 0);
+    }
+
+    int width_;
+    int height_;
+    int max_snakes_;
+    int max_length_;
+    int round_;
+    int food_count_;
+
+    // Per cell
+    std::vector<std::uint16_t> occupied_;   // live body cells
+    std::vector<std::uint16_t> solid_;      // live, non-invincible body cells
+    std::vector<std::uint8_t> food_;
+
+    // Per slot; body_ holds max_length cells per slot as a ring starting at start_
+    std::vector<Cell> body_;
+    std::vector<int> start_;
+    std::vector<int> length_;
+    std::vector<int> growth_;
+    std::vector<int> invincible_;
+    std::vector<int> killer_;
+    std::vector<int> death_length_;
+    std::vector<std::uint8_t> dir_;
+    std::vector<std::uint8_t> alive_;
+    std::vector<std::uint8_t> death_;
+    std::vector<std::uint8_t> ate_;
+    std::vector<std::uint8_t> self_hit_;
+};
+
+} // namespace snake_rules
+
+#endif // CODING_SNAKE_RULES_HPP
@@ -40,6 +40,8 @@ def merge_single_file(output_dir='release'):
         print("  ✓ httplib.h")
         json_content = read_file('third_party/json.hpp')
         print("  ✓ json.hpp")
+        rules_content = read_file('SnakeRules.hpp')
+        print("  ✓ SnakeRules.hpp")
     except FileNotFoundError as e:
         print(f"  ✗ 错误: 找不到依赖文件 {e.filename}")
         return False
@@ -66,6 +68,11 @@ def merge_single_file(output_dir='release'):
         '// json.hpp content embedded below',
         main_content
     )
+    main_content = re.sub(
+        r'#include\s+"SnakeRules\.hpp"',
+        '// SnakeRules.hpp content embedded below',
+        main_content
+    )
     print("  ✓ 已移除外部依赖引用")
     
     # 移除依赖库中的 pragma once（避免重复定义）
@@ -113,7 +120,12 @@ def merge_single_file(output_dir='release'):
 #include <sstream>
 #include <thread>
 #include <chrono>
+#include <cstddef>
+#include <iterator>
 #include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
 
 // ============================================================================
 // Third-party library: cpp-httplib
@@ -131,6 +143,12 @@ def merge_single_file(output_dir='release'):
 
 {json_content}
 
+// ============================================================================
+// CodingSnake rules engine (SnakeRules.hpp)
+// ============================================================================
+
+{rules_content}
+
 // ============================================================================
 // CodingSnake core implementation
 // ============================================================================
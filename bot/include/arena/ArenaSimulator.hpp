@@ -0,0 +1,55 @@
+#pragma once
+
+#include "CodingSnake.hpp"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace bot {
+
+// 离线对局参数（默认值与 server/config.json 保持一致）
+struct ArenaOptions {
+    int width = 50;
+    int height = 50;
+    int rounds = 500;               // 每局回合数
+    int initialLength = 3;
+    int invincibleRounds = 5;
+    double foodDensity = 0.01;
+    int respawnDelayRounds = 4;     // 死亡后等待多少回合重生（对应客户端的重生延迟）
+};
+
+// 参赛策略：名称 + 决策函数 + 可选的状态重置函数
+struct ArenaEntrant {
+    std::string name;
+    std::string (*decide)(const GameState&);
+    // 策略在决策之间保存了状态时提供：每局开始前在运行该局的线程上调用，避免上一局的状态带入本局
+    void (*reset)() = nullptr;
+};
+
+// 单个参赛者在一局中的统计
+struct EntrantResult {
+    int finalLength = 0;    // 对局结束时的长度（已死亡且未重生为 0）
+    int maxLength = 0;
+    int foods = 0;
+    int kills = 0;
+    int deaths = 0;
+    int decisionErrors = 0; // 决策函数抛出异常的次数
+};
+
+struct GameResult {
+    std::vector<EntrantResult> entrants;
+    int winner = -1;        // 结束时最长者的下标；并列或全部死亡为 -1
+};
+
+/**
+ * 在当前线程内完整模拟一局：回合推进由 SnakeRules.hpp 的规则引擎完成，与 server 的 GameManager::tick 一致
+ * （移动 -> 预判自撞 -> 统一移动 -> 碰撞 -> 吃食物 -> 补充食物 -> 无敌递减），
+ * 决策函数直接以 GameState 调用，不经过网络。开局前调用各参赛者的 reset，
+ * 因此相同 seed 得到相同结果，与该局在哪个线程上运行无关。
+ */
+GameResult runArenaGame(const ArenaOptions& options,
+                        const std::vector<ArenaEntrant>& entrants,
+                        std::uint64_t seed);
+
+}  // namespace bot
@@ -0,0 +1,104 @@
+#pragma once
+
+#include "CodingSnake.hpp"
+
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace bot {
+
+/**
+ * 位棋盘：每格 1 bit，按行打包进 64 位字。
+ *
+ * 每行占 width/64 + 1 个字，保证每行最后一个字至少有一位空闲，
+ * 整块数组做左右移位时跨行的进位恰好落在空闲位上，被掩码清掉；
+ * 数组首尾各留一行零字作为哨兵，扩张时无需做边界判断。
+ * 50x50 地图即 50 个字，一次四邻扩张就是几十条位运算。
+ *
+ * 扩张内核在编译器开启 AVX2 时每次处理 4 个字，开启 SSE2 时每次 2 个字，
+ * 否则为标量实现；三者结果完全一致。
+ */
+class Bitboard {
+public:
+    Bitboard() = default;
+    Bitboard(int width, int height) { resize(width, height); }
+
+    // 设置尺寸并清空；尺寸不变时不重新分配
+    void resize(int width, int height);
+    void clear();
+
+    int width() const { return width_; }
+    int height() const { return height_; }
+    bool inBounds(int x, int y) const { return x >= 0 && x < width_ && y >= 0 && y < height_; }
+
+    bool test(int x, int y) const;
+    bool test(const Point& p) const { return test(p.x, p.y); }
+    void set(int x, int y);
+    void set(const Point& p) { set(p.x, p.y); }
+    void unset(int x, int y);
+    void unset(const Point& p) { unset(p.x, p.y); }
+
+    // 置位格子数
+    int count() const;
+    bool empty() const;
+
+    // 按位运算（两者尺寸必须相同）
+    Bitboard& operator|=(const Bitboard& other);
+    Bitboard& operator&=(const Bitboard& other);
+    void andNot(const Bitboard& other);
+    bool operator==(const Bitboard& other) const;
+    bool operator!=(const Bitboard& other) const { return !(*this == other); }
+
+    // 可走格子：界内且没有蛇身
+    void assignFreeCells(const GameState& state);
+
+    /**
+     * 四邻扩张一步：out = this ∪ (四邻(this) ∩ mask)。
+     * 原有位无论是否在 mask 内都保留（起点可以是自己的蛇头）。
+     * 返回 out 是否比 this 多出了格子。
+     */
+    bool dilate(const Bitboard& mask, Bitboard& out) const;
+
+    // 按行遍历置位格子：fn(Point)
+    template <typename Fn>
+    void forEach(Fn&& fn) const {
+        for (int y = 0; y < height_; ++y) {
+            const std::uint64_t* row = rowWords(y);
+            for (int w = 0; w < stride_; ++w) {
+                std::uint64_t bits = row[w];
+                while (bits != 0) {
+                    const int bit = lowestBit(bits);
+                    fn(Point(w * 64 + bit, y));
+                    bits &= bits - 1;
+                }
+            }
+        }
+    }
+
+private:
+    static int lowestBit(std::uint64_t bits);
+
+    const std::uint64_t* rowWords(int y) const { return words_.data() + (y + 1) * stride_; }
+    std::uint64_t* rowWords(int y) { return words_.data() + (y + 1) * stride_; }
+    std::uint64_t* data() { return words_.data() + stride_; }
+    const std::uint64_t* data() const { return words_.data() + stride_; }
+    std::size_t dataWords() const { return static_cast<std::size_t>(height_) * stride_; }
+
+    int width_ = 0;
+    int height_ = 0;
+    int stride_ = 1;                    // 每行字数
+    std::vector<std::uint64_t> words_;  // 哨兵行 + height 行 + 哨兵行
+};
+
+constexpr int kBitboardNoLimit = std::numeric_limits<int>::max();
+
+/**
+ * 从 seed 出发在 passable 内洪泛，最多扩张 maxSteps 步；结果写入 region，返回区域格数（含 seed）。
+ * maxSteps 为 k 时 region 即“k 步内可达”的格子，相邻两次结果做 andNot 即得第 k 层边界。
+ * scratch 为调用方复用的临时缓冲，避免每次搜索分配。
+ */
+int floodFill(const Bitboard& passable, const Point& seed, Bitboard& region, Bitboard& scratch,
+              int maxSteps = kBitboardNoLimit);
+
+}  // namespace bot
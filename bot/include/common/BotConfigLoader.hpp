@@ -2,6 +2,7 @@
 
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 namespace bot {
 
@@ -17,4 +18,12 @@ std::string getConfigValue(
     const std::string& fallback
 );
 
+// 读取逗号分隔的列表项（各项去除首尾空白，忽略空项），优先级同 getConfigValue
+std::vector<std::string> getConfigList(
+    const std::unordered_map<std::string, std::string>& config,
+    const std::string& key,
+    const char* envKey,
+    const std::string& fallback
+);
+
 }  // namespace bot
@@ -0,0 +1,112 @@
+#pragma once
+
+#include "CodingSnake.hpp"
+
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <vector>
+
+namespace bot {
+
+/**
+ * 可复用的网格搜索器：BFS 距离场、A* 与可达面积统计。
+ *
+ * 所有缓冲区按地图大小分配一次并跨回合复用；访问标记使用“时间戳”
+ * （stamp == epoch 即本次已访问），每次搜索只需递增 epoch，无需清空数组，
+ * 稳态下单次搜索不做任何堆分配。
+ *
+ * 用法：每回合先 bind(state) 拍下障碍快照，再调用任意搜索函数；
+ * 搜索起点即便位于障碍上（例如自己的蛇头）也视为可达。
+ * 一个实例不可跨线程共享，策略中通常声明为 thread_local。
+ */
+class GridSearch {
+public:
+    static constexpr int kUnreached = -1;
+    static constexpr int kNoLimit = std::numeric_limits<int>::max();
+
+    // 绑定地图尺寸并拍下障碍快照；尺寸不变时不重新分配
+    void bind(const GameState& state);
+
+    // 手动改写某格的障碍标记（例如把即将移走的蛇尾视为可走）
+    void setBlocked(const Point& p, bool blocked);
+    bool isBlocked(const Point& p) const;
+
+    int width() const { return width_; }
+    int height() const { return height_; }
+    bool inBounds(const Point& p) const {
+        return p.x >= 0 && p.x < width_ && p.y >= 0 && p.y < height_;
+    }
+
+    /**
+     * 单源 / 多源 BFS 距离场：结果通过 distanceAt() 读取，直到下一次搜索。
+     * 多源时每格的距离为到最近源点的步数（例如以所有食物为源，得到“离最近食物多远”）。
+     * maxDepth 限制扩展深度，返回到达的格子数（含源点）。
+     */
+    int bfs(const Point& source, int maxDepth = kNoLimit);
+    int bfs(const std::vector<Point>& sources, int maxDepth = kNoLimit);
+
+    // 最近一次搜索得到的距离；未到达为 kUnreached
+    int distanceAt(const Point& p) const;
+
+    /**
+     * BFS 最短路的第一步方向；邻居按 allDirections() 顺序扩展，结果确定。
+     * 目标格允许是障碍（追尾、抢占目标时常见）；不可达或起点即目标时返回空串。
+     */
+    std::string firstStep(const Point& start, const Point& target);
+
+    /**
+     * A*（曼哈顿启发）：返回路径长度，不可达为 kUnreached；firstStep 非空时写入第一步方向。
+     * 堆中 f 相同时优先 g 更大的节点（更靠近目标），开阔地图上扩展节点数接近路径长度。
+     * 目标格允许是障碍，与 firstStep() 一致。
+     */
+    int aStar(const Point& start, const Point& target, std::string* firstStep = nullptr);
+
+    /**
+     * 从 start 出发的连通可走格子数（不含 start 本身）；达到 limit 时提前返回 limit。
+     * 常用于判断走进某格后是否会被困：reachableArea(next, 自身长度)。
+     */
+    int reachableArea(const Point& start, int limit = kNoLimit);
+
+private:
+    // 预分配的环形队列：容量为格子总数，每次搜索每格最多入队一次
+    class Frontier {
+    public:
+        void reserve(std::size_t capacity);
+        void clear() { head_ = 0; size_ = 0; }
+        bool empty() const { return size_ == 0; }
+        void push(int cell);
+        int pop();
+
+    private:
+        std::vector<int> buffer_;
+        std::size_t head_ = 0;
+        std::size_t size_ = 0;
+    };
+
+    // A* 堆节点：f 小者优先，f 相同取 g 大者，再按格子编号保证确定性
+    struct HeapNode {
+        int f;
+        int g;
+        int cell;
+    };
+
+    int cellOf(const Point& p) const { return p.y * width_ + p.x; }
+    void nextEpoch();
+    bool visited(int cell) const { return stamp_[cell] == epoch_; }
+    void visit(int cell, int distance, int parent);
+    int bfsFromFrontier(int maxDepth);
+    std::string directionFromParents(int start, int target) const;
+
+    int width_ = 0;
+    int height_ = 0;
+    std::vector<std::uint8_t> blocked_;
+    std::vector<std::uint32_t> stamp_;
+    std::vector<int> distance_;
+    std::vector<int> parent_;
+    std::uint32_t epoch_ = 0;
+    Frontier frontier_;
+    std::vector<HeapNode> heap_;
+};
+
+}  // namespace bot
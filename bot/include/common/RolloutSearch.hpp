@@ -0,0 +1,157 @@
+#pragma once
+
+#include "CodingSnake.hpp"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace bot {
+
+/**
+ * 推演走法策略：给定模拟状态与蛇的槽位，返回这条蛇下一步的走法。
+ * rng 为调用方持有的随机数状态（配合 nextRandom 使用），同一种子下结果确定。
+ */
+using PlayoutPolicy = snake_rules::Move (*)(const snake_rules::RulesState& rules, int slot,
+                                            std::uint64_t& rng);
+
+// splitmix64：推演中使用的廉价随机数
+inline std::uint64_t nextRandom(std::uint64_t& state) {
+    std::uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+// 在不越界、不撞蛇身的走法中随机选一个；无路可走时随机选一个非反向走法
+snake_rules::Move randomSafePlayout(const snake_rules::RulesState& rules, int slot, std::uint64_t& rng);
+
+// 朝附近最近的食物走（曼哈顿距离），只考虑安全走法；1/8 概率随机安全走法，附近没有食物时同样随机
+snake_rules::Move greedyFoodPlayout(const snake_rules::RulesState& rules, int slot, std::uint64_t& rng);
+
+/**
+ * 把模拟状态转换为 GameState（玩家 ID 为 "s<槽位>"，slot 为“自己”），
+ * 用于以现有策略函数作为推演走法。view 跨调用复用。
+ */
+void loadGameState(const snake_rules::RulesState& rules, int slot, GameState& view);
+
+/**
+ * 以 GameState 策略函数作为推演走法，例如 strategyPlayout<decideGlutton>。
+ * 每步都要重建 GameState 并运行完整策略，比内置走法慢一到两个数量级；
+ * 只适合无跨回合状态的策略（暴食者可以，巡逻兵/寄生虫的线程状态会被推演打乱）。
+ */
+template <std::string (*Decide)(const GameState&)>
+snake_rules::Move strategyPlayout(const snake_rules::RulesState& rules, int slot, std::uint64_t&) {
+    thread_local GameState view;
+    loadGameState(rules, slot, view);
+    return snake_rules::parseMove(Decide(view));
+}
+
+struct RolloutOptions {
+    int depth = 10;                 // 每次推演的回合数（树内 + 模拟）
+    int budgetMs = 150;             // 时间预算；<= 0 表示不限时，仅受 maxIterations 约束
+    int maxIterations = 0;          // 推演次数上限（所有线程合计）；0 表示只受时间约束
+    int threads = 1;                // 推演线程数（含调用线程）
+    int maxNodes = 1 << 16;         // 每个线程的节点池容量，用完后只模拟不再扩展
+    double exploration = 0.7;       // UCB1 探索系数
+    std::uint64_t seed = 1;         // 与回合号混合后作为随机种子
+    PlayoutPolicy selfPolicy = greedyFoodPlayout;       // 树外自己的走法
+    PlayoutPolicy opponentPolicy = greedyFoodPlayout;   // 对手的走法（树内树外相同）
+};
+
+struct RolloutResult {
+    snake_rules::Move move = snake_rules::MOVE_NONE;
+    int iterations = 0;
+    int nodes = 0;                          // 所有线程合计使用的节点数
+    std::array<int, 5> visits{};            // 按 Move 下标：根节点各走法的访问次数
+    std::array<double, 5> value{};          // 按 Move 下标：平均得分，[0, 1]
+
+    std::string direction() const { return snake_rules::moveName(move); }
+};
+
+/**
+ * 蒙特卡洛树搜索（UCT）：树只展开自己的走法，对手每步由 opponentPolicy 采样，
+ * 超出树的部分由 selfPolicy 模拟到 depth 回合；每次推演在 SnakeRules 引擎的
+ * 状态副本上进行（复制赋值即克隆，不分配内存）。
+ *
+ * 得分：推演结束仍存活为 0.6 + 0.4 * min(1, 增长/4)，中途死亡为 0.5 * 存活回合/depth。
+ * 最终选访问次数最多的根走法。
+ *
+ * 节点来自按 maxNodes 预分配的池，以下标互相引用，每次搜索只重置池计数。
+ * threads > 1 时采用根并行：每个线程各自建树，结束后合并根节点统计；
+ * 辅助线程在构造时创建并跨搜索复用。threads == 1、budgetMs <= 0 且设置了
+ * maxIterations 时结果完全可复现。
+ *
+ * 一个实例同一时间只能执行一次搜索，策略中通常声明为 thread_local。
+ */
+class RolloutSearch {
+public:
+    explicit RolloutSearch(const RolloutOptions& options = RolloutOptions());
+    ~RolloutSearch();
+
+    RolloutSearch(const RolloutSearch&) = delete;
+    RolloutSearch& operator=(const RolloutSearch&) = delete;
+
+    const RolloutOptions& options() const { return options_; }
+
+    // 修改之后各次搜索的时间预算（不可在搜索进行中调用），用于按回合时长调整
+    void setBudgetMs(int budgetMs);
+
+    // 以当前局面搜索自己的走法；自己不在场时返回 MOVE_NONE
+    RolloutResult search(const GameState& state);
+    RolloutResult search(const snake_rules::RulesState& root, int slot);
+
+private:
+    struct Node {
+        std::int32_t children[4];   // 按 Move - 1 下标；-1 为未展开
+        std::int32_t visits;
+        double total;
+        snake_rules::Move heading;  // 到达该节点后的朝向，决定哪些走法合法
+    };
+
+    struct Worker {
+        snake_rules::RulesState sim;
+        std::vector<Node> nodes;
+        int nodeCount = 0;
+        std::vector<int> path;
+        std::vector<snake_rules::Move> moves;
+        std::uint64_t rng = 0;
+    };
+
+    void helperLoop(int index);
+    void runWorker(Worker& worker, int index);
+    void iterate(Worker& worker);
+    int newNode(Worker& worker, snake_rules::Move heading);
+    bool shouldStop();
+
+    RolloutOptions options_;
+    std::vector<std::unique_ptr<Worker>> workers_;
+    std::vector<std::thread> helpers_;
+
+    // 单次搜索的共享参数，由 search() 在唤醒辅助线程前写好
+    const snake_rules::RulesState* root_ = nullptr;
+    int slot_ = -1;
+    int rootSize_ = 0;
+    std::chrono::steady_clock::time_point deadline_;
+    std::atomic<int> remaining_{0};
+    std::atomic<int> iterations_{0};
+
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::condition_variable done_;
+    std::uint64_t generation_ = 0;
+    int running_ = 0;
+    bool stopping_ = false;
+
+    snake_rules::RulesState loaded_;
+    std::vector<std::string> slotIds_;
+};
+
+}  // namespace bot
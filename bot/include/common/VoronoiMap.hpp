@@ -0,0 +1,68 @@
+#pragma once
+
+#include "CodingSnake.hpp"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace bot {
+
+/**
+ * 多源 Voronoi 领地划分：以所有蛇头为源同时 BFS，蛇身视为障碍，
+ * 每格记录离它最近（真实路径距离）的蛇；同时有多条蛇最近的格子标记为平局。
+ *
+ * 平局判定是精确的：BFS 按层推进，一格的最近蛇集合等于所有上一层前驱的并集，
+ * 只要前驱归属不一致（或前驱本身是平局）该格即为平局。
+ *
+ * 每回合 compute(state) 一次，之后所有查询都是 O(1)；缓冲区跨回合复用。
+ * 玩家下标按 getPlayerMap() 的迭代顺序编号，player() 返回的引用在 state 变化前有效。
+ */
+class VoronoiMap {
+public:
+    static constexpr int kUnreached = -1;
+    static constexpr int kNoOwner = -1;
+    static constexpr int kTie = -2;
+
+    void compute(const GameState& state);
+
+    int playerCount() const { return static_cast<int>(players_.size()); }
+    const Snake& player(int index) const { return *players_[index]; }
+    // 按玩家 ID 查下标，找不到返回 -1
+    int indexOf(const std::string& id) const;
+
+    // 格子归属：玩家下标、kTie 或 kNoOwner（不可达/障碍）
+    int ownerAt(const Point& p) const;
+    // 到最近蛇头的路径距离；未到达为 kUnreached
+    int distanceAt(const Point& p) const;
+
+    // 玩家独占的格子数（不含平局格与蛇头）
+    int territory(int index) const { return territory_[index]; }
+    // 玩家能最先（严格）到达的食物，按 getFoodSet() 顺序
+    const std::vector<Point>& foodsOf(int index) const { return foods_[index]; }
+    // 两条及以上的蛇同时最先到达的食物
+    const std::vector<Point>& contestedFoods() const { return contested_; }
+
+private:
+    int cellOf(const Point& p) const { return p.y * width_ + p.x; }
+    bool inBounds(const Point& p) const {
+        return p.x >= 0 && p.x < width_ && p.y >= 0 && p.y < height_;
+    }
+    bool visited(int cell) const { return stamp_[cell] == epoch_; }
+    void resize(int width, int height);
+
+    int width_ = 0;
+    int height_ = 0;
+    std::uint32_t epoch_ = 0;
+    std::vector<std::uint32_t> stamp_;
+    std::vector<int> distance_;
+    std::vector<int> owner_;
+    std::vector<int> queue_;            // 每格最多入队一次，容量为格子总数
+
+    std::vector<const Snake*> players_;
+    std::vector<int> territory_;
+    std::vector<std::vector<Point>> foods_;
+    std::vector<Point> contested_;
+};
+
+}  // namespace bot
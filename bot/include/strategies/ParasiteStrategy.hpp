@@ -9,4 +9,7 @@ namespace bot {
 // 寄生虫：贴近排行榜第一（这里近似为最长蛇）并保持侧向伴随
 std::string decideParasite(const GameState& state);
 
+// 清空当前线程按蛇 ID 保存的跨回合状态（离线对局在每局开始时调用）
+void resetParasiteState();
+
 }  // namespace bot
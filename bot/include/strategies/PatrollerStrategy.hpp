@@ -9,4 +9,7 @@ namespace bot {
 // 巡逻兵：维持在矩形轨迹巡逻，受阻时临时避障并回归
 std::string decidePatroller(const GameState& state);
 
+// 清空当前线程按蛇 ID 保存的跨回合状态（离线对局在每局开始时调用）
+void resetPatrollerState();
+
 }  // namespace bot
@@ -0,0 +1,15 @@
+#pragma once
+
+#include "CodingSnake.hpp"
+
+#include <string>
+
+namespace bot {
+
+// 推演者：在 budgetMs 内用规则引擎做蒙特卡洛推演搜索，选存活与成长期望最高的走法
+std::string decideRollout(const GameState& state, int budgetMs);
+
+// 由回合时长换算推演预算：取 share 比例（同一车队的其他 Bot 与网络往返共用剩余时间），至少 1ms
+int rolloutBudgetMs(int roundTimeMs, double share);
+
+}  // namespace bot
@@ -0,0 +1,239 @@
+#include "arena/ArenaSimulator.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <random>
+
+namespace bot {
+
+namespace {
+
+using snake_rules::Cell;
+using snake_rules::Move;
+
+// 每个参赛者固定占用规则引擎中的同一个槽位
+struct EntrantState {
+    std::string id;
+    int respawnAt = 0;          // 死亡后允许重生的回合
+    int spawnCount = 0;         // 用于生成每次重生的新 ID（与服务器一样，重生即新会话）
+};
+
+class ArenaGame {
+public:
+    ArenaGame(const ArenaOptions& options, const std::vector<ArenaEntrant>& entrants, std::uint64_t seed)
+        : options_(options)
+        , entrants_(entrants)
+        , rng_(seed)
+        , states_(entrants.size())
+        , moves_(entrants.size(), snake_rules::MOVE_NONE)
+        , rules_(options.width, options.height, static_cast<int>(entrants.size()),
+                 std::max(options.width * options.height, options.initialLength)) {
+        result_.entrants.resize(entrants.size());
+        view_.setMapSize(options_.width, options_.height);
+    }
+
+    GameResult run() {
+        for (round_ = 0; round_ < options_.rounds; ++round_) {
+            respawnDead();
+            decide();
+            tick();
+        }
+
+        int best = 0;
+        for (std::size_t i = 0; i < states_.size(); ++i) {
+            EntrantResult& r = result_.entrants[i];
+            r.finalLength = rules_.alive(slot(i)) ? rules_.length(slot(i)) : 0;
+            if (r.finalLength > best) {
+                best = r.finalLength;
+                result_.winner = static_cast<int>(i);
+            } else if (r.finalLength == best && best > 0) {
+                result_.winner = -1;
+            }
+        }
+        return result_;
+    }
+
+private:
+    static int slot(std::size_t i) { return static_cast<int>(i); }
+
+    // 对应 MapManager::getRandomSafePosition：半径 5 内没有任何存活蛇身
+    bool findSpawn(Point& out) {
+        const int radius = 5;
+        const int totalCells = options_.width * options_.height;
+        const int maxAttempts = std::min(totalCells, std::max(100, totalCells / 10));
+        int minX = radius, maxX = options_.width - 1 - radius;
+        int minY = radius, maxY = options_.height - 1 - radius;
+        if (minX > maxX || minY > maxY) {
+            minX = 0;
+            maxX = options_.width - 1;
+            minY = 0;
+            maxY = options_.height - 1;
+        }
+        std::uniform_int_distribution<int> distX(minX, maxX);
+        std::uniform_int_distribution<int> distY(minY, maxY);
+
+        for (int attempt = 0; attempt < maxAttempts; ++attempt) {
+            const Point candidate(distX(rng_), distY(rng_));
+            bool safe = true;
+            for (int s = 0; s < rules_.maxSnakes() && safe; ++s) {
+                if (!rules_.alive(s)) {
+                    continue;
+                }
+                for (int k = 0; k < rules_.length(s); ++k) {
+                    const Cell b = rules_.block(s, k);
+                    if (std::abs(b.x - candidate.x) <= radius && std::abs(b.y - candidate.y) <= radius) {
+                        safe = false;
+                        break;
+                    }
+                }
+            }
+            if (safe) {
+                out = candidate;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void respawnDead() {
+        static const Move kDirs[] = {snake_rules::MOVE_UP, snake_rules::MOVE_DOWN,
+                                     snake_rules::MOVE_LEFT, snake_rules::MOVE_RIGHT};
+        for (std::size_t i = 0; i < states_.size(); ++i) {
+            EntrantState& s = states_[i];
+            if (rules_.alive(slot(i)) || round_ < s.respawnAt) {
+                continue;
+            }
+            Point spawn;
+            if (!findSpawn(spawn)) {
+                continue;  // 没有安全位置，下回合再试
+            }
+            // 带上参赛者下标：同一策略多次参赛时 ID 也不重复
+            s.id = "p" + std::to_string(i) + "_" + entrants_[i].name + "_" + std::to_string(++s.spawnCount);
+            const Cell head(spawn.x, spawn.y);
+            const Move dir = kDirs[std::uniform_int_distribution<int>(0, 3)(rng_)];
+            rules_.placeSnake(slot(i), &head, 1, dir, options_.invincibleRounds, options_.initialLength - 1);
+            result_.entrants[i].maxLength = std::max(result_.entrants[i].maxLength, 1);
+        }
+    }
+
+    // 构造与客户端看到的一致的 GameState，依次调用每个存活者的决策函数
+    void decide() {
+        view_.setCurrentRound(round_);
+        view_.clearPlayers();
+        for (std::size_t i = 0; i < states_.size(); ++i) {
+            const int s = slot(i);
+            if (!rules_.alive(s)) {
+                continue;
+            }
+            blocks_.clear();
+            for (int k = 0; k < rules_.length(s); ++k) {
+                const Cell b = rules_.block(s, k);
+                blocks_.push_back(Point(b.x, b.y));
+            }
+            Snake snake;
+            snake.id = states_[i].id;
+            snake.name = entrants_[i].name;
+            snake.head = blocks_.front();
+            snake.blocks.assign(blocks_.begin(), blocks_.end());
+            snake.length = rules_.length(s);
+            snake.invincible_rounds = rules_.invincibleRounds(s);
+            view_.addOrUpdatePlayer(snake);
+        }
+        view_.clearFoods();
+        rules_.forEachFood([this](int x, int y) { view_.addFood(Point(x, y)); });
+
+        for (std::size_t i = 0; i < states_.size(); ++i) {
+            moves_[i] = snake_rules::MOVE_NONE;
+            if (!rules_.alive(slot(i))) {
+                continue;
+            }
+            view_.setMyId(states_[i].id);
+            std::string direction;
+            try {
+                direction = entrants_[i].decide(view_);
+            } catch (const std::exception&) {
+                ++result_.entrants[i].decisionErrors;
+                direction = "right";  // 与客户端库的默认处理一致
+            }
+            moves_[i] = snake_rules::parseMove(direction);
+        }
+    }
+
+    // 移动、碰撞、吃食物与无敌递减都由规则引擎完成；补充食物插在吃食物之后，
+    // 它只看存活蛇身与已有食物，与无敌递减的先后无关
+    void tick() {
+        rules_.step(moves_.data());
+        generateFood();
+
+        for (std::size_t i = 0; i < states_.size(); ++i) {
+            const int s = slot(i);
+            EntrantResult& r = result_.entrants[i];
+            if (rules_.deathCause(s) != snake_rules::DEATH_NONE) {
+                if (rules_.killer(s) >= 0) {
+                    ++result_.entrants[rules_.killer(s)].kills;
+                }
+                states_[i].respawnAt = round_ + 1 + options_.respawnDelayRounds;
+                ++r.deaths;
+            }
+            if (rules_.ate(s)) {
+                ++r.foods;
+            }
+            if (rules_.alive(s)) {
+                r.maxLength = std::max(r.maxLength, rules_.length(s));
+            }
+        }
+    }
+
+    void generateFood() {
+        const int totalCells = options_.width * options_.height;
+        const int target = static_cast<int>(totalCells * options_.foodDensity);
+        int toGenerate = target - rules_.foodCount();
+        if (toGenerate <= 0) {
+            return;
+        }
+        toGenerate = std::min(toGenerate, std::max(1, totalCells / 2));
+
+        // 避开所有存活蛇身与已有食物
+        std::uniform_int_distribution<int> distX(0, options_.width - 1);
+        std::uniform_int_distribution<int> distY(0, options_.height - 1);
+        for (int i = 0; i < toGenerate; ++i) {
+            for (int attempt = 0; attempt < 100; ++attempt) {
+                const Point candidate(distX(rng_), distY(rng_));
+                if (rules_.occupied(candidate.x, candidate.y) || rules_.hasFood(candidate.x, candidate.y)) {
+                    continue;
+                }
+                rules_.addFood(candidate.x, candidate.y);
+                break;
+            }
+        }
+    }
+
+    const ArenaOptions& options_;
+    const std::vector<ArenaEntrant>& entrants_;
+    std::mt19937_64 rng_;
+
+    std::vector<EntrantState> states_;
+    std::vector<Move> moves_;
+    snake_rules::RulesState rules_;
+    std::vector<Point> blocks_;   // decide() 构造视图时复用
+
+    GameState view_;
+    GameResult result_;
+    int round_ = 0;
+};
+
+}  // namespace
+
+GameResult runArenaGame(const ArenaOptions& options,
+                        const std::vector<ArenaEntrant>& entrants,
+                        std::uint64_t seed) {
+    for (const auto& entrant : entrants) {
+        if (entrant.reset) {
+            entrant.reset();
+        }
+    }
+    ArenaGame game(options, entrants, seed);
+    return game.run();
+}
+
+}  // namespace bot
@@ -0,0 +1,227 @@
+#include "arena/ArenaSimulator.hpp"
+#include "common/RolloutSearch.hpp"
+#include "strategies/GluttonStrategy.hpp"
+#include "strategies/InterceptorStrategy.hpp"
+#include "strategies/ParasiteStrategy.hpp"
+#include "strategies/PatrollerStrategy.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+// 单个策略在所有对局中的累计统计
+struct Aggregate {
+    long long games = 0;
+    long long wins = 0;
+    long long finalLength = 0;
+    long long maxLength = 0;
+    long long foods = 0;
+    long long kills = 0;
+    long long deaths = 0;
+    long long decisionErrors = 0;
+
+    void add(const bot::EntrantResult& r, bool won) {
+        ++games;
+        wins += won ? 1 : 0;
+        finalLength += r.finalLength;
+        maxLength += r.maxLength;
+        foods += r.foods;
+        kills += r.kills;
+        deaths += r.deaths;
+        decisionErrors += r.decisionErrors;
+    }
+
+    void merge(const Aggregate& o) {
+        games += o.games;
+        wins += o.wins;
+        finalLength += o.finalLength;
+        maxLength += o.maxLength;
+        foods += o.foods;
+        kills += o.kills;
+        deaths += o.deaths;
+        decisionErrors += o.decisionErrors;
+    }
+};
+
+// 蒙特卡洛推演搜索（不在默认参赛列表中）：固定推演次数、不限时，单线程运行时结果可复现
+std::string decideRollout(const GameState& state) {
+    thread_local bot::RolloutSearch search([] {
+        bot::RolloutOptions options;
+        options.budgetMs = 0;
+        options.maxIterations = 400;
+        return options;
+    }());
+    const bot::RolloutResult result = search.search(state);
+    return result.move == snake_rules::MOVE_NONE ? "right" : result.direction();
+}
+
+bool lookupStrategy(const std::string& name, bot::ArenaEntrant& out) {
+    if (name == "glutton") {
+        out = {name, bot::decideGlutton};
+    } else if (name == "interceptor") {
+        out = {name, bot::decideInterceptor};
+    } else if (name == "parasite") {
+        out = {name, bot::decideParasite, bot::resetParasiteState};
+    } else if (name == "patroller") {
+        out = {name, bot::decidePatroller, bot::resetPatrollerState};
+    } else if (name == "rollout") {
+        out = {name, decideRollout};
+    } else {
+        return false;
+    }
+    return true;
+}
+
+void printUsage() {
+    std::cerr <<
+        "用法: snake_arena_runner [选项]\n"
+        "  --games N          对局数（默认 1000）\n"
+        "  --rounds N         每局回合数（默认 500）\n"
+        "  --threads N        工作线程数（默认 CPU 核数）\n"
+        "  --seed N           起始种子，第 i 局使用 seed + i（默认 1）\n"
+        "  --width N          地图宽度（默认 50）\n"
+        "  --height N         地图高度（默认 50）\n"
+        "  --food-density X   食物密度（默认 0.01）\n"
+        "  --bots a,b,...     参赛策略：glutton/interceptor/parasite/patroller（默认全部）\n"
+        "                     以及 rollout（蒙特卡洛推演搜索，每步 400 次推演）\n";
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    bot::ArenaOptions options;
+    long long games = 1000;
+    std::uint64_t seed = 1;
+    unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+    std::string botList = "interceptor,glutton,patroller,parasite";
+
+    try {
+        for (int i = 1; i < argc; ++i) {
+            const std::string arg = argv[i];
+            if (arg == "--help" || arg == "-h") {
+                printUsage();
+                return 0;
+            }
+            if (i + 1 >= argc) {
+                std::cerr << "缺少参数值: " << arg << std::endl;
+                printUsage();
+                return 1;
+            }
+            const std::string value = argv[++i];
+            if (arg == "--games") {
+                games = std::stoll(value);
+            } else if (arg == "--rounds") {
+                options.rounds = std::stoi(value);
+            } else if (arg == "--threads") {
+                threads = static_cast<unsigned>(std::max(1, std::stoi(value)));
+            } else if (arg == "--seed") {
+                seed = std::stoull(value);
+            } else if (arg == "--width") {
+                options.width = std::stoi(value);
+            } else if (arg == "--height") {
+                options.height = std::stoi(value);
+            } else if (arg == "--food-density") {
+                options.foodDensity = std::stod(value);
+            } else if (arg == "--bots") {
+                botList = value;
+            } else {
+                std::cerr << "未知参数: " << arg << std::endl;
+                printUsage();
+                return 1;
+            }
+        }
+    } catch (const std::exception&) {
+        std::cerr << "参数格式错误" << std::endl;
+        printUsage();
+        return 1;
+    }
+
+    if (games <= 0 || options.rounds <= 0 || options.width < 10 || options.height < 10) {
+        std::cerr << "参数无效：对局数与回合数需为正数，地图边长至少为 10" << std::endl;
+        return 1;
+    }
+
+    std::vector<bot::ArenaEntrant> entrants;
+    std::stringstream names(botList);
+    std::string name;
+    while (std::getline(names, name, ',')) {
+        bot::ArenaEntrant entrant;
+        if (!lookupStrategy(name, entrant)) {
+            std::cerr << "未知策略: " << name << std::endl;
+            return 1;
+        }
+        entrants.push_back(entrant);
+    }
+    if (entrants.empty()) {
+        std::cerr << "至少需要一个参赛策略" << std::endl;
+        return 1;
+    }
+
+    // 每个工作线程领取对局编号并独立累计，结束后再合并，运行期间没有共享写入
+    std::atomic<long long> nextGame{0};
+    std::vector<std::vector<Aggregate>> perThread(threads, std::vector<Aggregate>(entrants.size()));
+    std::vector<long long> ties(threads, 0);
+
+    const auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> workers;
+    workers.reserve(threads);
+    for (unsigned t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t]() {
+            for (;;) {
+                const long long index = nextGame.fetch_add(1, std::memory_order_relaxed);
+                if (index >= games) {
+                    break;
+                }
+                const bot::GameResult result =
+                    bot::runArenaGame(options, entrants, seed + static_cast<std::uint64_t>(index));
+                for (std::size_t e = 0; e < entrants.size(); ++e) {
+                    perThread[t][e].add(result.entrants[e], result.winner == static_cast<int>(e));
+                }
+                if (result.winner < 0) {
+                    ++ties[t];
+                }
+            }
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::vector<Aggregate> totals(entrants.size());
+    long long tieCount = 0;
+    for (unsigned t = 0; t < threads; ++t) {
+        for (std::size_t e = 0; e < entrants.size(); ++e) {
+            totals[e].merge(perThread[t][e]);
+        }
+        tieCount += ties[t];
+    }
+
+    std::printf("对局 %lld 局 × %d 回合，地图 %dx%d，线程 %u，耗时 %.2f 秒\n",
+                games, options.rounds, options.width, options.height, threads, seconds);
+    std::printf("吞吐: %.1f 局/秒（%.0f 回合/秒），无胜者对局 %lld\n\n",
+                static_cast<double>(games) / seconds,
+                static_cast<double>(games) * options.rounds / seconds,
+                tieCount);
+    std::printf("%-12s %8s %8s %10s %10s %8s %8s %8s %8s\n",
+                "策略", "胜场", "胜率", "平均终长", "平均最长", "食物", "击杀", "死亡", "异常");
+    for (std::size_t e = 0; e < entrants.size(); ++e) {
+        const Aggregate& a = totals[e];
+        const double n = static_cast<double>(std::max(1LL, a.games));
+        std::printf("%-12s %8lld %7.1f%% %10.2f %10.2f %8.2f %8.2f %8.2f %8lld\n",
+                    entrants[e].name.c_str(), a.wins, 100.0 * a.wins / n,
+                    a.finalLength / n, a.maxLength / n,
+                    a.foods / n, a.kills / n, a.deaths / n, a.decisionErrors);
+    }
+    std::printf("\n（食物、击杀、死亡为每局平均值）\n");
+    return 0;
+}
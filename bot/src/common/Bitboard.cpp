@@ -0,0 +1,251 @@
+#include "common/Bitboard.hpp"
+
+#include <algorithm>
+#include <utility>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define BOT_BITBOARD_SSE2 1
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace bot {
+
+namespace {
+
+int popcount64(std::uint64_t bits) {
+#if defined(_MSC_VER)
+    return static_cast<int>(__popcnt64(bits));
+#else
+    return __builtin_popcountll(bits);
+#endif
+}
+
+// 单个字的四邻扩张：c 指向当前字，s 为每行字数
+inline std::uint64_t dilateWord(const std::uint64_t* c, std::uint64_t mask, std::ptrdiff_t s) {
+    const std::uint64_t neighbours = (c[0] << 1) | (c[-1] >> 63) |
+                                     (c[0] >> 1) | (c[1] << 63) |
+                                     c[-s] | c[s];
+    return c[0] | (mask & neighbours);
+}
+
+// 返回 [begin, n) 区间内是否有新增位
+bool dilateScalar(const std::uint64_t* c, const std::uint64_t* m, std::uint64_t* o,
+                  std::size_t begin, std::size_t n, std::ptrdiff_t s) {
+    std::uint64_t diff = 0;
+    for (std::size_t i = begin; i < n; ++i) {
+        const std::uint64_t v = dilateWord(c + i, m[i], s);
+        diff |= v ^ c[i];
+        o[i] = v;
+    }
+    return diff != 0;
+}
+
+#if defined(__AVX2__)
+
+bool dilateWords(const std::uint64_t* c, const std::uint64_t* m, std::uint64_t* o,
+                 std::size_t n, std::ptrdiff_t s) {
+    __m256i diff = _mm256_setzero_si256();
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        const __m256i cur = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(c + i));
+        const __m256i prev = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(c + i - 1));
+        const __m256i next = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(c + i + 1));
+        const __m256i up = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(c + i - s));
+        const __m256i down = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(c + i + s));
+        const __m256i mask = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(m + i));
+
+        __m256i nb = _mm256_or_si256(_mm256_slli_epi64(cur, 1), _mm256_srli_epi64(prev, 63));
+        nb = _mm256_or_si256(nb, _mm256_srli_epi64(cur, 1));
+        nb = _mm256_or_si256(nb, _mm256_slli_epi64(next, 63));
+        nb = _mm256_or_si256(nb, _mm256_or_si256(up, down));
+        const __m256i v = _mm256_or_si256(cur, _mm256_and_si256(mask, nb));
+
+        diff = _mm256_or_si256(diff, _mm256_xor_si256(v, cur));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(o + i), v);
+    }
+    const bool tail = dilateScalar(c, m, o, i, n, s);
+    return tail || !_mm256_testz_si256(diff, diff);
+}
+
+#elif defined(BOT_BITBOARD_SSE2)
+
+bool dilateWords(const std::uint64_t* c, const std::uint64_t* m, std::uint64_t* o,
+                 std::size_t n, std::ptrdiff_t s) {
+    __m128i diff = _mm_setzero_si128();
+    std::size_t i = 0;
+    for (; i + 2 <= n; i += 2) {
+        const __m128i cur = _mm_loadu_si128(reinterpret_cast<const __m128i*>(c + i));
+        const __m128i prev = _mm_loadu_si128(reinterpret_cast<const __m128i*>(c + i - 1));
+        const __m128i next = _mm_loadu_si128(reinterpret_cast<const __m128i*>(c + i + 1));
+        const __m128i up = _mm_loadu_si128(reinterpret_cast<const __m128i*>(c + i - s));
+        const __m128i down = _mm_loadu_si128(reinterpret_cast<const __m128i*>(c + i + s));
+        const __m128i mask = _mm_loadu_si128(reinterpret_cast<const __m128i*>(m + i));
+
+        __m128i nb = _mm_or_si128(_mm_slli_epi64(cur, 1), _mm_srli_epi64(prev, 63));
+        nb = _mm_or_si128(nb, _mm_srli_epi64(cur, 1));
+        nb = _mm_or_si128(nb, _mm_slli_epi64(next, 63));
+        nb = _mm_or_si128(nb, _mm_or_si128(up, down));
+        const __m128i v = _mm_or_si128(cur, _mm_and_si128(mask, nb));
+
+        diff = _mm_or_si128(diff, _mm_xor_si128(v, cur));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(o + i), v);
+    }
+    const bool tail = dilateScalar(c, m, o, i, n, s);
+    const __m128i zero = _mm_setzero_si128();
+    return tail || _mm_movemask_epi8(_mm_cmpeq_epi8(diff, zero)) != 0xFFFF;
+}
+
+#else
+
+bool dilateWords(const std::uint64_t* c, const std::uint64_t* m, std::uint64_t* o,
+                 std::size_t n, std::ptrdiff_t s) {
+    return dilateScalar(c, m, o, 0, n, s);
+}
+
+#endif
+
+}  // namespace
+
+int Bitboard::lowestBit(std::uint64_t bits) {
+#if defined(_MSC_VER)
+    unsigned long index = 0;
+    _BitScanForward64(&index, bits);
+    return static_cast<int>(index);
+#else
+    return __builtin_ctzll(bits);
+#endif
+}
+
+void Bitboard::resize(int width, int height) {
+    width_ = std::max(0, width);
+    height_ = std::max(0, height);
+    stride_ = width_ / 64 + 1;
+    words_.assign(static_cast<std::size_t>(height_ + 2) * stride_, 0);
+}
+
+void Bitboard::clear() {
+    std::fill(words_.begin(), words_.end(), 0);
+}
+
+bool Bitboard::test(int x, int y) const {
+    if (!inBounds(x, y)) {
+        return false;
+    }
+    return (rowWords(y)[x >> 6] >> (x & 63)) & 1u;
+}
+
+void Bitboard::set(int x, int y) {
+    if (inBounds(x, y)) {
+        rowWords(y)[x >> 6] |= std::uint64_t{1} << (x & 63);
+    }
+}
+
+void Bitboard::unset(int x, int y) {
+    if (inBounds(x, y)) {
+        rowWords(y)[x >> 6] &= ~(std::uint64_t{1} << (x & 63));
+    }
+}
+
+int Bitboard::count() const {
+    int total = 0;
+    for (std::uint64_t w : words_) {
+        total += popcount64(w);
+    }
+    return total;
+}
+
+bool Bitboard::empty() const {
+    for (std::uint64_t w : words_) {
+        if (w != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+Bitboard& Bitboard::operator|=(const Bitboard& other) {
+    const std::size_t n = std::min(words_.size(), other.words_.size());
+    for (std::size_t i = 0; i < n; ++i) {
+        words_[i] |= other.words_[i];
+    }
+    return *this;
+}
+
+Bitboard& Bitboard::operator&=(const Bitboard& other) {
+    const std::size_t n = std::min(words_.size(), other.words_.size());
+    for (std::size_t i = 0; i < n; ++i) {
+        words_[i] &= other.words_[i];
+    }
+    return *this;
+}
+
+void Bitboard::andNot(const Bitboard& other) {
+    const std::size_t n = std::min(words_.size(), other.words_.size());
+    for (std::size_t i = 0; i < n; ++i) {
+        words_[i] &= ~other.words_[i];
+    }
+}
+
+bool Bitboard::operator==(const Bitboard& other) const {
+    return width_ == other.width_ && height_ == other.height_ && words_ == other.words_;
+}
+
+void Bitboard::assignFreeCells(const GameState& state) {
+    if (width_ != state.getMapWidth() || height_ != state.getMapHeight()) {
+        resize(state.getMapWidth(), state.getMapHeight());
+    }
+    for (int y = 0; y < height_; ++y) {
+        std::uint64_t* row = rowWords(y);
+        for (int w = 0; w < stride_; ++w) {
+            std::uint64_t bits = 0;
+            const int x0 = w * 64;
+            const int x1 = std::min(width_, x0 + 64);
+            for (int x = x0; x < x1; ++x) {
+                if (!state.hasObstacle(x, y)) {
+                    bits |= std::uint64_t{1} << (x - x0);
+                }
+            }
+            row[w] = bits;
+        }
+    }
+}
+
+bool Bitboard::dilate(const Bitboard& mask, Bitboard& out) const {
+    if (out.width_ != width_ || out.height_ != height_) {
+        out.resize(width_, height_);
+    }
+    if (dataWords() == 0 || mask.width_ != width_ || mask.height_ != height_) {
+        out.words_ = words_;
+        return false;
+    }
+    return dilateWords(data(), mask.data(), out.data(), dataWords(), stride_);
+}
+
+int floodFill(const Bitboard& passable, const Point& seed, Bitboard& region, Bitboard& scratch,
+              int maxSteps) {
+    if (region.width() != passable.width() || region.height() != passable.height()) {
+        region.resize(passable.width(), passable.height());
+    } else {
+        region.clear();
+    }
+    if (!passable.inBounds(seed.x, seed.y)) {
+        return 0;
+    }
+    region.set(seed);
+
+    for (int step = 0; step < maxSteps; ++step) {
+        if (!region.dilate(passable, scratch)) {
+            break;
+        }
+        std::swap(region, scratch);
+    }
+    return region.count();
+}
+
+}  // namespace bot
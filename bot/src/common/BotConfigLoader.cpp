@@ -74,4 +74,29 @@ std::string getConfigValue(
     return fallback;
 }
 
+std::vector<std::string> getConfigList(
+    const std::unordered_map<std::string, std::string>& config,
+    const std::string& key,
+    const char* envKey,
+    const std::string& fallback
+) {
+    std::vector<std::string> items;
+    const std::string value = getConfigValue(config, key, envKey, fallback);
+
+    std::size_t start = 0;
+    while (start <= value.size()) {
+        std::size_t end = value.find(',', start);
+        if (end == std::string::npos) {
+            end = value.size();
+        }
+        const std::string item = trim(value.substr(start, end - start));
+        if (!item.empty()) {
+            items.push_back(item);
+        }
+        start = end + 1;
+    }
+
+    return items;
+}
+
 }  // namespace bot
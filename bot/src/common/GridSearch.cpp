@@ -0,0 +1,322 @@
+#include "common/GridSearch.hpp"
+
+#include "common/DirectionUtils.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+
+namespace bot {
+
+namespace {
+
+// 与 allDirections() 顺序一致：up, down, left, right
+const int kDx[4] = {0, 0, -1, 1};
+const int kDy[4] = {-1, 1, 0, 0};
+
+// 堆比较：返回 true 表示 a 的优先级低于 b
+bool lowerPriority(int fa, int ga, int ca, int fb, int gb, int cb) {
+    if (fa != fb) {
+        return fa > fb;
+    }
+    if (ga != gb) {
+        return ga < gb;
+    }
+    return ca > cb;
+}
+
+}  // namespace
+
+void GridSearch::Frontier::reserve(std::size_t capacity) {
+    if (buffer_.size() < capacity) {
+        buffer_.resize(capacity);
+    }
+    clear();
+}
+
+void GridSearch::Frontier::push(int cell) {
+    std::size_t tail = head_ + size_;
+    if (tail >= buffer_.size()) {
+        tail -= buffer_.size();
+    }
+    buffer_[tail] = cell;
+    ++size_;
+}
+
+int GridSearch::Frontier::pop() {
+    const int cell = buffer_[head_];
+    if (++head_ == buffer_.size()) {
+        head_ = 0;
+    }
+    --size_;
+    return cell;
+}
+
+void GridSearch::bind(const GameState& state) {
+    width_ = std::max(0, state.getMapWidth());
+    height_ = std::max(0, state.getMapHeight());
+    const std::size_t cells = static_cast<std::size_t>(width_) * height_;
+
+    if (blocked_.size() != cells) {
+        blocked_.assign(cells, 0);
+        stamp_.assign(cells, 0);
+        distance_.assign(cells, kUnreached);
+        parent_.assign(cells, -1);
+        frontier_.reserve(cells);
+        heap_.reserve(cells);
+        epoch_ = 0;
+    }
+
+    std::size_t i = 0;
+    for (int y = 0; y < height_; ++y) {
+        for (int x = 0; x < width_; ++x) {
+            blocked_[i++] = state.hasObstacle(x, y) ? 1 : 0;
+        }
+    }
+}
+
+void GridSearch::setBlocked(const Point& p, bool blocked) {
+    if (inBounds(p)) {
+        blocked_[cellOf(p)] = blocked ? 1 : 0;
+    }
+}
+
+bool GridSearch::isBlocked(const Point& p) const {
+    return !inBounds(p) || blocked_[cellOf(p)] != 0;
+}
+
+void GridSearch::nextEpoch() {
+    // 回绕时整体清零一次，之后继续使用时间戳
+    if (++epoch_ == 0) {
+        std::fill(stamp_.begin(), stamp_.end(), 0);
+        epoch_ = 1;
+    }
+    frontier_.clear();
+}
+
+void GridSearch::visit(int cell, int distance, int parent) {
+    stamp_[cell] = epoch_;
+    distance_[cell] = distance;
+    parent_[cell] = parent;
+}
+
+int GridSearch::bfsFromFrontier(int maxDepth) {
+    int reached = 0;
+    while (!frontier_.empty()) {
+        const int cur = frontier_.pop();
+        const int dist = distance_[cur];
+        if (dist >= maxDepth) {
+            continue;
+        }
+        const int cx = cur % width_;
+        const int cy = cur / width_;
+        for (int d = 0; d < 4; ++d) {
+            const int nx = cx + kDx[d];
+            const int ny = cy + kDy[d];
+            if (nx < 0 || nx >= width_ || ny < 0 || ny >= height_) {
+                continue;
+            }
+            const int next = ny * width_ + nx;
+            if (visited(next) || blocked_[next] != 0) {
+                continue;
+            }
+            visit(next, dist + 1, cur);
+            frontier_.push(next);
+            ++reached;
+        }
+    }
+    return reached;
+}
+
+int GridSearch::bfs(const Point& source, int maxDepth) {
+    nextEpoch();
+    if (!inBounds(source)) {
+        return 0;
+    }
+    const int start = cellOf(source);
+    visit(start, 0, start);
+    frontier_.push(start);
+    return 1 + bfsFromFrontier(maxDepth);
+}
+
+int GridSearch::bfs(const std::vector<Point>& sources, int maxDepth) {
+    nextEpoch();
+    int reached = 0;
+    for (const auto& source : sources) {
+        if (!inBounds(source)) {
+            continue;
+        }
+        const int cell = cellOf(source);
+        if (visited(cell)) {
+            continue;
+        }
+        visit(cell, 0, cell);
+        frontier_.push(cell);
+        ++reached;
+    }
+    return reached + bfsFromFrontier(maxDepth);
+}
+
+int GridSearch::distanceAt(const Point& p) const {
+    if (!inBounds(p)) {
+        return kUnreached;
+    }
+    const int cell = cellOf(p);
+    return visited(cell) ? distance_[cell] : kUnreached;
+}
+
+std::string GridSearch::directionFromParents(int start, int target) const {
+    // 沿父指针回溯到起点的下一格
+    int cur = target;
+    while (parent_[cur] != start) {
+        cur = parent_[cur];
+    }
+    const int dx = cur % width_ - start % width_;
+    const int dy = cur / width_ - start / width_;
+    for (int d = 0; d < 4; ++d) {
+        if (kDx[d] == dx && kDy[d] == dy) {
+            return allDirections()[d];
+        }
+    }
+    return "";
+}
+
+std::string GridSearch::firstStep(const Point& start, const Point& target) {
+    nextEpoch();
+    if (!inBounds(start) || !inBounds(target) || start == target) {
+        return "";
+    }
+
+    const int from = cellOf(start);
+    const int goal = cellOf(target);
+    visit(from, 0, from);
+    frontier_.push(from);
+
+    while (!frontier_.empty()) {
+        const int cur = frontier_.pop();
+        const int cx = cur % width_;
+        const int cy = cur / width_;
+        for (int d = 0; d < 4; ++d) {
+            const int nx = cx + kDx[d];
+            const int ny = cy + kDy[d];
+            if (nx < 0 || nx >= width_ || ny < 0 || ny >= height_) {
+                continue;
+            }
+            const int next = ny * width_ + nx;
+            // 目标点允许被当作可进入节点，避免永远不可达
+            if (next != goal && blocked_[next] != 0) {
+                continue;
+            }
+            if (visited(next)) {
+                continue;
+            }
+            visit(next, distance_[cur] + 1, cur);
+            if (next == goal) {
+                return directionFromParents(from, goal);
+            }
+            frontier_.push(next);
+        }
+    }
+    return "";
+}
+
+int GridSearch::aStar(const Point& start, const Point& target, std::string* firstStep) {
+    if (firstStep != nullptr) {
+        firstStep->clear();
+    }
+    nextEpoch();
+    if (!inBounds(start) || !inBounds(target)) {
+        return kUnreached;
+    }
+    if (start == target) {
+        return 0;
+    }
+
+    const int from = cellOf(start);
+    const int goal = cellOf(target);
+    auto heuristic = [&](int x, int y) {
+        return std::abs(x - target.x) + std::abs(y - target.y);
+    };
+    auto cmp = [](const HeapNode& a, const HeapNode& b) {
+        return lowerPriority(a.f, a.g, a.cell, b.f, b.g, b.cell);
+    };
+
+    heap_.clear();
+    visit(from, 0, from);
+    heap_.push_back({heuristic(start.x, start.y), 0, from});
+
+    while (!heap_.empty()) {
+        std::pop_heap(heap_.begin(), heap_.end(), cmp);
+        const HeapNode node = heap_.back();
+        heap_.pop_back();
+
+        // 懒删除：同一格被更短路径重新入堆后，旧节点直接跳过
+        if (node.g > distance_[node.cell]) {
+            continue;
+        }
+        if (node.cell == goal) {
+            if (firstStep != nullptr) {
+                *firstStep = directionFromParents(from, goal);
+            }
+            return node.g;
+        }
+
+        const int cx = node.cell % width_;
+        const int cy = node.cell / width_;
+        const int g = node.g + 1;
+        for (int d = 0; d < 4; ++d) {
+            const int nx = cx + kDx[d];
+            const int ny = cy + kDy[d];
+            if (nx < 0 || nx >= width_ || ny < 0 || ny >= height_) {
+                continue;
+            }
+            const int next = ny * width_ + nx;
+            if (next != goal && blocked_[next] != 0) {
+                continue;
+            }
+            if (visited(next) && distance_[next] <= g) {
+                continue;
+            }
+            visit(next, g, node.cell);
+            heap_.push_back({g + heuristic(nx, ny), g, next});
+            std::push_heap(heap_.begin(), heap_.end(), cmp);
+        }
+    }
+    return kUnreached;
+}
+
+int GridSearch::reachableArea(const Point& start, int limit) {
+    nextEpoch();
+    if (!inBounds(start) || limit <= 0) {
+        return 0;
+    }
+
+    const int from = cellOf(start);
+    visit(from, 0, from);
+    frontier_.push(from);
+
+    int count = 0;
+    while (!frontier_.empty()) {
+        const int cur = frontier_.pop();
+        const int cx = cur % width_;
+        const int cy = cur / width_;
+        for (int d = 0; d < 4; ++d) {
+            const int nx = cx + kDx[d];
+            const int ny = cy + kDy[d];
+            if (nx < 0 || nx >= width_ || ny < 0 || ny >= height_) {
+                continue;
+            }
+            const int next = ny * width_ + nx;
+            if (visited(next) || blocked_[next] != 0) {
+                continue;
+            }
+            visit(next, distance_[cur] + 1, cur);
+            if (++count >= limit) {
+                return limit;
+            }
+            frontier_.push(next);
+        }
+    }
+    return count;
+}
+
+}  // namespace bot
@@ -0,0 +1,383 @@
+#include "common/RolloutSearch.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+namespace bot {
+
+namespace {
+
+using snake_rules::Cell;
+using snake_rules::Move;
+using snake_rules::RulesState;
+
+const Move kMoves[4] = {snake_rules::MOVE_UP, snake_rules::MOVE_DOWN,
+                        snake_rules::MOVE_LEFT, snake_rules::MOVE_RIGHT};
+
+// greedyFoodPlayout 只在蛇头附近找食物，避免每步扫描整张地图
+constexpr int kFoodScanRadius = 8;
+
+bool isLegal(Move heading, Move m) {
+    return heading == snake_rules::MOVE_NONE || !snake_rules::isOpposite(heading, m);
+}
+
+bool isSafe(const RulesState& rules, const Cell& c) {
+    return rules.inBounds(c.x, c.y) && !rules.occupied(c.x, c.y);
+}
+
+// 收集安全的非反向走法，返回个数
+int safeMoves(const RulesState& rules, int slot, Move out[4]) {
+    const Move heading = rules.direction(slot);
+    const Cell head = rules.head(slot);
+    int n = 0;
+    for (Move m : kMoves) {
+        if (isLegal(heading, m) && isSafe(rules, snake_rules::advance(head, m))) {
+            out[n++] = m;
+        }
+    }
+    return n;
+}
+
+Move anyLegalMove(const RulesState& rules, int slot, std::uint64_t& rng) {
+    const Move heading = rules.direction(slot);
+    Move legal[4];
+    int n = 0;
+    for (Move m : kMoves) {
+        if (isLegal(heading, m)) {
+            legal[n++] = m;
+        }
+    }
+    return legal[nextRandom(rng) % n];
+}
+
+// 按曼哈顿距离由近到远逐圈查找食物
+bool nearestFood(const RulesState& rules, const Cell& from, Cell& out) {
+    if (rules.foodCount() == 0) {
+        return false;
+    }
+    for (int r = 1; r <= kFoodScanRadius; ++r) {
+        for (int dx = -r; dx <= r; ++dx) {
+            const int dy = r - std::abs(dx);
+            if (rules.hasFood(from.x + dx, from.y + dy)) {
+                out = Cell(from.x + dx, from.y + dy);
+                return true;
+            }
+            if (dy != 0 && rules.hasFood(from.x + dx, from.y - dy)) {
+                out = Cell(from.x + dx, from.y - dy);
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+int manhattan(const Cell& a, const Cell& b) {
+    return std::abs(a.x - b.x) + std::abs(a.y - b.y);
+}
+
+}  // namespace
+
+Move randomSafePlayout(const RulesState& rules, int slot, std::uint64_t& rng) {
+    Move safe[4];
+    const int n = safeMoves(rules, slot, safe);
+    if (n == 0) {
+        return anyLegalMove(rules, slot, rng);
+    }
+    return safe[nextRandom(rng) % n];
+}
+
+Move greedyFoodPlayout(const RulesState& rules, int slot, std::uint64_t& rng) {
+    Move safe[4];
+    const int n = safeMoves(rules, slot, safe);
+    if (n == 0) {
+        return anyLegalMove(rules, slot, rng);
+    }
+    const std::uint64_t roll = nextRandom(rng);
+    const Cell head = rules.head(slot);
+    Cell food;
+    if ((roll & 7) == 0 || !nearestFood(rules, head, food)) {
+        return safe[(roll >> 3) % n];
+    }
+
+    // 距离相同的走法之间随机取舍，避免所有蛇沿同一轴线行进
+    Move best = safe[0];
+    int bestDist = manhattan(snake_rules::advance(head, best), food);
+    int ties = 1;
+    for (int i = 1; i < n; ++i) {
+        const int dist = manhattan(snake_rules::advance(head, safe[i]), food);
+        if (dist < bestDist) {
+            best = safe[i];
+            bestDist = dist;
+            ties = 1;
+        } else if (dist == bestDist && nextRandom(rng) % ++ties == 0) {
+            best = safe[i];
+        }
+    }
+    return best;
+}
+
+void loadGameState(const RulesState& rules, int slot, GameState& view) {
+    thread_local std::vector<Point> blocks;
+    view.setMapSize(rules.width(), rules.height());
+    view.setCurrentRound(rules.round());
+    view.setMyId("s" + std::to_string(slot));
+    view.clearPlayers();
+    for (int s = 0; s < rules.maxSnakes(); ++s) {
+        if (!rules.alive(s)) {
+            continue;
+        }
+        blocks.clear();
+        for (int k = 0; k < rules.length(s); ++k) {
+            const Cell b = rules.block(s, k);
+            blocks.push_back(Point(b.x, b.y));
+        }
+        Snake snake;
+        snake.id = "s" + std::to_string(s);
+        snake.name = snake.id;
+        snake.head = blocks.front();
+        snake.blocks.assign(blocks.begin(), blocks.end());
+        snake.length = rules.length(s);
+        snake.invincible_rounds = rules.invincibleRounds(s);
+        view.addOrUpdatePlayer(snake);
+    }
+    view.clearFoods();
+    rules.forEachFood([&view](int x, int y) { view.addFood(Point(x, y)); });
+}
+
+RolloutSearch::RolloutSearch(const RolloutOptions& options)
+    : options_(options) {
+    options_.threads = std::max(1, options_.threads);
+    options_.depth = std::max(1, options_.depth);
+    options_.maxNodes = std::max(1, options_.maxNodes);
+    if (options_.budgetMs <= 0 && options_.maxIterations <= 0) {
+        options_.maxIterations = 1;  // 既不限时也不限次数时至少推演一次，避免死循环
+    }
+
+    for (int i = 0; i < options_.threads; ++i) {
+        workers_.emplace_back(new Worker());
+        workers_.back()->nodes.resize(options_.maxNodes);
+    }
+    for (int i = 1; i < options_.threads; ++i) {
+        helpers_.emplace_back(&RolloutSearch::helperLoop, this, i);
+    }
+}
+
+RolloutSearch::~RolloutSearch() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    wake_.notify_all();
+    for (auto& helper : helpers_) {
+        helper.join();
+    }
+}
+
+void RolloutSearch::setBudgetMs(int budgetMs) {
+    options_.budgetMs = budgetMs;
+    if (options_.budgetMs <= 0 && options_.maxIterations <= 0) {
+        options_.maxIterations = 1;
+    }
+}
+
+RolloutResult RolloutSearch::search(const GameState& state) {
+    const int slot = loadRules(state, loaded_, slotIds_, options_.depth + 8);
+    if (slot < 0 || !loaded_.alive(slot)) {
+        return RolloutResult();
+    }
+    return search(loaded_, slot);
+}
+
+RolloutResult RolloutSearch::search(const RulesState& root, int slot) {
+    RolloutResult result;
+    if (slot < 0 || slot >= root.maxSnakes() || !root.alive(slot)) {
+        return result;
+    }
+
+    root_ = &root;
+    slot_ = slot;
+    rootSize_ = root.length(slot) + root.growthPending(slot);
+    deadline_ = std::chrono::steady_clock::now() + std::chrono::milliseconds(std::max(0, options_.budgetMs));
+    remaining_.store(options_.maxIterations, std::memory_order_relaxed);
+    iterations_.store(0, std::memory_order_relaxed);
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ++generation_;
+        running_ = static_cast<int>(helpers_.size());
+    }
+    wake_.notify_all();
+    runWorker(*workers_[0], 0);
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        done_.wait(lock, [this]() { return running_ == 0; });
+    }
+
+    // 合并各线程根节点的统计
+    std::array<double, 5> total{};
+    for (const auto& worker : workers_) {
+        result.nodes += worker->nodeCount;
+        const Node& rootNode = worker->nodes[0];
+        for (int i = 0; i < 4; ++i) {
+            const int child = rootNode.children[i];
+            if (child >= 0) {
+                result.visits[kMoves[i]] += worker->nodes[child].visits;
+                total[kMoves[i]] += worker->nodes[child].total;
+            }
+        }
+    }
+    result.iterations = iterations_.load(std::memory_order_relaxed);
+
+    int bestVisits = 0;
+    for (Move m : kMoves) {
+        if (result.visits[m] == 0) {
+            continue;
+        }
+        result.value[m] = total[m] / result.visits[m];
+        if (result.visits[m] > bestVisits ||
+            (result.visits[m] == bestVisits && result.value[m] > result.value[result.move])) {
+            bestVisits = result.visits[m];
+            result.move = m;
+        }
+    }
+    if (result.move == snake_rules::MOVE_NONE) {
+        // 预算过小，一次推演都没完成：退化为推演走法
+        std::uint64_t rng = options_.seed;
+        result.move = options_.selfPolicy(root, slot, rng);
+    }
+    root_ = nullptr;
+    return result;
+}
+
+void RolloutSearch::helperLoop(int index) {
+    std::uint64_t seen = 0;
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            wake_.wait(lock, [&]() { return stopping_ || generation_ != seen; });
+            if (stopping_) {
+                return;
+            }
+            seen = generation_;
+        }
+        runWorker(*workers_[index], index);
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            --running_;
+        }
+        done_.notify_one();
+    }
+}
+
+void RolloutSearch::runWorker(Worker& worker, int index) {
+    // 种子由配置、回合号与线程下标决定，同一局面重复搜索结果一致
+    worker.rng = options_.seed ^
+                 (static_cast<std::uint64_t>(root_->round() + 1) * 0x9E3779B97F4A7C15ULL) ^
+                 (static_cast<std::uint64_t>(index + 1) * 0xD1B54A32D192ED03ULL);
+    worker.nodeCount = 0;
+    worker.moves.assign(root_->maxSnakes(), snake_rules::MOVE_NONE);
+    newNode(worker, root_->direction(slot_));
+
+    while (!shouldStop()) {
+        iterate(worker);
+        iterations_.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+bool RolloutSearch::shouldStop() {
+    if (options_.maxIterations > 0 && remaining_.fetch_sub(1, std::memory_order_relaxed) <= 0) {
+        return true;
+    }
+    return options_.budgetMs > 0 && std::chrono::steady_clock::now() >= deadline_;
+}
+
+int RolloutSearch::newNode(Worker& worker, Move heading) {
+    if (worker.nodeCount >= static_cast<int>(worker.nodes.size())) {
+        return -1;
+    }
+    Node& node = worker.nodes[worker.nodeCount];
+    std::fill(node.children, node.children + 4, -1);
+    node.visits = 0;
+    node.total = 0.0;
+    node.heading = heading;
+    return worker.nodeCount++;
+}
+
+void RolloutSearch::iterate(Worker& worker) {
+    RulesState& sim = worker.sim;
+    sim = *root_;  // 形状相同，复制不分配内存
+    worker.path.assign(1, 0);
+
+    int node = 0;
+    bool inTree = true;
+    int depth = 0;
+    while (depth < options_.depth && sim.alive(slot_)) {
+        Move mine = snake_rules::MOVE_NONE;
+        if (inTree) {
+            // 先随机展开一个未尝试的合法走法；全部展开后按 UCB1 选择
+            const Node& cur = worker.nodes[node];
+            Move untried[4];
+            int untriedCount = 0;
+            for (int i = 0; i < 4; ++i) {
+                if (cur.children[i] < 0 && isLegal(cur.heading, kMoves[i])) {
+                    untried[untriedCount++] = kMoves[i];
+                }
+            }
+            if (untriedCount > 0) {
+                mine = untried[nextRandom(worker.rng) % untriedCount];
+                const int child = newNode(worker, mine);
+                if (child >= 0) {
+                    worker.nodes[node].children[mine - 1] = child;
+                    worker.path.push_back(child);
+                }
+                inTree = false;  // 新节点之后进入模拟；节点池耗尽时也直接模拟
+            } else {
+                const double logN = std::log(static_cast<double>(std::max(1, cur.visits)));
+                double bestScore = -1.0;
+                int bestChild = -1;
+                for (int i = 0; i < 4; ++i) {
+                    const int child = cur.children[i];
+                    if (child < 0) {
+                        continue;
+                    }
+                    const Node& c = worker.nodes[child];
+                    const double score = c.total / c.visits +
+                                         options_.exploration * std::sqrt(logN / c.visits);
+                    if (score > bestScore) {
+                        bestScore = score;
+                        bestChild = child;
+                        mine = kMoves[i];
+                    }
+                }
+                node = bestChild;
+                worker.path.push_back(node);
+            }
+        } else {
+            mine = options_.selfPolicy(sim, slot_, worker.rng);
+        }
+
+        for (int s = 0; s < sim.maxSnakes(); ++s) {
+            worker.moves[s] = (s == slot_ || !sim.alive(s))
+                                  ? snake_rules::MOVE_NONE
+                                  : options_.opponentPolicy(sim, s, worker.rng);
+        }
+        worker.moves[slot_] = mine;
+        sim.step(worker.moves.data());
+        ++depth;
+    }
+
+    double value;
+    if (sim.alive(slot_)) {
+        const int gained = sim.length(slot_) + sim.growthPending(slot_) - rootSize_;
+        value = 0.6 + 0.4 * std::min(1.0, std::max(0, gained) / 4.0);
+    } else {
+        value = 0.5 * (depth - 1) / options_.depth;
+    }
+    for (int index : worker.path) {
+        ++worker.nodes[index].visits;
+        worker.nodes[index].total += value;
+    }
+}
+
+}  // namespace bot
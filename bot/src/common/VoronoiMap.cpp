@@ -0,0 +1,146 @@
+#include "common/VoronoiMap.hpp"
+
+#include <algorithm>
+
+namespace bot {
+
+namespace {
+
+// 与 allDirections() 顺序一致：up, down, left, right
+const int kDx[4] = {0, 0, -1, 1};
+const int kDy[4] = {-1, 1, 0, 0};
+
+}  // namespace
+
+void VoronoiMap::resize(int width, int height) {
+    width_ = width;
+    height_ = height;
+    const std::size_t cells = static_cast<std::size_t>(width_) * height_;
+    stamp_.assign(cells, 0);
+    distance_.assign(cells, kUnreached);
+    owner_.assign(cells, kNoOwner);
+    queue_.assign(cells, 0);
+    epoch_ = 0;
+}
+
+void VoronoiMap::compute(const GameState& state) {
+    const int width = std::max(0, state.getMapWidth());
+    const int height = std::max(0, state.getMapHeight());
+    if (width != width_ || height != height_) {
+        resize(width, height);
+    }
+    // 时间戳回绕时整体清零一次
+    if (++epoch_ == 0) {
+        std::fill(stamp_.begin(), stamp_.end(), 0);
+        epoch_ = 1;
+    }
+
+    players_.clear();
+    for (const auto& entry : state.getPlayerMap()) {
+        players_.push_back(&entry.second);
+    }
+    const std::size_t n = players_.size();
+    territory_.assign(n, 0);
+    if (foods_.size() < n) {
+        foods_.resize(n);
+    }
+    for (auto& list : foods_) {
+        list.clear();
+    }
+    contested_.clear();
+
+    // 所有蛇头作为第 0 层；两条蛇头重叠（无敌穿身）时该格直接为平局
+    std::size_t head = 0;
+    std::size_t tail = 0;
+    for (std::size_t i = 0; i < n; ++i) {
+        const Point& start = players_[i]->head;
+        if (!inBounds(start)) {
+            continue;
+        }
+        const int cell = cellOf(start);
+        if (visited(cell)) {
+            if (owner_[cell] != static_cast<int>(i)) {
+                owner_[cell] = kTie;
+            }
+            continue;
+        }
+        stamp_[cell] = epoch_;
+        distance_[cell] = 0;
+        owner_[cell] = static_cast<int>(i);
+        queue_[tail++] = cell;
+    }
+
+    while (head < tail) {
+        const int cur = queue_[head++];
+        const int dist = distance_[cur] + 1;
+        const int owner = owner_[cur];
+        const int cx = cur % width_;
+        const int cy = cur / width_;
+        for (int d = 0; d < 4; ++d) {
+            const int nx = cx + kDx[d];
+            const int ny = cy + kDy[d];
+            if (nx < 0 || nx >= width_ || ny < 0 || ny >= height_) {
+                continue;
+            }
+            const int next = ny * width_ + nx;
+            if (visited(next)) {
+                // 同层再次到达且归属不同：该格有多条最近的蛇
+                if (distance_[next] == dist && owner_[next] != owner) {
+                    owner_[next] = kTie;
+                }
+                continue;
+            }
+            if (state.hasObstacle(nx, ny)) {
+                continue;
+            }
+            stamp_[next] = epoch_;
+            distance_[next] = dist;
+            owner_[next] = owner;
+            queue_[tail++] = next;
+        }
+    }
+
+    // 队列中恰好是本次到达的全部格子
+    for (std::size_t i = 0; i < tail; ++i) {
+        const int cell = queue_[i];
+        if (owner_[cell] >= 0 && distance_[cell] > 0) {
+            ++territory_[owner_[cell]];
+        }
+    }
+
+    for (const auto& food : state.getFoodSet()) {
+        const int owner = ownerAt(food);
+        if (owner >= 0) {
+            foods_[owner].push_back(food);
+        } else if (owner == kTie) {
+            contested_.push_back(food);
+        }
+    }
+}
+
+int VoronoiMap::indexOf(const std::string& id) const {
+    for (std::size_t i = 0; i < players_.size(); ++i) {
+        if (players_[i]->id == id) {
+            return static_cast<int>(i);
+        }
+    }
+    return -1;
+}
+
+int VoronoiMap::ownerAt(const Point& p) const {
+    if (!inBounds(p)) {
+        return kNoOwner;
+    }
+    const int cell = cellOf(p);
+    return visited(cell) ? owner_[cell] : kNoOwner;
+}
+
+int VoronoiMap::distanceAt(const Point& p) const {
+    if (!inBounds(p)) {
+        return kUnreached;
+    }
+    const int cell = cellOf(p);
+    return visited(cell) ? distance_[cell] : kUnreached;
+}
+
+}  // namespace bot
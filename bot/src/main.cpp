@@ -4,10 +4,13 @@
 #include "strategies/InterceptorStrategy.hpp"
 #include "strategies/ParasiteStrategy.hpp"
 #include "strategies/PatrollerStrategy.hpp"
+#include "strategies/RolloutStrategy.hpp"
 
+#include <algorithm>
+#include <cstdlib>
+#include <functional>
 #include <iostream>
 #include <string>
-#include <thread>
 #include <unordered_map>
 #include <vector>
 
@@ -19,22 +22,30 @@ struct BotConfig {
     std::string uid;
     std::string paste;
     std::string name;
-    std::string (*decide)(const GameState&);
+    std::function<std::string(const GameState&)> decide;
 };
 
-void runOneBot(const std::string& endpoint, const BotConfig& config) {
+// 解析推演预算占回合时长的比例；无效值回退到默认
+double parseBudgetShare(const std::string& value) {
+    char* end = nullptr;
+    const double share = std::strtod(value.c_str(), &end);
+    if (end == value.c_str() || *end != '\0' || !(share > 0.0 && share <= 1.0)) {
+        std::cerr << "rollout.budget_share 无效（需在 (0, 1] 内）: " << value << "，使用 0.5" << std::endl;
+        return 0.5;
+    }
+    return share;
+}
+
+bool addToFleet(SnakeFleet& fleet, const BotConfig& config) {
     try {
-        CodingSnake game(endpoint);
-        game.login(config.uid, config.paste);
-        game.join(config.name, config.color);
-        game.run(config.decide);
+        fleet.addBot(config.uid, config.paste, config.name, config.color, config.decide);
+        return true;
     } catch (const SnakeException& e) {
-        std::cerr << "[" << config.role << "] 运行异常: " << e.what() << std::endl;
+        std::cerr << "[" << config.role << "] 加入失败: " << e.what() << std::endl;
     } catch (const std::exception& e) {
         std::cerr << "[" << config.role << "] 标准异常: " << e.what() << std::endl;
-    } catch (...) {
-        std::cerr << "[" << config.role << "] 未知异常" << std::endl;
     }
+    return false;
 }
 
 }  // namespace
@@ -52,8 +63,23 @@ int main() {
         "http://127.0.0.1:18080"
     );
 
+    // 要启动的角色；rollout（推演者）每回合占用较多 CPU，默认不启动
+    const std::vector<std::string> roles = bot::getConfigList(
+        config,
+        "roles",
+        "CS_ROLES",
+        "interceptor,glutton,patroller,parasite"
+    );
+
+    // 推演者的时间预算按服务器回合时长换算，回合时长在首个 Bot 加入时取得
+    const double rolloutShare = parseBudgetShare(bot::getConfigValue(
+        config, "rollout.budget_share", "CS_ROLLOUT_BUDGET_SHARE", "0.5"));
+
+    // 所有 Bot 共用一个循环：每回合一次增量长轮询 + 一次批量移动提交
+    SnakeFleet fleet(endpoint);
+
     // 参数优先级：配置文件 > 环境变量 > 默认值
-    std::vector<BotConfig> bots = {
+    const std::vector<BotConfig> available = {
         {
             "interceptor",
             "#FF0000",
@@ -86,24 +112,48 @@ int main() {
             bot::getConfigValue(config, "parasite.name", "CS_PARASITE_NAME", "parasite"),
             bot::decideParasite,
         },
+        {
+            "rollout",
+            "#00C000",
+            bot::getConfigValue(config, "rollout.uid", "CS_ROLLOUT_UID", "rollout"),
+            bot::getConfigValue(config, "rollout.paste", "CS_ROLLOUT_PASTE", "paste_here"),
+            bot::getConfigValue(config, "rollout.name", "CS_ROLLOUT_NAME", "rollout"),
+            [&fleet, rolloutShare](const GameState& state) {
+                return bot::decideRollout(state, bot::rolloutBudgetMs(fleet.roundTimeMs(), rolloutShare));
+            },
+        },
     };
 
-    std::cout << "启动 4 个 Bot，目标服务器: " << endpoint << std::endl;
+    std::vector<BotConfig> bots;
+    for (const auto& role : roles) {
+        const auto it = std::find_if(available.begin(), available.end(),
+                                     [&role](const BotConfig& c) { return c.role == role; });
+        if (it == available.end()) {
+            std::cerr << "未知角色: " << role
+                      << "（可选 interceptor/glutton/patroller/parasite/rollout）" << std::endl;
+            continue;
+        }
+        bots.push_back(*it);
+    }
 
-    // 每个 Bot 在独立线程中运行，互不阻塞
-    std::vector<std::thread> workers;
-    workers.reserve(bots.size());
+    std::cout << "启动 " << bots.size() << " 个 Bot，目标服务器: " << endpoint << std::endl;
 
     for (const auto& config : bots) {
-        workers.emplace_back([endpoint, config]() {
-            runOneBot(endpoint, config);
-        });
+        addToFleet(fleet, config);
+    }
+    if (fleet.size() == 0) {
+        std::cerr << "没有成功加入游戏的 Bot" << std::endl;
+        return 1;
     }
 
-    for (auto& worker : workers) {
-        if (worker.joinable()) {
-            worker.join();
-        }
+    try {
+        fleet.run();
+    } catch (const SnakeException& e) {
+        std::cerr << "运行异常: " << e.what() << std::endl;
+        return 1;
+    } catch (const std::exception& e) {
+        std::cerr << "标准异常: " << e.what() << std::endl;
+        return 1;
     }
 
     return 0;
@@ -1,6 +1,8 @@
 #include "strategies/GluttonStrategy.hpp"
 
 #include "common/DirectionUtils.hpp"
+#include "common/GridSearch.hpp"
+#include "common/VoronoiMap.hpp"
 
 #include <limits>
 
@@ -8,91 +10,61 @@ namespace bot {
 
 namespace {
 
-Point inferMoveVector(const Snake& snake) {
-    if (snake.blocks.size() < 2) {
-        return {0, 0};
-    }
-    return {
-        snake.blocks[0].x - snake.blocks[1].x,
-        snake.blocks[0].y - snake.blocks[1].y,
-    };
-}
-
-int estimateOneStepDist(const GameState& state, const Snake& snake, const Point& target) {
-    const int nowDist = snake.head.distance(target);
-    const Point vec = inferMoveVector(snake);
-    Point next = snake.head;
-    next.x += vec.x;
-    next.y += vec.y;
-
-    // 只做“一步前瞻”：若推断出的下一步非法，则回退为当前距离
-    if (!state.isValidPos(next.x, next.y) || state.hasObstacle(next.x, next.y)) {
-        return nowDist;
+// 在候选食物中取路径距离最近者；列表为空返回 false
+bool pickClosest(const VoronoiMap& voronoi, const std::vector<Point>& candidates, Point& out) {
+    int bestDist = std::numeric_limits<int>::max();
+    for (const auto& food : candidates) {
+        const int dist = voronoi.distanceAt(food);
+        if (dist < bestDist) {
+            bestDist = dist;
+            out = food;
+        }
     }
-
-    const int nextDist = next.distance(target);
-    return std::min(nowDist, nextDist);
+    return bestDist != std::numeric_limits<int>::max();
 }
 
 }  // namespace
 
 std::string decideGlutton(const GameState& state) {
-    const Snake me = state.getMySnake();
-    const auto foods = state.getFoods();
-    const auto players = state.getAllPlayers();
+    // 只读视图：不复制蛇身与食物集合
+    const Snake& me = state.getMySnakeRef();
+    const auto& foods = state.getFoodSet();
 
     if (foods.empty()) {
         return "right";
     }
 
-    // 1) 为每个食物打分：
-    //    - 我比别人先到（D_me < D_other_min）加分
-    //    - 别人也离得近（说明是热点）再加分
-    // 2) 找不到可抢食物时，退化为最近食物
-    Point bestFood = foods.front();
-    int bestScore = std::numeric_limits<int>::min();
-    int bestMyDist = std::numeric_limits<int>::max();
-
-    for (const auto& food : foods) {
-        const int myDist = me.head.distance(food);
-        int otherMinDist = std::numeric_limits<int>::max();
-
-        for (const auto& player : players) {
-            if (player.id == me.id) {
-                continue;
-            }
-            const int d = estimateOneStepDist(state, player, food);
-            if (d < otherMinDist) {
-                otherMinDist = d;
+    // 每回合一次多源 BFS：按真实路径（绕开蛇身）划分每个食物谁先到
+    thread_local VoronoiMap voronoi;
+    voronoi.compute(state);
+    const int myIndex = voronoi.indexOf(me.id);
+
+    // 1) 我严格先到的食物中取最近者
+    // 2) 否则去抢与对手同时到达的食物（冲突点，暴食者不让）
+    // 3) 都没有时，退化为曼哈顿距离最近的食物
+    Point bestFood = *foods.begin();
+    bool found = myIndex >= 0 && pickClosest(voronoi, voronoi.foodsOf(myIndex), bestFood);
+    if (!found) {
+        found = pickClosest(voronoi, voronoi.contestedFoods(), bestFood);
+    }
+    if (!found) {
+        int bestDist = std::numeric_limits<int>::max();
+        for (const auto& food : foods) {
+            const int dist = me.head.distance(food);
+            if (dist < bestDist) {
+                bestDist = dist;
+                bestFood = food;
             }
         }
-
-        // 无其他玩家时，让“冲突距离”退化为较大值
-        if (otherMinDist == std::numeric_limits<int>::max()) {
-            otherMinDist = 200;
-        }
-
-        int score = -myDist;
-        if (myDist < otherMinDist) {
-            score += 100;
-        }
-        // otherMinDist 越小越可能形成冲突，适当加权
-        score += (100 - otherMinDist);
-
-        // 当前一步就可能撞墙/撞人时，给一个惩罚，避免完全无效冲刺
-        std::string toward = chooseDirectionToward(state, me.head, food, false);
-        if (!isSafeDirection(state, me.head, toward)) {
-            score -= 25;
-        }
-
-        if (score > bestScore || (score == bestScore && myDist < bestMyDist)) {
-            bestScore = score;
-            bestMyDist = myDist;
-            bestFood = food;
-        }
     }
 
-    // 按 TODO 描述，暴食者几乎不做避障，激进吃食
+    // 沿最短路第一步前进；目标不可达时按 TODO 描述激进直冲，几乎不做避障
+    thread_local GridSearch search;
+    search.bind(state);
+    const std::string dir = search.firstStep(me.head, bestFood);
+    if (!dir.empty()) {
+        return dir;
+    }
     return chooseDirectionToward(state, me.head, bestFood, false);
 }
 
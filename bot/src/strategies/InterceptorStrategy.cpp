@@ -1,7 +1,9 @@
 #include "strategies/InterceptorStrategy.hpp"
 
+#include "common/Bitboard.hpp"
 #include "common/DirectionUtils.hpp"
 
+#include <algorithm>
 #include <limits>
 
 namespace bot {
@@ -22,42 +24,60 @@ Point inferMoveVector(const Snake& snake) {
 }  // namespace
 
 std::string decideInterceptor(const GameState& state) {
-    const Snake me = state.getMySnake();
-    const auto others = state.getOtherPlayers();
+    const Snake& me = state.getMySnakeRef();
 
-    if (others.empty()) {
-        return "right";
-    }
-
-    // 1) 锁定长度最长的目标
-    Snake target = others.front();
-    for (const auto& s : others) {
-        if (s.length > target.length) {
-            target = s;
+    // 1) 锁定长度最长的目标（同长取 ID 序最前者）
+    const Snake* target = nullptr;
+    for (const auto& entry : state.getPlayerMap()) {
+        const Snake& s = entry.second;
+        if (s.id == me.id) {
+            continue;
         }
+        if (!target || s.length > target->length) {
+            target = &s;
+        }
+    }
+    if (!target) {
+        return "right";
     }
 
     // 2) 根据对手方向预判其 4 步后位置
-    const Point moveVec = inferMoveVector(target);
-    Point predicted = target.head;
+    const Point moveVec = inferMoveVector(*target);
+    Point predicted = target->head;
     predicted.x += moveVec.x * 4;
     predicted.y += moveVec.y * 4;
 
-    // 3) 优先选安全且更接近预测点的方向
+    // 3) 优先选安全且更接近预测点的方向；走进去后可达面积不足自身长度的视为死路，
+    //    只在没有宽敞方向时才考虑，此时取面积最大者（位棋盘洪泛，缓冲区跨回合复用）
+    thread_local Bitboard passable;
+    thread_local Bitboard region;
+    thread_local Bitboard scratch;
+    passable.assignFreeCells(state);
+    const int roomNeeded = std::max(1, me.length);
+
     std::string bestSafe = "right";
+    bool bestRoomy = false;
+    int bestArea = -1;
     int bestSafeDist = std::numeric_limits<int>::max();
     for (const auto& dir : allDirections()) {
         if (!isSafeDirection(state, me.head, dir)) {
             continue;
         }
         const Point next = nextPoint(me.head, dir);
+        const int area = floodFill(passable, next, region, scratch, roomNeeded);
+        const bool roomy = area >= roomNeeded;
         const int dist = next.distance(predicted);
-        if (dist < bestSafeDist) {
+        const bool better = roomy != bestRoomy ? roomy
+                          : roomy              ? dist < bestSafeDist
+                                               : area > bestArea || (area == bestArea && dist < bestSafeDist);
+        if (bestArea < 0 || better) {
+            bestRoomy = roomy;
+            bestArea = area;
             bestSafeDist = dist;
             bestSafe = dir;
         }
     }
-    if (bestSafeDist != std::numeric_limits<int>::max()) {
+    if (bestArea >= 0) {
         return bestSafe;
     }
 
@@ -3,28 +3,51 @@
 #include "common/DirectionUtils.hpp"
 
 #include <array>
+#include <iterator>
 #include <limits>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 namespace bot {
 
 namespace {
 
-Snake chooseHost(const GameState& state, const Snake& me) {
-    const auto others = state.getOtherPlayers();
-    if (others.empty()) {
-        return me;
+// 跨回合的伴随状态：记录上一回合选择的偏移，减少“左右抖动”
+struct Companion {
+    std::string hostId;
+    Point preferredOffset = {1, 0};
+};
+
+// 超过该数量时清理已不在地图上的蛇（每次重生都是新 ID）
+constexpr std::size_t kMaxCompanions = 64;
+
+// 按蛇 ID 保存：同一线程内的多条寄生虫互不干扰；离线对局每局开始时由 resetParasiteState 清空
+thread_local std::unordered_map<std::string, Companion> companions;
+
+Companion& companionFor(const GameState& state, const std::string& id) {
+    if (companions.size() > kMaxCompanions) {
+        const auto& players = state.getPlayerMap();
+        for (auto it = companions.begin(); it != companions.end();) {
+            it = players.count(it->first) > 0 ? std::next(it) : companions.erase(it);
+        }
     }
+    return companions[id];
+}
 
-    // 近似“排行榜第一”：选长度最长者
-    Snake host = others.front();
-    for (const auto& s : others) {
-        if (s.length > host.length) {
-            host = s;
+const Snake& chooseHost(const GameState& state, const Snake& me) {
+    // 近似“排行榜第一”：选长度最长者；没有其他玩家时返回自己
+    const Snake* host = nullptr;
+    for (const auto& entry : state.getPlayerMap()) {
+        const Snake& s = entry.second;
+        if (s.id == me.id) {
+            continue;
+        }
+        if (!host || s.length > host->length) {
+            host = &s;
         }
     }
-    return host;
+    return host ? *host : me;
 }
 
 Point inferMoveVector(const Snake& snake) {
@@ -40,17 +63,15 @@ Point inferMoveVector(const Snake& snake) {
 }  // namespace
 
 std::string decideParasite(const GameState& state) {
-    const Snake me = state.getMySnake();
-    const Snake host = chooseHost(state, me);
-
-    // 记录上一回合选择的偏移，减少“左右抖动”
-    static std::string lastHostId;
-    static Point preferredOffset = {1, 0};
+    const Snake& me = state.getMySnakeRef();
+    const Snake& host = chooseHost(state, me);
 
-    if (lastHostId != host.id) {
-        preferredOffset = {1, 0};
-        lastHostId = host.id;
+    Companion& memo = companionFor(state, me.id);
+    if (memo.hostId != host.id) {
+        memo.preferredOffset = {1, 0};
+        memo.hostId = host.id;
     }
+    Point& preferredOffset = memo.preferredOffset;
 
     // 预测宿主下一步头部位置，提前站位
     const Point moveVec = inferMoveVector(host);
@@ -113,4 +134,8 @@ std::string decideParasite(const GameState& state) {
     return "right";
 }
 
+void resetParasiteState() {
+    companions.clear();
+}
+
 }  // namespace bot
@@ -1,11 +1,12 @@
 #include "strategies/PatrollerStrategy.hpp"
 
 #include "common/DirectionUtils.hpp"
+#include "common/GridSearch.hpp"
 
 #include <algorithm>
 #include <cstdint>
-#include <limits>
-#include <queue>
+#include <iterator>
+#include <unordered_map>
 #include <vector>
 
 namespace bot {
@@ -21,6 +22,12 @@ struct PatrolState {
     int index = 0;
 };
 
+// 超过该数量时清理已不在地图上的蛇（每次重生都是新 ID）
+constexpr std::size_t kMaxPatrols = 64;
+
+// 按蛇 ID 保存：同一线程内的多条巡逻兵各走各的矩形；离线对局每局开始时由 resetPatrollerState 清空
+thread_local std::unordered_map<std::string, PatrolState> patrols;
+
 // 基于 id 做稳定哈希，让每条蛇形成不同巡逻矩形
 std::uint64_t hashId(const std::string& id) {
     std::uint64_t h = 1469598103934665603ull;
@@ -40,83 +47,6 @@ std::vector<Point> rectanglePath(const PatrolState& ps) {
     };
 }
 
-std::string bfsFirstStep(const GameState& state, const Point& start, const Point& target) {
-    if (start.x == target.x && start.y == target.y) {
-        return "right";
-    }
-
-    const int width = state.getMapWidth();
-    const int height = state.getMapHeight();
-    if (width <= 0 || height <= 0) {
-        return "right";
-    }
-
-    auto id = [width](int x, int y) {
-        return y * width + x;
-    };
-
-    std::vector<int> prev(width * height, -1);
-    std::queue<Point> q;
-    q.push(start);
-    prev[id(start.x, start.y)] = id(start.x, start.y);
-
-    while (!q.empty()) {
-        const Point cur = q.front();
-        q.pop();
-
-        for (const auto& dir : allDirections()) {
-            Point nxt = nextPoint(cur, dir);
-            if (!state.isValidPos(nxt.x, nxt.y)) {
-                continue;
-            }
-
-            // 目标点允许被当作可进入节点，避免永远不可达
-            if ((nxt.x != target.x || nxt.y != target.y) && state.hasObstacle(nxt.x, nxt.y)) {
-                continue;
-            }
-
-            const int nid = id(nxt.x, nxt.y);
-            if (prev[nid] != -1) {
-                continue;
-            }
-
-            prev[nid] = id(cur.x, cur.y);
-            if (nxt.x == target.x && nxt.y == target.y) {
-                // 回溯找到从 start 出发的第一步
-                int curId = nid;
-                int parent = prev[curId];
-                while (parent != id(start.x, start.y)) {
-                    curId = parent;
-                    parent = prev[curId];
-                    if (parent == -1) {
-                        return "right";
-                    }
-                }
-
-                const int stepX = curId % width;
-                const int stepY = curId / width;
-                if (stepX == start.x && stepY == start.y - 1) {
-                    return "up";
-                }
-                if (stepX == start.x && stepY == start.y + 1) {
-                    return "down";
-                }
-                if (stepX == start.x - 1 && stepY == start.y) {
-                    return "left";
-                }
-                if (stepX == start.x + 1 && stepY == start.y) {
-                    return "right";
-                }
-                return "right";
-            }
-
-            q.push(nxt);
-        }
-    }
-
-    return "right";
-}
-
 void initPatrolIfNeeded(PatrolState& ps, const GameState& state, const Snake& me) {
     if (ps.inited) {
         return;
@@ -159,8 +89,14 @@ void initPatrolIfNeeded(PatrolState& ps, const GameState& state, const Snake& me
 }  // namespace
 
 std::string decidePatroller(const GameState& state) {
-    const Snake me = state.getMySnake();
-    static PatrolState patrol;
+    const Snake& me = state.getMySnakeRef();
+    if (patrols.size() > kMaxPatrols) {
+        const auto& players = state.getPlayerMap();
+        for (auto it = patrols.begin(); it != patrols.end();) {
+            it = players.count(it->first) > 0 ? std::next(it) : patrols.erase(it);
+        }
+    }
+    PatrolState& patrol = patrols[me.id];
     initPatrolIfNeeded(patrol, state, me);
 
     auto path = rectanglePath(patrol);
@@ -172,8 +108,13 @@ std::string decidePatroller(const GameState& state) {
         target = path[patrol.index];
     }
 
-    // 通过 BFS 计算更平滑的最短路回归
-    std::string dir = bfsFirstStep(state, me.head, target);
+    // 通过 BFS 计算更平滑的最短路回归（搜索缓冲区跨回合复用）
+    thread_local GridSearch search;
+    search.bind(state);
+    std::string dir = search.firstStep(me.head, target);
+    if (dir.empty()) {
+        dir = "right";
+    }
     if (!isSafeDirection(state, me.head, dir)) {
         // 最短路第一步不可用时，回退为局部贪心
         dir = chooseDirectionToward(state, me.head, target, true);
@@ -193,4 +134,8 @@ std::string decidePatroller(const GameState& state) {
     return "right";
 }
 
+void resetPatrollerState() {
+    patrols.clear();
+}
+
 }  // namespace bot
@@ -0,0 +1,33 @@
+#include "strategies/RolloutStrategy.hpp"
+
+#include "common/RolloutSearch.hpp"
+#include "strategies/GluttonStrategy.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace bot {
+
+std::string decideRollout(const GameState& state, int budgetMs) {
+    // 线程池与节点池跨回合复用；预算随回合时长变化，每次搜索前更新
+    thread_local RolloutSearch search([] {
+        RolloutOptions options;
+        options.threads = 2;
+        return options;
+    }());
+    search.setBudgetMs(std::max(1, budgetMs));
+
+    const RolloutResult result = search.search(state);
+    if (result.move == snake_rules::MOVE_NONE) {
+        // 局面里找不到自己（刚重生、地图尚未同步）：交给暴食者
+        return decideGlutton(state);
+    }
+    return result.direction();
+}
+
+int rolloutBudgetMs(int roundTimeMs, double share) {
+    const double clamped = std::min(1.0, std::max(0.0, share));
+    return std::max(1, static_cast<int>(std::lround(roundTimeMs * clamped)));
+}
+
+}  // namespace bot
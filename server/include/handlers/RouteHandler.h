@@ -5,10 +5,15 @@
 #include "../managers/MapManager.h"
 #include "../database/LeaderboardManager.h"
 #include "../utils/RateLimiter.h"
+#include "../utils/PasteVerifier.h"
+#include "../utils/PerformanceMonitor.h"
 #include "../utils/Logger.h"
 #include <crow.h>
 #include <crow/middlewares/cors.h>
+#include <cstdint>
 #include <memory>
+#include <mutex>
+#include <string>
 
 namespace snake {
 
@@ -28,22 +33,53 @@ public:
     template<typename App>
     void registerRoutes(App& app);
 
+    // 停止剪贴板验证线程，结束所有等待验证的登录请求；须在 Crow 停止前调用
+    void shutdown();
+
 private:
     // API 处理函数
     crow::response handleStatus(const crow::request& req);
-    crow::response handleLogin(const crow::request& req);
-    crow::response handleJoin(const crow::request& req);
+    // 登录为异步响应：身份验证完成后在验证线程上结束 res
+    void handleLogin(const crow::request& req, crow::response& res);
+    // 加入为异步响应：请求排队到下一回合开始时统一分配出生点，回合发布后结束 res
+    void handleJoin(const crow::request& req, crow::response& res);
     crow::response handleGetMap(const crow::request& req);
-    crow::response handleGetMapDelta(const crow::request& req);
+    // 带 after_round 参数时为长轮询：请求停放到下一回合发布后再结束 res
+    void handleGetMapDelta(const crow::request& req, crow::response& res);
     crow::response handleMove(const crow::request& req);
+    // 提交移动后停放请求，执行该移动的回合推进后返回新回合的增量状态
+    void handleStep(const crow::request& req, crow::response& res);
+    // 批量提交多个玩家的移动：逐条校验后一次加锁写入，返回逐条结果
+    crow::response handleMoves(const crow::request& req);
     crow::response handleLeaderboard(const crow::request& req);
     crow::response handleMetrics(const crow::request& req);
+    crow::response handleDebugTrace(const crow::request& req);
 
     // 辅助函数
     std::string getClientIp(const crow::request& req);
     bool isLoopbackAddress(const std::string& ip) const;
     bool isLoopbackRequest(const crow::request& req) const;
-    bool checkRateLimit(const std::string& key, const std::string& endpoint);
+    bool rateLimitParams(RateLimiter::Endpoint endpoint, int& maxRequests,
+                         std::chrono::milliseconds& window) const;
+    bool checkRateLimit(const std::string& key, RateLimiter::Endpoint endpoint);
+    int getRetryAfter(const std::string& key, RateLimiter::Endpoint endpoint) const;
+    std::shared_ptr<const std::string> deltaResponseBody();
+    crow::response deltaResponse();
+    // 完整地图状态（map_state 对象）的序列化缓存，/api/game/map 与加入响应共享
+    std::shared_ptr<const std::string> mapStateBody();
+    crow::response joinResponse(const std::string& token, const std::string& playerId,
+                                Direction initialDirection);
+    // 校验单条移动（token + direction）；失败时 error 为对应的错误响应
+    bool parseMoveEntry(const nlohmann::json& entry, std::string& playerId,
+                        Direction& direction, nlohmann::json& error);
+    // 校验并提交移动指令；成功时写入指令生效的回合边界
+    crow::response submitMoveRequest(const nlohmann::json& requestData, int& appliedAfterRound);
+    int defaultLongPollTimeoutMs() const;
+    int clampLongPollTimeoutMs(int timeoutMs) const;
+    void respondDeltaAfterRound(crow::response& res, int afterRound, int timeoutMs,
+                                std::shared_ptr<PerformanceMonitor::ScopedRequest> metricsGuard);
+    crow::response completeLogin(const std::string& uid, const std::string& paste, const std::string& clientIp);
+    void respond(crow::response& res, crow::response&& built);
     crow::response buildResponse(const nlohmann::json& jsonData);
     crow::response handleException(const std::exception& e);
 
@@ -52,6 +88,17 @@ private:
     std::shared_ptr<MapManager> mapManager_;
     std::shared_ptr<LeaderboardManager> leaderboardManager_;
     RateLimiter rateLimiter_;
+    PasteVerifier pasteVerifier_;
+
+    // 增量状态响应体缓存：同一状态版本只序列化一次，长轮询批量唤醒时共享
+    std::mutex deltaCacheMutex_;
+    std::uint64_t deltaCacheVersion_ = 0;
+    std::shared_ptr<const std::string> deltaCacheBody_;
+
+    // 完整地图状态缓存（同上，按状态版本失效）
+    std::mutex mapCacheMutex_;
+    std::uint64_t mapCacheVersion_ = 0;
+    std::shared_ptr<const std::string> mapCacheBody_;
 };
 
 // 模板函数实现必须在头文件中
@@ -65,14 +112,14 @@ void RouteHandler::registerRoutes(App& app) {
 
     // POST /api/game/login
     CROW_ROUTE(app, "/api/game/login").methods(crow::HTTPMethod::POST)
-    ([this](const crow::request& req) {
-        return handleLogin(req);
+    ([this](const crow::request& req, crow::response& res) {
+        handleLogin(req, res);
     });
 
     // POST /api/game/join
     CROW_ROUTE(app, "/api/game/join").methods(crow::HTTPMethod::POST)
-    ([this](const crow::request& req) {
-        return handleJoin(req);
+    ([this](const crow::request& req, crow::response& res) {
+        handleJoin(req, res);
     });
 
     // GET /api/game/map
@@ -81,10 +128,10 @@ void RouteHandler::registerRoutes(App& app) {
         return handleGetMap(req);
     });
 
-    // GET /api/game/map/delta
+    // GET /api/game/map/delta[?after_round=N&timeout_ms=T]
     CROW_ROUTE(app, "/api/game/map/delta")
-    ([this](const crow::request& req) {
-        return handleGetMapDelta(req);
+    ([this](const crow::request& req, crow::response& res) {
+        handleGetMapDelta(req, res);
     });
 
     // POST /api/game/move
@@ -93,6 +140,18 @@ void RouteHandler::registerRoutes(App& app) {
         return handleMove(req);
     });
 
+    // POST /api/game/step
+    CROW_ROUTE(app, "/api/game/step").methods(crow::HTTPMethod::POST)
+    ([this](const crow::request& req, crow::response& res) {
+        handleStep(req, res);
+    });
+
+    // POST /api/game/moves
+    CROW_ROUTE(app, "/api/game/moves").methods(crow::HTTPMethod::POST)
+    ([this](const crow::request& req) {
+        return handleMoves(req);
+    });
+
     // GET /api/leaderboard
     CROW_ROUTE(app, "/api/leaderboard")
     ([this](const crow::request& req) {
@@ -105,6 +164,12 @@ void RouteHandler::registerRoutes(App& app) {
         return handleMetrics(req);
     });
 
+    // GET /api/debug/trace?rounds=N
+    CROW_ROUTE(app, "/api/debug/trace")
+    ([this](const crow::request& req) {
+        return handleDebugTrace(req);
+    });
+
     LOG_INFO("All routes registered");
 }
 
@@ -3,19 +3,29 @@
 #include "../models/GameState.h"
 #include "../models/Direction.h"
 #include "../models/Snake.h"
+#include "../utils/RoundWaitList.h"
+#include "SnakeRules.hpp"
+#include <chrono>
+#include <cstdint>
 #include <memory>
 #include <mutex>
 #include <thread>
 #include <atomic>
+#include <deque>
+#include <functional>
 #include <map>
 #include <unordered_set>
 #include <unordered_map>
+#include <utility>
+#include <vector>
 
 namespace snake {
 
 class MapManager;
 class PlayerManager;
 class LeaderboardManager;
+class TickScheduler;
+class HouseBotManager;
 
 /**
  * @brief 游戏管理器
@@ -37,12 +47,35 @@ public:
     void tick();
 
     // 移动指令
-    bool submitMove(const std::string& playerId, Direction direction);
+    // appliedAfterRound 非空时写入该指令生效的回合边界：回合号超过该值的状态已包含这次移动
+    bool submitMove(const std::string& playerId, Direction direction, int* appliedAfterRound = nullptr);
+    // 批量提交：一次加锁写入全部指令，返回值第 i 项表示第 i 条是否被接受（本回合已提交过则为 false）
+    std::vector<bool> submitMoves(const std::vector<std::pair<std::string, Direction>>& moves);
 
     // 状态查询
     GameState getGameState() const;
     int getCurrentRound() const;
     nlohmann::json getDeltaState() const;
+    // 状态版本号：回合推进、玩家加入/离开/重生时递增，供调用方缓存序列化结果
+    std::uint64_t getStateVersion() const;
+
+    /**
+     * @brief 长轮询：回合号超过 afterRound 时回调 advanced=true，超时回调 false
+     * 回调在派发线程上执行；停放数量达到上限时返回 false（不回调）
+     */
+    bool waitForRoundAfter(int afterRound, std::chrono::milliseconds timeout,
+                           RoundWaitList::Callback callback);
+
+    // 完整地图状态（JSON 对象）
+    nlohmann::json getMapState() const;
+
+    /**
+     * @brief 加入请求排队：下一回合开始时与同批请求一起分配互不冲突的出生点并加入
+     * 回调在该回合发布后于派发线程执行；joined 为 false 表示没有安全出生点或服务器已停止。
+     * 游戏未运行时返回 false（不回调）
+     */
+    using JoinCallback = std::function<void(bool joined)>;
+    bool queueJoin(std::shared_ptr<Player> player, JoinCallback callback);
 
     // 玩家管理
     bool addPlayer(std::shared_ptr<Player> player);
@@ -51,14 +84,30 @@ public:
 
 private:
     void gameLoop();
+    // 加入玩家（调用方持有 stateMutex_）
+    bool addPlayerLocked(std::shared_ptr<Player> player);
+    // 选出生点、初始化蛇并加入（调用方持有 stateMutex_）；没有安全出生点时返回 false
+    bool spawnPlayerLocked(const std::shared_ptr<Player>& player);
+    // 批量处理排队的加入请求（游戏线程，回合开始时）
+    void applyJoins();
+    // 内置 Bot 加入/重生并写入本回合指令（游戏线程，交换指令缓冲区之后）
+    void runHouseBots();
+    // 写入一条移动指令（调用方持有 movesMutex_）
+    bool queueMoveLocked(const std::string& playerId, Direction direction);
+    // 把存活的蛇和食物装入规则引擎，槽位按 GameState 中的玩家顺序（调用方持有 stateMutex_）
+    void loadRules();
     void processMovements();
     void checkCollisions();
     void handleFoodCollection();
     void generateFood();
     void updateInvincibility();
+    // 回收死亡超过保留期的玩家：移出 GameState 并注销会话
+    void compactDeadPlayers();
     void addSnakeToOccupancy(const Snake& snake);
+    // 仅更新占用索引；需要掉落食物时另行调用 createSnakeDeathDrops
     void removeSnakeFromOccupancy(const Snake& snake);
-    void createSnakeDeathDrops(std::vector<Point> pos);
+    void createSnakeDeathDrops(const std::deque<Point>& pos);
+    void refreshArenaRoster();
 
     std::shared_ptr<MapManager> mapManager_;
     std::shared_ptr<PlayerManager> playerManager_;
@@ -71,14 +120,47 @@ private:
     std::map<std::string, Direction> currentMoves_;  // 本回合收到的移动指令（下回合执行）
     std::map<std::string, Direction> nextMoves_;     // 下回合要执行的移动指令（上回合收到的）
     std::mutex movesMutex_;
+    // currentMoves_ 中的指令将在回合号超过该值的推进中执行（受 movesMutex_ 保护，交换缓冲区时更新）
+    int movesAppliedAfterRound_ = 0;
+
+    // 竞技场模式：本回合应提交移动的存活玩家及其中已提交的人数（受 movesMutex_ 保护，回合结束时刷新）
+    bool arenaMode_ = false;
+    std::unordered_set<std::string> arenaRoster_;
+    std::size_t arenaMoved_ = 0;
+
+    // 待回收的死亡玩家（死亡回合, playerId），按死亡顺序排列（仅游戏线程访问）
+    std::deque<std::pair<int, std::string>> deadPlayers_;
 
-    // 预判自撞：在移动前计算，移动后用于判定
-    std::unordered_set<std::string> pendingSelfCollisions_;
+    // 规则引擎：移动、自撞、碰撞、死亡掉落与进食由它推进一步，GameManager 按其事件同步增量、排行榜与占用索引
+    // ruleSlots_[i] 是引擎槽位 i 对应的玩家（仅游戏线程访问，本回合 processMovements 装入）
+    snake_rules::RulesState rules_;
+    std::vector<std::shared_ptr<Player>> ruleSlots_;
+    std::unordered_map<std::string, int> ruleSlotIndex_;
+    std::vector<snake_rules::Cell> ruleBody_;
+    std::vector<snake_rules::Move> ruleMoves_;
 
     // 空间索引：蛇身占用计数（用于 O(1) 碰撞判断）
     std::unordered_map<Point, int, PointHash> occupiedCounts_;
+
+    // 排队中的加入请求，回合开始时整体取出
+    struct PendingJoin {
+        std::shared_ptr<Player> player;
+        JoinCallback callback;
+    };
+    std::vector<PendingJoin> pendingJoins_;
+    std::mutex joinsMutex_;
+
+    // 服务器内置 Bot（未启用时为空）
+    std::unique_ptr<HouseBotManager> houseBots_;
+
+    std::atomic<std::uint64_t> stateVersion_{0};
+    RoundWaitList roundWaiters_;
+
+    // 本回合排行榜写入耗时合计（仅游戏线程访问）
+    double leaderboardWriteMs_ = 0.0;
     
-    // 游戏循环线程
+    // 游戏循环线程与回合调度器
+    std::unique_ptr<TickScheduler> scheduler_;
     std::thread gameThread_;
     std::atomic<bool> running_;
 };
@@ -0,0 +1,74 @@
+#pragma once
+
+#include "../models/GameState.h"
+#include "../models/Direction.h"
+#include "HouseBotStrategies.h"
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace snake {
+
+class MapManager;
+class PlayerManager;
+
+/**
+ * @brief 服务器内置 Bot
+ *
+ * 内置 Bot 以普通玩家身份参赛：有自己的会话与玩家 ID，出现在地图、增量与排行榜中；
+ * 但不经过 HTTP，每回合开始时在游戏线程上直接读取权威 GameState 决策，
+ * 把方向写入本回合执行的指令缓冲，省去轮询、JSON 解析与移动请求。
+ * 死亡后等待 respawn_delay_rounds 回合以新会话重新加入，与客户端自动重生一致。
+ *
+ * 决策直接调用 bot/ 的策略函数（glutton / interceptor / parasite / patroller），与客户端 Bot 行为一致：
+ * 每回合按权威状态重建一次 SDK 视图，所有在场 Bot 共用。
+ * 所有方法只在游戏线程上调用，调用方持有 GameManager 的状态锁。
+ */
+class HouseBotManager {
+public:
+    HouseBotManager(std::shared_ptr<MapManager> mapManager,
+                    std::shared_ptr<PlayerManager> playerManager);
+
+    bool empty() const { return bots_.empty(); }
+
+    /**
+     * @brief 为到期需要（重新）加入的 Bot 创建会话
+     * @return 待加入的玩家，调用方负责分配出生点并加入 GameState
+     */
+    std::vector<std::shared_ptr<Player>> prepareJoins(const GameState& state);
+    // 调用方未能加入（没有安全出生点）：放弃该会话，下回合重试
+    void cancelJoin(const std::string& playerId);
+
+    // 为在场的 Bot 决策并写入 moves（已有指令的玩家不覆盖）
+    void decideMoves(const GameState& state, std::map<std::string, Direction>& moves);
+
+    // 该玩家 ID 是否为当前在场的内置 Bot
+    bool isHouseBot(const std::string& playerId) const;
+    std::size_t activeCount() const { return activeIds_.size(); }
+
+private:
+    struct Bot {
+        std::string name;
+        std::string color;
+        std::string uid;
+        HouseBotStrategies::Strategy strategy = HouseBotStrategies::Strategy::GLUTTON;
+        std::string playerId;   // 当前会话；未加入或已死亡时为空
+        int respawnAt = 0;      // 允许重新加入的回合
+    };
+
+    // 按权威状态重建策略视图：存活蛇身（与占用索引同源）与食物
+    void buildView(const GameState& state);
+
+    std::shared_ptr<MapManager> mapManager_;
+    std::shared_ptr<PlayerManager> playerManager_;
+    std::vector<Bot> bots_;
+    std::unordered_set<std::string> activeIds_;
+
+    HouseBotStrategies strategies_;
+    std::vector<std::pair<int, int>> body_;     // 重建视图时复用的蛇身缓冲
+};
+
+} // namespace snake
@@ -0,0 +1,48 @@
+#pragma once
+
+#include "../models/Direction.h"
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace snake {
+
+/**
+ * @brief 内置 Bot 与 bot/ 策略库之间的桥
+ *
+ * 持有一份客户端 SDK 的 GameState 视图，每回合由 HouseBotManager 按权威状态重建，
+ * 再调用与客户端 Bot 完全相同的策略函数（bot/src/strategies）决策。
+ * 实现单独成一个编译单元：SDK 头文件内嵌另一版本的 nlohmann/json，不与服务器头文件进入同一翻译单元，
+ * 因此本接口只使用整数坐标。
+ */
+class HouseBotStrategies {
+public:
+    enum class Strategy {
+        GLUTTON,        // 暴食者：抢“我能先到、别人也想吃”的食物
+        INTERCEPTOR,    // 拦截者：预测对手路线并抢先堵截
+        PARASITE,       // 寄生虫：伴随最长的蛇
+        PATROLLER       // 巡逻兵：沿矩形路线巡逻
+    };
+
+    HouseBotStrategies();
+    ~HouseBotStrategies();
+
+    // 解析配置中的策略名（glutton / interceptor / parasite / patroller）
+    static bool parse(const std::string& name, Strategy& out);
+
+    // 开始重建视图：清空上一回合的蛇与食物
+    void beginView(int width, int height, int round);
+    // body 从头到尾
+    void addSnake(const std::string& id, const std::vector<std::pair<int, int>>& body, int invincibleRounds);
+    void addFood(int x, int y);
+
+    // 以 selfId 为“自己”运行策略；策略返回无法识别的方向时为 NONE
+    Direction decide(Strategy strategy, const std::string& selfId);
+
+private:
+    struct View;
+    std::unique_ptr<View> view_;
+};
+
+} // namespace snake
@@ -30,6 +30,9 @@ public:
 
     // 安全位置生成
     Point getRandomSafePosition(const std::vector<std::shared_ptr<Player>>& players, int safeRadius);
+    // 基于空间索引的版本：每次采样只查询安全区内的格子，不遍历蛇身
+    Point getRandomSafePositionFast(const std::unordered_map<Point, int, PointHash>& occupiedCounts,
+                                    int safeRadius);
     
     // 碰撞检测
     enum class CollisionType {
@@ -57,6 +60,9 @@ private:
                            const std::vector<std::shared_ptr<Player>>& players) const;
     bool isSafeArea(const Point& center, int radius,
                     const std::vector<std::shared_ptr<Player>>& players) const;
+    // 在离边界 safeRadius 的范围内随机采样，返回第一个满足 isSafe 的位置
+    template <typename IsSafe>
+    Point sampleSafePosition(int safeRadius, IsSafe isSafe);
 
     int width_;
     int height_;
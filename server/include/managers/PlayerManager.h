@@ -2,10 +2,14 @@
 
 #include "../models/Player.h"
 #include "../database/DatabaseManager.h"
+#include "SessionTable.h"
+#include <array>
+#include <atomic>
 #include <memory>
 #include <string>
-#include <map>
+#include <mutex>
 #include <shared_mutex>
+#include <unordered_map>
 
 namespace snake {
 
@@ -20,7 +24,6 @@ public:
 
     // 登录与认证
     std::string login(const std::string& uid, const std::string& paste);
-    bool checkLogin(const std::string& uid, const std::string& paste);
     
     // 加入游戏
     struct JoinResult {
@@ -31,6 +34,9 @@ public:
     };
     JoinResult join(const std::string& key, const std::string& name, 
                     const std::string& color);
+    // 调用方已通过 validateKey 取得 uid 时使用，避免重复校验
+    JoinResult join(const std::string& key, const std::string& uid,
+                    const std::string& name, const std::string& color);
 
     // 验证
     bool validateKey(const std::string& key, std::string& uid) const;
@@ -46,9 +52,6 @@ public:
     bool isPlayerInGame(const std::string& playerId) const;
     int getPlayerCount() const;
     
-    // 获取所有在线玩家列表（用于游戏逻辑和统计）
-    std::vector<std::shared_ptr<Player>> getAllPlayers() const;
-    
     // 批量移除玩家（用于游戏结束或重置）
     void removeAllPlayers();
     
@@ -56,6 +59,30 @@ public:
     std::vector<std::shared_ptr<Player>> getPlayersByUid(const std::string& uid) const;
 
 private:
+    /**
+     * @brief 账号索引（分片哈希表）
+     * 启动时从 players 表整体加载；login 更新 key/paste 时只替换该账号的条目，
+     * 条目本身不可变，读者按键哈希锁定一个分片的读锁，不访问数据库。
+     */
+    struct AccountEntry {
+        std::string key;
+        std::string paste;
+    };
+    static constexpr std::size_t kKeyIndexShards = 16;
+    struct alignas(64) KeyShard {
+        mutable std::shared_mutex mutex;
+        std::unordered_map<std::string, std::string> keyToUid;
+    };
+    struct alignas(64) AccountShard {
+        mutable std::shared_mutex mutex;
+        std::unordered_map<std::string, std::shared_ptr<const AccountEntry>> byUid;
+    };
+
+    void loadKeyIndex();
+    static std::size_t keyIndexShard(const std::string& key);
+    std::shared_ptr<const AccountEntry> findAccount(const std::string& uid) const;
+    void publishAccount(const std::string& uid, const std::string& key, const std::string& paste);
+
     std::string generateKey(const std::string& uid);
     std::string generateToken(const std::string& playerId);
     std::string generatePlayerId(const std::string& uid);
@@ -64,19 +91,15 @@ private:
     // 数据库管理器
     std::shared_ptr<DatabaseManager> db_;
 
-    // uid -> key 映射
-    std::map<std::string, std::string> uidToKey_;
-    
-    // key -> uid 映射
-    std::map<std::string, std::string> keyToUid_;
-    
-    // token -> playerId 映射
-    std::map<std::string, std::string> tokenToPlayerId_;
-    
-    // playerId -> Player 对象
-    std::map<std::string, std::shared_ptr<Player>> players_;
+    // 账号索引（key -> uid、uid -> key/paste），按键哈希分片
+    std::array<KeyShard, kKeyIndexShards> keyShards_;
+    std::array<AccountShard, kKeyIndexShards> accountShards_;
+    std::atomic<std::size_t> accountCount_{0};
+    // 串行化 login 对账号索引的写入
+    std::mutex keyWriteMutex_;
     
-    mutable std::shared_mutex mutex_;
+    // 会话索引：token / playerId / uid -> Player（分片加锁）
+    SessionTable sessions_;
 };
 
 } // namespace snake
@@ -0,0 +1,76 @@
+#pragma once
+
+#include "../models/Player.h"
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace snake {
+
+/**
+ * @brief 分片会话表
+ * 保存 token -> Player、playerId -> Player、uid -> 活跃会话 三组索引，
+ * 每组索引按键哈希拆分为多个分片，每个分片独立加读写锁。
+ *
+ * 读路径（如 /api/game/move 的 token 校验）只锁定一个分片，
+ * 不同玩家的请求几乎不会互相阻塞，也不存在全局锁。
+ */
+class SessionTable {
+public:
+    static constexpr std::size_t kShardCount = 16;
+
+    enum class InsertResult {
+        OK,
+        UID_IN_GAME,     // 该 uid 已有在游戏中的会话
+        ID_EXISTS,       // playerId 冲突
+        TOKEN_EXISTS     // token 冲突
+    };
+
+    SessionTable() = default;
+    SessionTable(const SessionTable&) = delete;
+    SessionTable& operator=(const SessionTable&) = delete;
+
+    // 插入会话（player 的 uid/id/token 必须已设置）
+    InsertResult insert(const std::shared_ptr<Player>& player);
+
+    // 查询（每次调用只探测一个分片）
+    std::shared_ptr<Player> findByToken(const std::string& token) const;
+    std::shared_ptr<Player> findById(const std::string& playerId) const;
+    std::shared_ptr<Player> findActiveByUid(const std::string& uid) const;
+
+    // 移除会话，返回被移除的玩家（不存在时返回 nullptr）
+    std::shared_ptr<Player> erase(const std::string& playerId);
+    std::size_t clear();
+
+    std::size_t size() const;
+    // 所有会话的快照（逐个分片加读锁拷贝智能指针）
+    std::vector<std::shared_ptr<Player>> snapshot() const;
+
+private:
+    using PlayerMap = std::unordered_map<std::string, std::shared_ptr<Player>>;
+
+    // 按缓存行对齐，避免相邻分片的锁产生伪共享
+    struct alignas(64) Shard {
+        mutable std::shared_mutex mutex;
+        PlayerMap entries;
+    };
+    using ShardArray = std::array<Shard, kShardCount>;
+
+    static std::size_t shardIndex(const std::string& key);
+    static Shard& shardFor(ShardArray& shards, const std::string& key);
+    static const Shard& shardFor(const ShardArray& shards, const std::string& key);
+    static std::shared_ptr<Player> find(const ShardArray& shards, const std::string& key);
+
+    // 加锁顺序固定为 uid -> id -> token，避免死锁
+    ShardArray byUid_;
+    ShardArray byId_;
+    ShardArray byToken_;
+    std::atomic<std::size_t> size_{0};
+};
+
+} // namespace snake
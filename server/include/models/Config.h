@@ -2,6 +2,7 @@
 
 #include <string>
 #include <cstddef>
+#include <vector>
 #include <nlohmann/json.hpp>
 
 namespace snake {
@@ -21,6 +22,9 @@ public:
         std::string sslCertFile;
         std::string sslKeyFile;
         bool sslUseChainFile = false;
+        int longPollMaxTimeoutMs = 30000;   // 长轮询请求最长停放时间
+        int longPollMaxWaiters = 4096;      // 同时停放的长轮询请求上限
+        int moveBatchMaxSize = 256;         // 批量移动接口单次请求的最大条目数
     };
 
     struct GameConfig {
@@ -30,6 +34,10 @@ public:
         int initialSnakeLength = 3;
         int invincibleRounds = 5;
         double foodDensity = 0.05;
+        int tickSpinUs = 1000;          // 回合截止前的自旋等待时长（微秒）
+        bool arenaMode = false;         // 竞技场模式：所有存活玩家提交后提前推进回合
+        int arenaMinIntervalMs = 0;     // 竞技场模式下两回合之间的最小间隔
+        int deadPlayerRetentionRounds = 20; // 死亡玩家保留多少回合后回收（会话与 token 随之失效）
     };
 
     struct DatabaseConfig {
@@ -51,11 +59,18 @@ public:
         int movePerRound = 1;
         int mapPerSecond = 10;
         int mapWindowSeconds = 1;
+        int sweepIntervalSeconds = 10;   // 后台清扫过期记录的间隔
+        int maxTrackedKeys = 100000;     // 跟踪的键数量上限（超出时淘汰旧记录）
     };
 
     struct AuthConfig {
         std::string luoguValidationText = "SnakeGameVerification2026";
         std::string universalPaste;
+        int verifyThreads = 2;                // 剪贴板验证线程数
+        int verifyCacheTtlSeconds = 600;      // 验证通过结果的缓存时间
+        int verifyNegativeTtlSeconds = 30;    // 验证失败结果的缓存时间
+        int verifyCacheMaxEntries = 10000;    // 验证结果缓存上限
+        int verifyMaxPending = 256;           // 等待远程拉取的验证任务上限，超出返回 503
     };
 
     struct LeaderboardConfig {
@@ -64,11 +79,31 @@ public:
         int cacheTtlSeconds = 5;
     };
 
+    // 服务器内置 Bot（作为普通玩家参赛，但在游戏线程上直接决策，不经过 HTTP）
+    struct HouseBotEntry {
+        std::string name;
+        std::string strategy = "glutton";   // glutton / interceptor / parasite / patroller（bot/ 的策略）
+        std::string color;                  // 为空时随机生成
+    };
+
+    struct HouseBotConfig {
+        bool enabled = false;
+        int respawnDelayRounds = 8;         // 死亡后等待多少回合重新加入
+        std::vector<HouseBotEntry> bots;
+    };
+
+    struct LoggingConfig {
+        std::string level = "info";        // debug / info / warning / error
+        bool console = true;
+        std::string file = "./data/server.log";  // 为空表示不写文件
+        std::size_t maxBytes = 10 * 1024 * 1024;  // 单文件上限
+        int maxFiles = 5;                  // 滚动文件数量
+    };
+
     struct PerformanceMonitorConfig {
         bool enabled = false;
         double sampleRate = 0.2;
         int windowSeconds = 60;
-        int maxSamples = 2000;
         bool logEnabled = false;
         int logIntervalSeconds = 10;
         std::string logPath = "./data/metrics.log";
@@ -90,6 +125,8 @@ public:
     const AuthConfig& getAuth() const;
     const LeaderboardConfig& getLeaderboard() const;
     const PerformanceMonitorConfig& getPerformanceMonitor() const;
+    const LoggingConfig& getLogging() const;
+    const HouseBotConfig& getHouseBots() const;
 
 private:
     Config() = default;
@@ -103,6 +140,8 @@ private:
     AuthConfig auth_;
     LeaderboardConfig leaderboard_;
     PerformanceMonitorConfig performanceMonitor_;
+    LoggingConfig logging_;
+    HouseBotConfig houseBots_;
 };
 
 } // namespace snake
@@ -26,6 +26,8 @@ public:
     // 玩家管理
     void addPlayer(std::shared_ptr<Player> player);
     void removePlayer(const std::string& playerId);
+    // 批量移除（一次遍历），返回实际移除的数量
+    std::size_t removePlayers(const std::unordered_set<std::string>& playerIds);
     std::shared_ptr<Player> getPlayer(const std::string& playerId);
     std::shared_ptr<Player> getPlayer(const std::string& playerId) const;
     const std::vector<std::shared_ptr<Player>>& getPlayers() const;
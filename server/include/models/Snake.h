@@ -29,6 +29,8 @@ public:
     // 移动相关
     void move(); 
     MoveResult moveWithDelta();
+    // 按给定新头部移动；keepTail 为 true 时本次成长一格
+    MoveResult applyMove(const Point& newHead, bool keepTail);
     void grow();
     
     // 状态查询
@@ -37,6 +39,7 @@ public:
     int getLength() const;
     Direction getCurrentDirection() const;
     int getInvincibleRounds() const;
+    int getGrowthPending() const;
     bool isAlive() const;
 
     // 状态修改
@@ -0,0 +1,120 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace snake {
+
+/**
+ * @brief 对数分桶延迟直方图（HDR 风格）
+ * 数值单位为微秒。小于 64 的值逐个计数；更大的值按 2 的幂分段，
+ * 每段再线性细分为 32 个子桶，相对误差不超过 1/32。
+ * 桶数量固定，内存恒定，与记录次数无关。
+ *
+ * 约定单写者多读者：只有所属线程调用 record()，
+ * 采集线程可随时通过 Snapshot::merge() 读取（所有访问均为 relaxed 原子操作，无锁）。
+ */
+class LatencyHistogram {
+public:
+    static constexpr int kSubBucketBits = 5;
+    static constexpr std::uint64_t kSubBucketCount = 1ULL << kSubBucketBits;
+    static constexpr int kMaxValueBits = 36;  // 上限约 19 小时，超出部分计入最后一个桶
+    static constexpr std::uint64_t kMaxValue = (1ULL << kMaxValueBits) - 1;
+    static constexpr std::size_t kBucketCount =
+        static_cast<std::size_t>(2 * kSubBucketCount +
+                                 (kMaxValueBits - 1 - kSubBucketBits) * kSubBucketCount);
+
+    /**
+     * @brief 合并后的只读快照（采集时在调用方栈上构造）
+     */
+    struct Snapshot {
+        std::array<std::uint64_t, kBucketCount> buckets{};
+        std::uint64_t count = 0;
+        std::uint64_t sumUs = 0;
+        std::uint64_t maxUs = 0;
+
+        void merge(const LatencyHistogram& histogram);
+        void merge(const Snapshot& other);
+
+        // p 取值 [0,1]，返回所在桶的上界（不超过观测到的最大值）
+        std::uint64_t percentileUs(double p) const;
+        double meanUs() const;
+    };
+
+    LatencyHistogram() = default;
+    LatencyHistogram(const LatencyHistogram&) = delete;
+    LatencyHistogram& operator=(const LatencyHistogram&) = delete;
+
+    void record(std::uint64_t valueUs);
+    // 清零（仅所属线程调用；并发读取可能看到部分清零的数据）
+    void reset();
+
+    static std::size_t bucketIndex(std::uint64_t valueUs);
+    static std::uint64_t bucketUpperBound(std::size_t index);
+
+private:
+    std::array<std::atomic<std::uint64_t>, kBucketCount> buckets_{};
+    std::atomic<std::uint64_t> sumUs_{0};
+    std::atomic<std::uint64_t> maxUs_{0};
+};
+
+/**
+ * @brief 按时间片滚动的延迟直方图（用于窗口内分位数）
+ * 与 RateWindow 相同，调用方传入时间片序号；每个时间片一份 LatencyHistogram，
+ * 写入新时间片时复用最旧的槽位并清零。另记录累计次数，供计数器类指标使用。
+ */
+class WindowedHistogram {
+public:
+    static constexpr std::size_t kSliceCount = 4;
+
+    WindowedHistogram() = default;
+    WindowedHistogram(const WindowedHistogram&) = delete;
+    WindowedHistogram& operator=(const WindowedHistogram&) = delete;
+
+    void record(std::uint64_t valueUs, std::int64_t tick);
+
+    // 合并 tick 位于 [fromTick, toTick] 内的时间片（区间长度应不超过 kSliceCount）
+    void merge(LatencyHistogram::Snapshot& snapshot, std::int64_t fromTick, std::int64_t toTick) const;
+    // 进程启动以来的记录次数
+    std::uint64_t total() const;
+
+private:
+    struct Slice {
+        std::atomic<std::int64_t> tick{-1};
+        LatencyHistogram histogram;
+    };
+
+    std::array<Slice, kSliceCount> slices_{};
+    std::atomic<std::uint64_t> total_{0};
+};
+
+/**
+ * @brief 按时间片计数的环形窗口（用于 QPS）
+ * 调用方把当前时间换算为时间片序号 tick 传入；同一槽位被新 tick 覆盖时清零。
+ * 与 LatencyHistogram 相同，仅所属线程写入，读取端无锁。
+ */
+class RateWindow {
+public:
+    static constexpr std::size_t kSlotCount = 64;
+
+    RateWindow() = default;
+    RateWindow(const RateWindow&) = delete;
+    RateWindow& operator=(const RateWindow&) = delete;
+
+    void add(std::int64_t tick);
+
+    // 统计 tick 位于 [fromTick, toTick] 内的计数（区间长度应小于 kSlotCount）
+    std::uint64_t sum(std::int64_t fromTick, std::int64_t toTick) const;
+
+private:
+    struct Slot {
+        std::atomic<std::int64_t> tick{-1};
+        std::atomic<std::uint64_t> count{0};
+    };
+
+    std::array<Slot, kSlotCount> slots_{};
+};
+
+} // namespace snake
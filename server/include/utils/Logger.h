@@ -1,13 +1,32 @@
 #pragma once
 
-#include <string>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
 #include <fstream>
+#include <memory>
 #include <mutex>
+#include <string>
+#include <thread>
+
+/**
+ * 编译期日志级别下限：0=DEBUG, 1=INFO, 2=WARNING, 3=ERROR
+ * 低于该级别的 LOG_* 调用在编译期即被裁剪（参数表达式不会求值）。
+ * 可通过 CMake 选项 SNAKE_LOG_MIN_LEVEL 设置。
+ */
+#ifndef SNAKE_LOG_MIN_LEVEL
+#define SNAKE_LOG_MIN_LEVEL 0
+#endif
 
 namespace snake {
 
 /**
  * @brief 日志系统
+ * 异步写入：调用线程只把消息放入无锁环形队列，由后台线程批量写到控制台和滚动日志文件，
+ * 回合线程与 HTTP 工作线程不会阻塞在 stdout 或磁盘上。
+ * 队列满时丢弃新消息并计数，不会阻塞调用方。
  */
 class Logger {
 public:
@@ -21,36 +40,97 @@ public:
     static Logger& getInstance();
 
     void setLevel(Level level);
-    void setLogFile(const std::string& filename);
+    Level getLevel() const;
+    void setLogFile(const std::string& filename, std::size_t maxBytes = 10 * 1024 * 1024, int maxFiles = 5);
     void enableConsole(bool enable);
 
+    // 运行期级别判断（供 LOG_* 宏在格式化参数之前调用）
+    bool shouldLog(Level level) const {
+        return static_cast<int>(level) >= level_.load(std::memory_order_relaxed);
+    }
+
     void debug(const std::string& msg);
     void info(const std::string& msg);
     void warning(const std::string& msg);
     void error(const std::string& msg);
 
-    void log(Level level, const std::string& msg);
+    void log(Level level, std::string msg);
+
+    // 等待队列中已有的日志写出
+    void flush();
+    // 停止后台线程并写出剩余日志；之后的日志同步写出
+    void shutdown();
+
+    // 因队列满被丢弃的日志条数
+    std::uint64_t droppedCount() const;
+
+    // 级别名不区分大小写，接受 debug/info/warning(warn)/error；无法识别时返回 false
+    static bool tryParseLevel(const std::string& name, Level& level);
+    static Level parseLevel(const std::string& name, Level fallback = Level::INFO);
 
 private:
+    // 队列容量（2 的幂）
+    static constexpr std::size_t kQueueCapacity = 8192;
+
+    // 有界多生产者单消费者队列的槽位（Vyukov 序号算法）
+    struct Slot {
+        std::atomic<std::size_t> sequence{0};
+        Level level = Level::INFO;
+        std::chrono::system_clock::time_point time;
+        std::string message;
+    };
+
     Logger();
     ~Logger();
     Logger(const Logger&) = delete;
     Logger& operator=(const Logger&) = delete;
 
+    bool tryEnqueue(Level level, std::string& msg);
+    bool tryDequeue(Level& level, std::chrono::system_clock::time_point& time, std::string& msg);
+
     std::string levelToString(Level level) const;
-    std::string getCurrentTime() const;
-    void writeLog(Level level, const std::string& msg);
+    std::string formatTime(std::chrono::system_clock::time_point time) const;
+    void writeLog(Level level, std::chrono::system_clock::time_point time, const std::string& msg);
+    void rotateIfNeededLocked();
+    void drainLoop();
+
+    std::atomic<int> level_;
+    std::atomic<bool> consoleEnabled_;
+
+    std::unique_ptr<Slot[]> ring_;
+    std::atomic<std::size_t> enqueuePos_{0};
+    std::size_t dequeuePos_ = 0;  // 仅后台线程访问
+    std::atomic<std::uint64_t> dropped_{0};
+    std::atomic<std::uint64_t> enqueued_{0};
+    std::atomic<std::uint64_t> written_{0};
 
-    Level level_;
+    // 输出端（文件句柄、滚动参数），仅后台线程和 setLogFile 访问
+    std::mutex sinkMutex_;
     std::ofstream logFile_;
-    bool consoleEnabled_;
-    std::mutex mutex_;
-};
+    std::string logPath_;
+    std::size_t logBytes_ = 0;
+    std::size_t maxBytes_ = 0;
+    int maxFiles_ = 0;
 
-// 便捷宏
-#define LOG_DEBUG(msg) snake::Logger::getInstance().debug(msg)
-#define LOG_INFO(msg) snake::Logger::getInstance().info(msg)
-#define LOG_WARNING(msg) snake::Logger::getInstance().warning(msg)
-#define LOG_ERROR(msg) snake::Logger::getInstance().error(msg)
+    std::mutex wakeMutex_;
+    std::condition_variable wakeCv_;
+    std::condition_variable flushedCv_;
+    std::atomic<bool> running_{false};
+    std::thread drainThread_;
+};
 
 } // namespace snake
+
+// 便捷宏：先做编译期与运行期级别判断，未启用的级别不会对 msg 表达式求值
+#define SNAKE_LOG_AT(level, levelValue, msg)                                          \
+    do {                                                                              \
+        if ((levelValue) >= SNAKE_LOG_MIN_LEVEL &&                                    \
+            snake::Logger::getInstance().shouldLog(level)) {                          \
+            snake::Logger::getInstance().log(level, msg);                             \
+        }                                                                             \
+    } while (0)
+
+#define LOG_DEBUG(msg) SNAKE_LOG_AT(snake::Logger::Level::DEBUG, 0, msg)
+#define LOG_INFO(msg) SNAKE_LOG_AT(snake::Logger::Level::INFO, 1, msg)
+#define LOG_WARNING(msg) SNAKE_LOG_AT(snake::Logger::Level::WARNING, 2, msg)
+#define LOG_ERROR(msg) SNAKE_LOG_AT(snake::Logger::Level::ERROR, 3, msg)
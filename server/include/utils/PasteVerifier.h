@@ -0,0 +1,104 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace snake {
+
+/**
+ * @brief 洛谷剪贴板异步验证器
+ * 远程拉取在独立的工作线程上执行，HTTP 工作线程只负责提交请求并立即返回。
+ *
+ * - 合并：同一 (uid, paste) 的并发请求只触发一次远程拉取，结果回调给所有等待者
+ * - 缓存：验证结果按 (uid, paste) 缓存，通过与拒绝分别使用不同的 TTL；
+ *   拉取失败（网络错误、非 200）不缓存
+ * - 限流：等待远程拉取的 (uid, paste) 数达到上限时新请求直接返回 OVERLOADED
+ * - 拉取器可替换，便于指向本地桩服务
+ */
+class PasteVerifier {
+public:
+    enum class Verdict {
+        ACCEPTED,     // 验证通过
+        REJECTED,     // 作者或内容不匹配、参数非法
+        UNAVAILABLE,  // 拉取失败，无法判断
+        OVERLOADED    // 待验证任务已满，未受理
+    };
+
+    // 拉取剪贴板页面 HTML，失败返回空字符串
+    using Fetcher = std::function<std::string(const std::string& paste)>;
+    // 验证完成回调：缓存命中时在调用线程执行，否则在验证线程执行
+    using Callback = std::function<void(Verdict)>;
+
+    struct Options {
+        int workerThreads = 2;
+        int positiveTtlSeconds = 600;
+        int negativeTtlSeconds = 30;
+        std::size_t maxCacheEntries = 10000;
+        std::size_t maxPendingJobs = 256;
+    };
+
+    explicit PasteVerifier(const Options& options, Fetcher fetcher = Fetcher());
+    ~PasteVerifier();
+
+    PasteVerifier(const PasteVerifier&) = delete;
+    PasteVerifier& operator=(const PasteVerifier&) = delete;
+
+    void verifyAsync(const std::string& uid, const std::string& paste, Callback callback);
+    // 同步版本（阻塞调用线程直到得到结果）
+    Verdict verify(const std::string& uid, const std::string& paste);
+
+    // 停止验证线程：进行中的拉取完成后回调，排队中的任务以 UNAVAILABLE 回调；
+    // 之后提交的新请求直接返回 UNAVAILABLE。可重复调用
+    void shutdown();
+
+    void setFetcher(Fetcher fetcher);
+    std::size_t cacheSize() const;
+
+private:
+    struct CacheEntry {
+        Verdict verdict;
+        std::chrono::steady_clock::time_point expiresAt;
+    };
+
+    struct Job {
+        std::string key;
+        std::string uid;
+        std::string paste;
+    };
+
+    static std::string makeKey(const std::string& uid, const std::string& paste);
+
+    bool lookupCache(const std::string& key, Verdict& verdict);
+    void storeCache(const std::string& key, Verdict verdict);
+    Verdict runVerification(const Job& job);
+    void complete(const std::string& key, Verdict verdict);
+    void workerLoop();
+
+    Options options_;
+
+    mutable std::mutex fetcherMutex_;
+    Fetcher fetcher_;
+
+    mutable std::mutex cacheMutex_;
+    std::unordered_map<std::string, CacheEntry> cache_;
+
+    // 进行中的验证：key -> 等待该结果的回调
+    std::mutex inflightMutex_;
+    std::unordered_map<std::string, std::vector<Callback>> inflight_;
+
+    std::mutex queueMutex_;
+    std::condition_variable queueCv_;
+    std::deque<Job> queue_;
+    bool stopping_ = false;
+    std::vector<std::thread> workers_;
+};
+
+} // namespace snake
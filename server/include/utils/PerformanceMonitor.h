@@ -1,13 +1,16 @@
 #pragma once
 
+#include "LatencyHistogram.h"
+#include <array>
 #include <atomic>
 #include <cstdint>
 #include <chrono>
-#include <deque>
+#include <memory>
 #include <mutex>
 #include <string>
 #include <thread>
 #include <unordered_map>
+#include <vector>
 #include <nlohmann/json.hpp>
 
 namespace snake {
@@ -15,14 +18,18 @@ namespace snake {
 /**
  * @brief 性能监控器
  * 采集请求指标、回合耗时、锁等待、队列长度和内存占用
+ *
+ * 记录路径无锁：每个线程首次记录时分配一份独立的统计分片（对数分桶直方图 + QPS 环形窗口），
+ * 之后只写自己的分片；指标名在全局注册表中映射为整数 ID，线程内缓存映射结果。
+ * /api/metrics 采集时再遍历所有分片合并，得到 p50/p90/p99/p999 等分位数。
+ * 分位数只统计最近约 window_seconds 秒（直方图按时间片滚动），请求总数为进程启动以来累计。
  */
 class PerformanceMonitor {
 public:
     struct Config {
         bool enabled = false;
-        double sampleRate = 0.2;          // 采样率 [0,1]
-        int windowSeconds = 60;           // QPS 统计窗口
-        int maxSamples = 2000;            // 延迟样本上限
+        double sampleRate = 0.2;          // 锁等待采样率 [0,1]
+        int windowSeconds = 60;           // QPS 与分位数统计窗口
         bool logEnabled = false;          // 是否落盘
         int logIntervalSeconds = 10;      // 日志间隔
         std::string logPath = "./data/metrics.log";
@@ -41,6 +48,22 @@ public:
         bool enabled_ = false;
     };
 
+    /**
+     * @brief 回合阶段计时（tick 内部使用）
+     * 析构时写入该阶段的耗时直方图；追踪录制中时同时输出 trace 区间
+     */
+    class ScopedPhase {
+    public:
+        explicit ScopedPhase(const char* phase);
+        ~ScopedPhase();
+
+    private:
+        const char* phase_;
+        std::chrono::steady_clock::time_point start_;
+        bool enabled_ = false;
+        bool tracing_ = false;
+    };
+
     static PerformanceMonitor& getInstance();
 
     void configure(const Config& config);
@@ -51,17 +74,57 @@ public:
     void recordRequest(const std::string& endpoint, double latencyMs);
     void recordLockWait(const std::string& lockName, double waitMs);
     void observeRoundDuration(double roundMs);
+    // 回合实际开始时间相对计划截止时间的延迟
+    void observeTickJitter(double latenessMs);
+    // 回合超时导致跳过的截止时间数
+    void recordTickOverrun(int missedDeadlines);
+    void observePhase(const std::string& phase, double phaseMs);
     void setGauge(const std::string& name, double value);
 
     nlohmann::json toJson() const;
     std::string toPrometheus() const;
 
 private:
-    struct LockStat {
-        std::uint64_t count = 0;
-        double totalWaitMs = 0.0;
-        double maxWaitMs = 0.0;
-        double lastWaitMs = 0.0;
+    // 每类指标最多注册的名称数量，超出后新名称的记录被丢弃
+    static constexpr std::size_t kMaxSeries = 64;
+
+    /**
+     * @brief 指标名注册表（名称 -> 整数 ID）
+     * 仅在某线程首次遇到新名称时加锁，热路径走线程内缓存。
+     */
+    class NameRegistry {
+    public:
+        int intern(const std::string& name);  // 已满时返回 -1
+        std::vector<std::string> names() const;
+
+    private:
+        mutable std::mutex mutex_;
+        std::unordered_map<std::string, int> ids_;
+        std::vector<std::string> names_;
+    };
+
+    // 某线程内某个指标名的统计
+    struct Series {
+        WindowedHistogram latency;
+        RateWindow rate;
+    };
+    using SeriesSlots = std::array<std::atomic<Series*>, kMaxSeries>;
+
+    // 线程独占的统计分片：只有所属线程写入，线程退出后仍保留以免丢失计数
+    struct ThreadShard {
+        SeriesSlots requests{};
+        SeriesSlots locks{};
+        SeriesSlots phases{};
+        WindowedHistogram rounds;
+        WindowedHistogram tickJitter;
+
+        // 以下成员只由所属线程访问
+        std::vector<std::unique_ptr<Series>> owned;
+        std::unordered_map<std::string, int> requestIds;
+        std::unordered_map<std::string, int> lockIds;
+        std::unordered_map<std::string, int> phaseIds;
+        std::unordered_map<std::string, int> gaugeIds;
+        std::uint64_t rngState = 0;
     };
 
     PerformanceMonitor();
@@ -69,11 +132,16 @@ private:
     PerformanceMonitor(const PerformanceMonitor&) = delete;
     PerformanceMonitor& operator=(const PerformanceMonitor&) = delete;
 
-    bool shouldSample() const;
-    void pruneDeque(std::deque<std::chrono::steady_clock::time_point>& deque,
-                    const std::chrono::steady_clock::time_point& now) const;
+    ThreadShard& localShard();
+    Series* localSeries(ThreadShard& shard, SeriesSlots& slots,
+                        std::unordered_map<std::string, int>& cache,
+                        NameRegistry& registry, const std::string& name, int& id);
+    std::vector<ThreadShard*> allShards() const;
 
-    double percentile(const std::deque<double>& samples, double p) const;
+    bool shouldSample(ThreadShard& shard) const;
+    std::int64_t currentTick(std::chrono::steady_clock::time_point now) const;
+    std::int64_t histogramTick(std::chrono::steady_clock::time_point now) const;
+    std::int64_t histogramTick() const;
     std::uint64_t getRssBytes() const;
 
     void logLoop();
@@ -84,22 +152,23 @@ private:
     std::atomic<bool> enabled_;
     std::atomic<bool> running_;
 
-    mutable std::mutex mutex_;
-
-    std::unordered_map<std::string, std::deque<std::chrono::steady_clock::time_point>> qpsByEndpoint_;
-    std::deque<std::chrono::steady_clock::time_point> qpsAll_;
-
-    std::unordered_map<std::string, std::deque<double>> latencyByEndpoint_;
-    std::deque<double> latencyAll_;
+    // QPS 时间片宽度（秒），保证统计窗口落在 RateWindow 的槽位数以内
+    int rateSlotSeconds_ = 1;
+    // 直方图时间片宽度（秒）：分位数统计最近 kSliceCount - 1 个完整时间片加当前时间片
+    int histogramSliceSeconds_ = 20;
 
-    std::unordered_map<std::string, std::uint64_t> requestCounts_;
-    std::uint64_t totalRequests_ = 0;
+    mutable std::mutex shardsMutex_;  // 仅在线程注册和采集时使用
+    std::vector<std::unique_ptr<ThreadShard>> shards_;
 
-    std::unordered_map<std::string, LockStat> lockStats_;
-    std::unordered_map<std::string, double> gauges_;
+    NameRegistry requestNames_;
+    NameRegistry lockNames_;
+    NameRegistry phaseNames_;
+    NameRegistry gaugeNames_;
 
-    std::deque<double> roundSamples_;
-    double lastRoundMs_ = 0.0;
+    std::array<std::atomic<double>, kMaxSeries> lockLastMs_{};
+    std::array<std::atomic<double>, kMaxSeries> gauges_{};
+    std::atomic<double> lastRoundMs_{0.0};
+    std::atomic<std::uint64_t> tickOverruns_{0};
 
     std::thread logThread_;
 };
@@ -1,41 +1,110 @@
 #pragma once
 
-#include <string>
-#include <map>
-#include <mutex>
+#include <array>
+#include <atomic>
 #include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
 #include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
 
 namespace snake {
 
 /**
  * @brief 速率限制器
- * 实现基于滑动窗口的速率限制
+ * 基于 GCRA（通用信元速率算法）实现：每个键只保存一个“理论到达时间”(TAT)，
+ * 状态大小恒定，不随请求数增长。
+ *
+ * - 按键哈希分片，每个分片独立加锁
+ * - 端点使用预定义枚举，避免每次请求拼接 "endpoint:key" 字符串
+ * - 后台清扫线程定期移除已完全恢复配额的键，并对键总数设置上限，
+ *   保证在大量伪造 IP 的请求下内存有界；分片满时按插入顺序抽查少量记录淘汰，开销为 O(1)
  */
 class RateLimiter {
 public:
-    RateLimiter();
+    enum class Endpoint : std::uint8_t {
+        STATUS,
+        LOGIN,
+        JOIN,
+        MOVE,
+        MAP,
+        COUNT
+    };
+
+    explicit RateLimiter(int sweepIntervalSeconds = 10, std::size_t maxTrackedKeys = 100000);
     ~RateLimiter();
 
-    // 检查是否超过速率限制
-    bool checkLimit(const std::string& key, int maxRequests, int windowSeconds);
-    
-    // 获取需要等待的时间（秒）
-    int getRetryAfter(const std::string& key, int maxRequests, int windowSeconds) const;
+    RateLimiter(const RateLimiter&) = delete;
+    RateLimiter& operator=(const RateLimiter&) = delete;
+
+    // 检查是否超过速率限制（window 内最多 maxRequests 次，允许突发）
+    bool checkLimit(Endpoint endpoint, const std::string& key,
+                    int maxRequests, std::chrono::milliseconds window);
+
+    // 获取需要等待的时间（秒，向上取整）
+    int getRetryAfter(Endpoint endpoint, const std::string& key,
+                      int maxRequests, std::chrono::milliseconds window) const;
+
+    // 清理已恢复配额的记录（后台线程定期调用）
+    std::size_t cleanup();
+
+    // 清理某个端点的所有记录（用于回合重置）
+    void clearEndpoint(Endpoint endpoint);
 
-    // 清理过期记录
-    void cleanup();
-    
-    // 清理特定前缀的所有记录（用于回合重置）
-    void clearByPrefix(const std::string& prefix);
+    // 当前跟踪的键数量
+    std::size_t size() const;
 
 private:
-    struct RequestRecord {
-        std::deque<std::chrono::system_clock::time_point> timestamps;
+    static constexpr std::size_t kShardCount = 16;
+    static constexpr std::size_t kEndpointCount = static_cast<std::size_t>(Endpoint::COUNT);
+
+    // 键 -> 理论到达时间（steady_clock 纳秒）与插入序号
+    struct TatEntry {
+        std::int64_t tat;
+        std::uint64_t seq;
+    };
+    using TatMap = std::unordered_map<std::string, TatEntry>;
+
+    // 插入顺序环：键被删除或重新插入后，旧记录因序号不符而失效
+    struct RingEntry {
+        std::uint8_t endpoint;
+        std::uint64_t seq;
+        std::string key;
+    };
+
+    struct alignas(64) Shard {
+        mutable std::mutex mutex;
+        std::array<TatMap, kEndpointCount> tats;
+        std::size_t keyCount = 0;  // 各端点记录数之和
+        std::deque<RingEntry> ring;
+        std::uint64_t nextSeq = 0;
     };
 
-    std::map<std::string, RequestRecord> records_;
-    mutable std::mutex mutex_;
+    // 分片满时从插入顺序最早处最多检查的有效记录数
+    static constexpr int kEvictionProbes = 8;
+
+    static std::int64_t nowNs();
+    static std::int64_t emissionIntervalNs(int maxRequests, std::chrono::milliseconds window);
+    static std::size_t shardIndex(const std::string& key);
+
+    std::size_t evictExpiredLocked(Shard& shard, std::int64_t now);
+    void evictOneLocked(Shard& shard, std::int64_t now);
+    static bool isLive(const Shard& shard, const RingEntry& entry);
+    void sweepLoop();
+
+    std::array<Shard, kShardCount> shards_;
+    const std::size_t maxKeysPerShard_;
+    std::atomic<std::size_t> trackedKeys_{0};
+
+    const std::chrono::seconds sweepInterval_;
+    std::mutex sweepMutex_;
+    std::condition_variable sweepCv_;
+    bool stopping_ = false;
+    std::thread sweepThread_;
 };
 
 } // namespace snake
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace snake {
+
+/**
+ * @brief 回合长轮询等待队列
+ * 请求登记“等待回合号超过 afterRound”，回合线程发布新回合后由派发线程统一回调；
+ * 到达截止时间仍未推进的等待以 advanced=false 回调。
+ *
+ * 回合线程的 publish() 只更新回合号并唤醒派发线程，不执行任何回调，
+ * 停放的请求再多也不会拖慢回合推进。
+ */
+class RoundWaitList {
+public:
+    using Clock = std::chrono::steady_clock;
+    // advanced 为 true 表示回合已推进；false 表示超时或服务器停止
+    using Callback = std::function<void(bool advanced)>;
+
+    explicit RoundWaitList(std::size_t maxWaiters);
+    ~RoundWaitList();
+
+    RoundWaitList(const RoundWaitList&) = delete;
+    RoundWaitList& operator=(const RoundWaitList&) = delete;
+
+    /**
+     * @brief 登记等待
+     * 回合已经超过 afterRound 时在调用线程立即回调；队列已满时返回 false 且不回调。
+     * bounded 为 false 时不受数量上限约束（回合线程为已受理的加入请求登记时使用，数量由调用方控制）
+     */
+    bool add(int afterRound, Clock::time_point deadline, Callback callback, bool bounded = true);
+
+    // 回合线程调用：发布最新回合号
+    void publish(int round);
+
+    // 停止派发线程，剩余等待全部以 advanced=false 回调
+    void shutdown();
+
+    std::size_t size() const;
+
+private:
+    struct Waiter {
+        int afterRound;
+        Clock::time_point deadline;
+        Callback callback;
+    };
+
+    void dispatchLoop();
+
+    const std::size_t maxWaiters_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable cv_;
+    std::vector<Waiter> waiters_;
+    int publishedRound_ = -1;
+    bool stopping_ = false;
+    std::thread dispatcher_;
+};
+
+} // namespace snake
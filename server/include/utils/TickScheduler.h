@@ -0,0 +1,72 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+
+namespace snake {
+
+/**
+ * @brief 绝对截止时间的回合调度器
+ * 截止时间固定落在 steady_clock 上 origin + k * period 的网格点，
+ * 回合耗时与唤醒抖动不会累积成漂移。
+ *
+ * 等待分两段：先用条件变量睡到截止时间前 spin 微秒，再自旋到截止时间，
+ * 以较小的 CPU 代价换取亚毫秒级的唤醒精度。interrupt() 可随时打断等待。
+ *
+ * 提前推进（竞技场模式）：其他线程调用 wakeEarly() 后，只要距上一回合开始已过最小间隔，
+ * 等待立即结束；此后的截止时间网格以这次提前开始的时间为新起点。
+ * 除 interrupt()/wakeEarly()/cancelEarlyWake() 外的方法只允许回合线程调用。
+ */
+class TickScheduler {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    TickScheduler(std::chrono::microseconds period, std::chrono::microseconds spin);
+
+    // 以 now + period 作为第一个截止时间
+    void reset(Clock::time_point now = Clock::now());
+
+    // 等待到当前截止时间；返回 false 表示被 interrupt() 打断
+    bool waitForDeadline();
+
+    // 实际唤醒时间相对截止时间的延迟（最近一次 waitForDeadline）
+    std::chrono::microseconds lastLateness() const { return lastLateness_; }
+    // 最近一次唤醒是否由 wakeEarly() 提前触发
+    bool lastWakeEarly() const { return lastWakeEarly_; }
+
+    // 两个回合开始之间的最小间隔（仅约束提前推进，自下一次唤醒起生效）
+    void setMinInterval(std::chrono::microseconds interval);
+    void wakeEarly();
+    void cancelEarlyWake();
+
+    /**
+     * @brief 推进到下一个截止时间
+     * 若回合执行超过了一个或多个周期，跳过已错过的网格点（不补跑回合），
+     * 返回跳过的周期数。
+     */
+    int advance(Clock::time_point now = Clock::now());
+
+    Clock::time_point deadline() const { return deadline_; }
+    // 截止时间换算为系统时钟的 Unix 毫秒时间戳（用于下发给客户端）
+    long long deadlineUnixMs() const;
+
+    void interrupt();
+
+private:
+    const std::chrono::microseconds period_;
+    const std::chrono::microseconds spin_;
+    Clock::time_point deadline_;
+    std::chrono::microseconds lastLateness_{0};
+    bool lastWakeEarly_ = false;
+
+    std::mutex wakeMutex_;
+    std::condition_variable wakeCv_;
+    bool interrupted_ = false;
+    bool earlyRequested_ = false;
+    std::chrono::microseconds minInterval_{0};
+    Clock::time_point earliest_;   // 允许提前推进的最早时间
+};
+
+} // namespace snake
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <nlohmann/json.hpp>
+
+namespace snake {
+
+/**
+ * @brief 按需追踪录制器
+ * 由 /api/debug/trace 触发，录制接下来 N 个回合内的回合阶段与请求耗时区间，
+ * 导出为 Chrome trace-event JSON（可在 chrome://tracing 或 Perfetto 中打开）。
+ *
+ * 未录制时，埋点的开销只有一次 relaxed 原子读。
+ * 同一时刻只允许一个录制任务。
+ */
+class TraceRecorder {
+public:
+    /**
+     * @brief RAII 区间埋点
+     * 仅在构造时处于录制状态才会在析构时写入事件
+     */
+    class ScopedSpan {
+    public:
+        ScopedSpan(const char* name, const char* category);
+        ScopedSpan(const std::string& name, const char* category);
+        ~ScopedSpan();
+
+        ScopedSpan(const ScopedSpan&) = delete;
+        ScopedSpan& operator=(const ScopedSpan&) = delete;
+
+    private:
+        std::string name_;
+        const char* category_;
+        std::chrono::steady_clock::time_point start_;
+        bool active_ = false;
+    };
+
+    static TraceRecorder& getInstance();
+
+    bool isCapturing() const {
+        return state_.load(std::memory_order_relaxed) == State::CAPTURING;
+    }
+
+    // 申请录制接下来 rounds 个回合；已有录制任务时返回 false
+    bool beginCapture(int rounds);
+
+    // 等待录制完成（或超时），结束录制并返回 Chrome trace JSON
+    nlohmann::json finishCapture(std::chrono::milliseconds timeout);
+
+    // 游戏线程在每个回合前后调用
+    void onTickStart(int round);
+    void onTickEnd();
+
+    void recordSpan(const std::string& name, const char* category,
+                    std::chrono::steady_clock::time_point start,
+                    std::chrono::steady_clock::time_point end,
+                    long long round = -1);
+
+private:
+    enum class State {
+        IDLE,       // 无录制任务
+        ARMED,      // 已申请，等待下一个回合开始
+        CAPTURING,  // 录制中
+        DONE        // 已录满，等待导出
+    };
+
+    struct Event {
+        std::string name;
+        const char* category;
+        std::int64_t startUs;
+        std::int64_t durationUs;
+        std::uint32_t tid;
+        long long round;
+    };
+
+    TraceRecorder() = default;
+    TraceRecorder(const TraceRecorder&) = delete;
+    TraceRecorder& operator=(const TraceRecorder&) = delete;
+
+    static std::uint32_t currentThreadId();
+    nlohmann::json buildTraceLocked() const;
+
+    std::atomic<State> state_{State::IDLE};
+
+    mutable std::mutex mutex_;
+    std::condition_variable doneCv_;
+    std::vector<Event> events_;
+    std::chrono::steady_clock::time_point origin_;
+    std::chrono::steady_clock::time_point tickStart_;
+    int tickRound_ = 0;
+    int roundsRequested_ = 0;
+    int roundsRemaining_ = 0;
+    std::uint32_t gameThreadId_ = 0;
+};
+
+} // namespace snake
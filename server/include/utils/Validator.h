@@ -10,8 +10,17 @@ namespace snake {
  */
 class Validator {
 public:
-    // 洛谷剪贴板验证
+    // 洛谷剪贴板验证（同步：在调用线程上拉取页面）
     static bool validateLuoguPaste(const std::string& uid, const std::string& paste);
+
+    // 剪贴板参数格式检查（不访问网络）
+    static bool isValidPasteId(const std::string& paste);
+    // 是否命中配置的万能 paste
+    static bool isUniversalPaste(const std::string& paste);
+    // 拉取剪贴板页面 HTML（失败返回空字符串），作为 PasteVerifier 的默认拉取器
+    static std::string fetchLuoguPaste(const std::string& paste);
+    // 校验已拉取的剪贴板页面：作者 UID 与验证文本
+    static bool verifyPasteHtml(const std::string& uid, const std::string& paste, const std::string& html);
     
     // 参数验证
     static bool isValidUid(const std::string& uid);
@@ -25,7 +34,6 @@ public:
 
 private:
     static bool isHexColor(const std::string& color);
-    static std::string fetchLuoguPaste(const std::string& paste);
     static std::string parseHttpResponse(const std::string& response);
     static std::string extractTextFromHtml(const std::string& html);
     static nlohmann::json parseHtmlForPasteData(const std::string& html, const std::string& pasteId);
@@ -1,8 +1,10 @@
 #include "../include/handlers/RouteHandler.h"
 #include "../include/utils/ResponseBuilder.h"
 #include "../include/utils/Validator.h"
+#include "../include/utils/PasteVerifier.h"
 #include "../include/utils/Logger.h"
 #include "../include/utils/PerformanceMonitor.h"
+#include "../include/utils/TraceRecorder.h"
 #include "../include/models/Config.h"
 #include <cstdlib>
 #include <vector>
@@ -11,6 +13,19 @@
 
 namespace snake {
 
+namespace {
+PasteVerifier::Options pasteVerifierOptions() {
+    const auto& auth = Config::getInstance().getAuth();
+    PasteVerifier::Options options;
+    options.workerThreads = auth.verifyThreads;
+    options.positiveTtlSeconds = auth.verifyCacheTtlSeconds;
+    options.negativeTtlSeconds = auth.verifyNegativeTtlSeconds;
+    options.maxCacheEntries = static_cast<std::size_t>(auth.verifyCacheMaxEntries);
+    options.maxPendingJobs = static_cast<std::size_t>(auth.verifyMaxPending);
+    return options;
+}
+}
+
 RouteHandler::RouteHandler(std::shared_ptr<GameManager> gameManager,
                            std::shared_ptr<PlayerManager> playerManager,
                            std::shared_ptr<MapManager> mapManager,
@@ -18,7 +33,10 @@ RouteHandler::RouteHandler(std::shared_ptr<GameManager> gameManager,
     : gameManager_(gameManager)
     , playerManager_(playerManager)
     , mapManager_(mapManager)
-    , leaderboardManager_(leaderboardManager) {
+    , leaderboardManager_(leaderboardManager)
+    , rateLimiter_(Config::getInstance().getRateLimit().sweepIntervalSeconds,
+                   static_cast<std::size_t>(Config::getInstance().getRateLimit().maxTrackedKeys))
+    , pasteVerifier_(pasteVerifierOptions()) {
     LOG_INFO("RouteHandler initialized");
 }
 
@@ -26,18 +44,18 @@ RouteHandler::~RouteHandler() {
     LOG_INFO("RouteHandler destroyed");
 }
 
+void RouteHandler::shutdown() {
+    pasteVerifier_.shutdown();
+}
+
 crow::response RouteHandler::handleStatus(const crow::request& req) {
     try {
         PerformanceMonitor::ScopedRequest metricsGuard("status");
         // 检查速率限制
         std::string clientIp = getClientIp(req);
-        if (!isLoopbackRequest(req) && !checkRateLimit(clientIp, "status")) {
+        if (!isLoopbackRequest(req) && !checkRateLimit(clientIp, RateLimiter::Endpoint::STATUS)) {
             LOG_WARNING("Rate limit exceeded for status endpoint from IP: " + clientIp);
-            const auto& rateLimitConfig = Config::getInstance().getRateLimit();
-            int retryAfter = rateLimiter_.getRetryAfter(
-                "status:" + clientIp,
-                rateLimitConfig.statusPerMinute,
-                rateLimitConfig.statusWindowSeconds);
+            int retryAfter = getRetryAfter(clientIp, RateLimiter::Endpoint::STATUS);
             return buildResponse(ResponseBuilder::tooManyRequests(
                 "too many requests, please retry after " + std::to_string(retryAfter) + " seconds",
                 retryAfter));
@@ -65,20 +83,20 @@ crow::response RouteHandler::handleStatus(const crow::request& req) {
     }
 }
 
-crow::response RouteHandler::handleLogin(const crow::request& req) {
+void RouteHandler::handleLogin(const crow::request& req, crow::response& res) {
     try {
-        PerformanceMonitor::ScopedRequest metricsGuard("login");
+        // 响应可能在验证线程上完成，计时对象随回调一起延长生命周期
+        auto metricsGuard = std::make_shared<PerformanceMonitor::ScopedRequest>("login");
         const bool isLoopback = isLoopbackRequest(req);
         // 检查速率限制
         std::string clientIp = getClientIp(req);
-        if (!isLoopback && !checkRateLimit(clientIp, "login")) {
+        if (!isLoopback && !checkRateLimit(clientIp, RateLimiter::Endpoint::LOGIN)) {
             LOG_WARNING("Rate limit exceeded for login endpoint from IP: " + clientIp);
-            const auto& rateLimitConfig = Config::getInstance().getRateLimit();
-            int retryAfter = rateLimiter_.getRetryAfter("login:" + clientIp, 
-                           rateLimitConfig.loginPerMinute, rateLimitConfig.loginWindowSeconds);
-            return buildResponse(ResponseBuilder::tooManyRequests(
+            int retryAfter = getRetryAfter(clientIp, RateLimiter::Endpoint::LOGIN);
+            respond(res, buildResponse(ResponseBuilder::tooManyRequests(
                 "too many requests, please retry after " + std::to_string(retryAfter) + " seconds", 
-                retryAfter));
+                retryAfter)));
+            return;
         }
 
         // 解析请求参数
@@ -87,13 +105,15 @@ crow::response RouteHandler::handleLogin(const crow::request& req) {
             requestData = nlohmann::json::parse(req.body);
         } catch (const nlohmann::json::parse_error& e) {
             LOG_WARNING("Invalid JSON in login request: " + std::string(e.what()));
-            return buildResponse(ResponseBuilder::badRequest("invalid json format"));
+            respond(res, buildResponse(ResponseBuilder::badRequest("invalid json format")));
+            return;
         }
 
         // 验证必需参数
         if (!requestData.contains("uid") || !requestData.contains("paste")) {
             LOG_WARNING("Missing required parameters in login request");
-            return buildResponse(ResponseBuilder::badRequest("missing uid or paste parameter"));
+            respond(res, buildResponse(ResponseBuilder::badRequest("missing uid or paste parameter")));
+            return;
         }
 
         std::string uid = requestData["uid"];
@@ -102,16 +122,41 @@ crow::response RouteHandler::handleLogin(const crow::request& req) {
         // 参数基础验证
         if (uid.empty() || paste.empty()) {
             LOG_WARNING("Empty uid or paste in login request");
-            return buildResponse(ResponseBuilder::badRequest("uid and paste cannot be empty"));
-        }
-
-        // 调用Validator验证洛谷身份（本地回环地址请求放行）
-        if (!isLoopback && !Validator::validateLuoguPaste(uid, paste)) {
-            LOG_WARNING("Luogu validation failed for UID: " + uid);
-            return buildResponse(ResponseBuilder::forbidden("authentication failed"));
-        }
+            respond(res, buildResponse(ResponseBuilder::badRequest("uid and paste cannot be empty")));
+            return;
+        }
+
+        // 本地回环地址请求放行
+        if (isLoopback) {
+            respond(res, completeLogin(uid, paste, clientIp));
+            return;
+        }
+
+        // 洛谷身份验证在验证线程上进行，当前工作线程立即返回
+        pasteVerifier_.verifyAsync(uid, paste,
+            [this, &res, uid, paste, clientIp, metricsGuard](PasteVerifier::Verdict verdict) {
+                if (verdict == PasteVerifier::Verdict::OVERLOADED) {
+                    respond(res, buildResponse(ResponseBuilder::serviceUnavailable("authentication busy, retry later")));
+                    return;
+                }
+                if (verdict != PasteVerifier::Verdict::ACCEPTED) {
+                    LOG_WARNING("Luogu validation failed for UID: " + uid);
+                    respond(res, buildResponse(ResponseBuilder::forbidden("authentication failed")));
+                    return;
+                }
+                respond(res, completeLogin(uid, paste, clientIp));
+            });
+    }
+    catch (const std::exception& e) {
+        respond(res, handleException(e));
+    }
+}
 
-        // 调用PlayerManager登录
+crow::response RouteHandler::completeLogin(const std::string& uid,
+                                           const std::string& paste,
+                                           const std::string& clientIp) {
+    try {
+        // 调用PlayerManager登录（身份已验证）
         std::string key = playerManager_->login(uid, paste);
         if (key.empty()) {
             LOG_ERROR("PlayerManager login failed for UID: " + uid);
@@ -131,9 +176,9 @@ crow::response RouteHandler::handleLogin(const crow::request& req) {
     }
 }
 
-crow::response RouteHandler::handleJoin(const crow::request& req) {
+void RouteHandler::handleJoin(const crow::request& req, crow::response& res) {
     try {
-        PerformanceMonitor::ScopedRequest metricsGuard("join");
+        auto metricsGuard = std::make_shared<PerformanceMonitor::ScopedRequest>("join");
         const bool isLoopback = isLoopbackRequest(req);
         // 1. 解析请求参数
         nlohmann::json requestData;
@@ -141,13 +186,15 @@ crow::response RouteHandler::handleJoin(const crow::request& req) {
             requestData = nlohmann::json::parse(req.body);
         } catch (const nlohmann::json::parse_error& e) {
             LOG_WARNING("Invalid JSON in join request: " + std::string(e.what()));
-            return buildResponse(ResponseBuilder::badRequest("invalid json format"));
+            respond(res, buildResponse(ResponseBuilder::badRequest("invalid json format")));
+            return;
         }
 
         // 2. 验证必需参数
         if (!requestData.contains("key") || !requestData.contains("name")) {
             LOG_WARNING("Missing required parameters in join request");
-            return buildResponse(ResponseBuilder::badRequest("missing key or name parameter"));
+            respond(res, buildResponse(ResponseBuilder::badRequest("missing key or name parameter")));
+            return;
         }
 
         std::string key = requestData["key"];
@@ -157,142 +204,135 @@ crow::response RouteHandler::handleJoin(const crow::request& req) {
         // 3. 参数基础验证
         if (key.empty()) {
             LOG_WARNING("Empty key in join request");
-            return buildResponse(ResponseBuilder::badRequest("key cannot be empty"));
+            respond(res, buildResponse(ResponseBuilder::badRequest("key cannot be empty")));
+            return;
         }
 
         if (name.empty()) {
             LOG_WARNING("Empty name in join request");
-            return buildResponse(ResponseBuilder::badRequest("name cannot be empty"));
+            respond(res, buildResponse(ResponseBuilder::badRequest("name cannot be empty")));
+            return;
         }
 
         // 4. 验证 key 有效性
         std::string uid;
         if (!playerManager_->validateKey(key, uid)) {
             LOG_WARNING("Invalid key in join request: " + key);
-            return buildResponse(ResponseBuilder::unauthorized("invalid key"));
+            respond(res, buildResponse(ResponseBuilder::unauthorized("invalid key")));
+            return;
         }
 
         // 5. 速率限制检查（基于 key）
-        if (!isLoopback && !checkRateLimit(key, "join")) {
+        if (!isLoopback && !checkRateLimit(key, RateLimiter::Endpoint::JOIN)) {
             LOG_WARNING("Rate limit exceeded for join endpoint, key: " + key);
-            const auto& rateLimitConfig = Config::getInstance().getRateLimit();
-            int retryAfter = rateLimiter_.getRetryAfter("join:" + key, 
-                           rateLimitConfig.joinPerMinute, rateLimitConfig.joinWindowSeconds);
-            return buildResponse(ResponseBuilder::tooManyRequests(
+            int retryAfter = getRetryAfter(key, RateLimiter::Endpoint::JOIN);
+            respond(res, buildResponse(ResponseBuilder::tooManyRequests(
                 "too many requests, please retry after " + std::to_string(retryAfter) + " seconds", 
-                retryAfter));
+                retryAfter)));
+            return;
         }
 
         // 6. 生成随机颜色（如未提供）
         // PlayerManager::join 方法会处理颜色生成和验证
 
-        // 7. 调用 PlayerManager 加入游戏
-        auto joinResult = playerManager_->join(key, name, color);
+        // 7. 调用 PlayerManager 加入游戏（uid 已在步骤 4 校验，避免重复查询）
+        auto joinResult = playerManager_->join(key, uid, name, color);
         
         if (!joinResult.success) {
             LOG_WARNING("Join failed for UID " + uid + ": " + joinResult.errorMsg);
             
             // 根据错误信息返回适当的HTTP状态码
             if (joinResult.errorMsg.find("already in game") != std::string::npos) {
-                return buildResponse(ResponseBuilder::conflict(joinResult.errorMsg));
+                respond(res, buildResponse(ResponseBuilder::conflict(joinResult.errorMsg)));
             } else if (joinResult.errorMsg.find("Invalid") != std::string::npos) {
-                return buildResponse(ResponseBuilder::badRequest(joinResult.errorMsg));
+                respond(res, buildResponse(ResponseBuilder::badRequest(joinResult.errorMsg)));
             } else {
-                return buildResponse(ResponseBuilder::internalError(joinResult.errorMsg));
+                respond(res, buildResponse(ResponseBuilder::internalError(joinResult.errorMsg)));
             }
+            return;
         }
 
         // 8. 获取玩家对象
         auto player = playerManager_->getPlayerById(joinResult.playerId);
         if (!player) {
             LOG_ERROR("Failed to get player after join: " + joinResult.playerId);
-            return buildResponse(ResponseBuilder::internalError("failed to retrieve player data"));
-        }
-
-        // 9. 初始化蛇的位置
-        const auto& gameConfig = Config::getInstance().getGame();
-        const int safeRadius = 5; // 安全半径，确保周围没有其他蛇
-        
-        // 获取安全的初始位置
-        Point spawnPos = mapManager_->getRandomSafePosition(
-            playerManager_->getAllPlayers(), 
-            safeRadius
-        );
-        
-        // 初始化蛇并设置无敌回合数
-        player->initSnake(spawnPos, gameConfig.initialSnakeLength);
-        player->getSnake().setInvincibleRounds(gameConfig.invincibleRounds);
-        
-        // 设置随机初始方向
-        std::vector<Direction> directions = {Direction::UP, Direction::DOWN, Direction::LEFT, Direction::RIGHT};
-        Direction initialDirection = directions[rand() % directions.size()];
-        player->getSnake().setDirection(initialDirection);
-
-        // 10. 将玩家添加到游戏管理器
-        if (!gameManager_->addPlayer(player)) {
-            LOG_ERROR("Failed to add player to game: " + joinResult.playerId);
-            playerManager_->removePlayer(joinResult.playerId);
-            return buildResponse(ResponseBuilder::internalError("failed to join game"));
+            respond(res, buildResponse(ResponseBuilder::internalError("failed to retrieve player data")));
+            return;
+        }
+
+        // 9. 排队：下一回合开始时与同批加入者一起分配出生点并加入，
+        //    该回合发布后在派发线程上以共享的地图快照响应
+        const std::string token = joinResult.token;
+        const std::string playerId = joinResult.playerId;
+        const bool queued = gameManager_->queueJoin(player,
+            [this, &res, metricsGuard, player, token, playerId](bool joined) {
+                if (!joined) {
+                    LOG_WARNING("Join not applied for player: " + playerId);
+                    respond(res, buildResponse(ResponseBuilder::serviceUnavailable("no safe spawn position, please retry")));
+                    return;
+                }
+                respond(res, joinResponse(token, playerId, player->getSnake().getCurrentDirection()));
+                LOG_INFO("Player successfully joined: PlayerId=" + playerId);
+            });
+        if (!queued) {
+            playerManager_->removePlayer(playerId);
+            respond(res, buildResponse(ResponseBuilder::serviceUnavailable("game is not running")));
         }
-
-        // 11. 获取初始地图状态
-        GameState currentState = gameManager_->getGameState();
-        nlohmann::json mapStateJson = currentState.toJson();
-
-        // 12. 构造成功响应
-        nlohmann::json data = {
-            {"token", joinResult.token},
-            {"id", joinResult.playerId},
-            {"initial_direction", DirectionUtils::toString(initialDirection)},
-            {"map_state", mapStateJson}
-        };
-
-        LOG_INFO("Player successfully joined: UID=" + uid + ", Name=" + name + 
-                 ", PlayerId=" + joinResult.playerId + ", Token=" + joinResult.token);
-        
-        return buildResponse(ResponseBuilder::success(data));
     }
     catch (const std::exception& e) {
-        return handleException(e);
+        respond(res, handleException(e));
     }
 }
 
 crow::response RouteHandler::handleGetMap(const crow::request& req) {
     try {
         PerformanceMonitor::ScopedRequest metricsGuard("map");
-        // 直接获取游戏状态，无需token验证
-        GameState currentState = gameManager_->getGameState();
-        nlohmann::json mapStateJson = currentState.toJson();
-        
-        // 5. 构造响应
-        nlohmann::json data = {
-            {"map_state", mapStateJson}
-        };
+        // 无需token验证；同一状态版本共享一次序列化结果
+        crow::response res;
+        res.set_header("Content-Type", "application/json");
+        res.body = "{\"code\":0,\"data\":{\"map_state\":" + *mapStateBody() + "},\"msg\":\"success\"}";
+        res.code = 200;
         
         LOG_DEBUG("Map state requested (no token required)");
-        return buildResponse(ResponseBuilder::success(data));
+        return res;
     }
     catch (const std::exception& e) {
         return handleException(e);
     }
 }
 
-crow::response RouteHandler::handleGetMapDelta(const crow::request& req) {
+void RouteHandler::handleGetMapDelta(const crow::request& req, crow::response& res) {
     try {
-        PerformanceMonitor::ScopedRequest metricsGuard("map_delta");
-        // 直接获取增量状态，无需token验证或任何参数
-        nlohmann::json deltaStateJson = gameManager_->getDeltaState();
-        
-        // 构造响应
-        nlohmann::json data = {
-            {"delta_state", deltaStateJson}
-        };
-        
-        LOG_DEBUG("Delta map state requested (no token required)");
-        return buildResponse(ResponseBuilder::success(data));
+        auto metricsGuard = std::make_shared<PerformanceMonitor::ScopedRequest>("map_delta");
+        // 无 after_round：直接返回当前增量状态，无需token验证
+        const char* afterParam = req.url_params.get("after_round");
+        if (afterParam == nullptr) {
+            respond(res, deltaResponse());
+            return;
+        }
+
+        int afterRound = 0;
+        try {
+            afterRound = std::stoi(afterParam);
+        } catch (...) {
+            respond(res, buildResponse(ResponseBuilder::badRequest("invalid after_round")));
+            return;
+        }
+
+        int timeoutMs = defaultLongPollTimeoutMs();
+        if (const char* timeoutParam = req.url_params.get("timeout_ms")) {
+            try {
+                timeoutMs = clampLongPollTimeoutMs(std::stoi(timeoutParam));
+            } catch (...) {
+                respond(res, buildResponse(ResponseBuilder::badRequest("invalid timeout_ms")));
+                return;
+            }
+        }
+
+        respondDeltaAfterRound(res, afterRound, timeoutMs, metricsGuard);
     }
     catch (const std::exception& e) {
-        return handleException(e);
+        respond(res, handleException(e));
     }
 }
 
@@ -308,72 +348,194 @@ crow::response RouteHandler::handleMove(const crow::request& req) {
             return buildResponse(ResponseBuilder::badRequest("invalid json format"));
         }
 
-        // 2. 验证必需参数
-        if (!requestData.contains("token") || !requestData.contains("direction")) {
-            LOG_WARNING("Missing required parameters in move request");
-            return buildResponse(ResponseBuilder::badRequest("missing token or direction parameter"));
-        }
-
-        std::string token = requestData["token"];
-        std::string directionStr = requestData["direction"];
+        int appliedAfterRound = 0;
+        return submitMoveRequest(requestData, appliedAfterRound);
+    }
+    catch (const std::exception& e) {
+        return handleException(e);
+    }
+}
 
-        // 3. 参数基础验证
-        if (token.empty()) {
-            LOG_WARNING("Empty token in move request");
-            return buildResponse(ResponseBuilder::badRequest("token cannot be empty"));
+void RouteHandler::handleStep(const crow::request& req, crow::response& res) {
+    try {
+        auto metricsGuard = std::make_shared<PerformanceMonitor::ScopedRequest>("step");
+        nlohmann::json requestData;
+        try {
+            requestData = nlohmann::json::parse(req.body);
+        } catch (const nlohmann::json::parse_error& e) {
+            LOG_WARNING("Invalid JSON in step request: " + std::string(e.what()));
+            respond(res, buildResponse(ResponseBuilder::badRequest("invalid json format")));
+            return;
         }
 
-        if (directionStr.empty()) {
-            LOG_WARNING("Empty direction in move request");
-            return buildResponse(ResponseBuilder::badRequest("direction cannot be empty"));
+        int timeoutMs = defaultLongPollTimeoutMs();
+        if (requestData.contains("timeout_ms")) {
+            if (!requestData["timeout_ms"].is_number_integer()) {
+                respond(res, buildResponse(ResponseBuilder::badRequest("invalid timeout_ms")));
+                return;
+            }
+            timeoutMs = clampLongPollTimeoutMs(requestData["timeout_ms"].get<int>());
         }
 
-        // 4. 验证 token
-        std::string playerId;
-        if (!playerManager_->validateToken(token, playerId)) {
-            LOG_WARNING("Invalid token in move request: " + token);
-            return buildResponse(ResponseBuilder::unauthorized("invalid token"));
+        // 与 /api/game/move 相同的校验与提交；失败时直接返回相同的错误
+        int appliedAfterRound = 0;
+        crow::response moved = submitMoveRequest(requestData, appliedAfterRound);
+        if (moved.code != 200) {
+            respond(res, std::move(moved));
+            return;
         }
 
-        // 检查玩家是否在游戏中
-        auto player = playerManager_->getPlayerById(playerId);
-        if (!player) {
-            LOG_WARNING("Player not found in move request: " + playerId);
-            return buildResponse(ResponseBuilder::notFound("player not in game"));
-        }
+        // 等到执行这次移动的回合推进后返回新回合的增量状态
+        respondDeltaAfterRound(res, appliedAfterRound, timeoutMs, metricsGuard);
+    }
+    catch (const std::exception& e) {
+        respond(res, handleException(e));
+    }
+}
 
-        // 5. 验证方向
-        Direction direction;
+crow::response RouteHandler::handleMoves(const crow::request& req) {
+    try {
+        PerformanceMonitor::ScopedRequest metricsGuard("moves");
+        nlohmann::json requestData;
         try {
-            direction = DirectionUtils::fromString(directionStr);
-        } catch (const std::invalid_argument& e) {
-            LOG_WARNING("Invalid direction in move request: " + directionStr);
-            return buildResponse(ResponseBuilder::badRequest("invalid direction"));
+            requestData = nlohmann::json::parse(req.body);
+        } catch (const nlohmann::json::parse_error& e) {
+            LOG_WARNING("Invalid JSON in moves request: " + std::string(e.what()));
+            return buildResponse(ResponseBuilder::badRequest("invalid json format"));
         }
 
-        // 方向不能是 NONE
-        if (direction == Direction::NONE) {
-            LOG_WARNING("Direction cannot be NONE in move request");
-            return buildResponse(ResponseBuilder::badRequest("invalid direction"));
+        if (!requestData.contains("moves") || !requestData["moves"].is_array()) {
+            return buildResponse(ResponseBuilder::badRequest("missing moves array"));
+        }
+        const auto& entries = requestData["moves"];
+        const int maxBatch = Config::getInstance().getServer().moveBatchMaxSize;
+        if (entries.size() > static_cast<std::size_t>(maxBatch)) {
+            return buildResponse(ResponseBuilder::badRequest(
+                "too many moves in one request (max " + std::to_string(maxBatch) + ")"));
+        }
+
+        // 1. 逐条校验（token 探测不持有移动锁），合法条目进入批次
+        nlohmann::json results = nlohmann::json::array();
+        std::vector<std::pair<std::string, Direction>> batch;
+        std::vector<std::size_t> batchIndex;
+        batch.reserve(entries.size());
+        batchIndex.reserve(entries.size());
+        for (std::size_t i = 0; i < entries.size(); ++i) {
+            std::string playerId;
+            Direction direction = Direction::NONE;
+            nlohmann::json error;
+            if (!parseMoveEntry(entries[i], playerId, direction, error)) {
+                results.push_back({{"code", error["code"]}, {"msg", error["msg"]}});
+                continue;
+            }
+            results.push_back(nullptr);
+            batch.emplace_back(std::move(playerId), direction);
+            batchIndex.push_back(i);
+        }
+
+        // 2. 一次加锁写入移动缓冲区
+        const std::vector<bool> accepted = gameManager_->submitMoves(batch);
+        int acceptedCount = 0;
+        for (std::size_t k = 0; k < batch.size(); ++k) {
+            if (accepted[k]) {
+                ++acceptedCount;
+                results[batchIndex[k]] = {{"code", 0}, {"msg", "success"}};
+            } else {
+                results[batchIndex[k]] = {{"code", 429}, {"msg", "move already submitted this round"}};
+            }
         }
 
-        // 6. 提交移动指令到游戏管理器（GameManager 会检查是否重复提交）
-        if (!gameManager_->submitMove(playerId, direction)) {
-            LOG_WARNING("Move already submitted this round for player: " + playerId);
-            return buildResponse(ResponseBuilder::tooManyRequests(
-                "move already submitted this round", 0));
-        }
+        LOG_DEBUG("Batch moves submitted: " + std::to_string(acceptedCount) + "/" +
+                  std::to_string(entries.size()) + " accepted");
 
-        LOG_DEBUG("Move submitted successfully: Player=" + playerId + 
-                 ", Direction=" + directionStr + ", Token=" + token);
-        
-        return buildResponse(ResponseBuilder::success());
+        nlohmann::json data = {
+            {"accepted", acceptedCount},
+            {"results", std::move(results)}
+        };
+        return buildResponse(ResponseBuilder::success(data));
     }
     catch (const std::exception& e) {
         return handleException(e);
     }
 }
 
+bool RouteHandler::parseMoveEntry(const nlohmann::json& entry, std::string& playerId,
+                                  Direction& direction, nlohmann::json& error) {
+    // 1. 验证必需参数
+    if (!entry.is_object() || !entry.contains("token") || !entry.contains("direction")) {
+        LOG_WARNING("Missing required parameters in move request");
+        error = ResponseBuilder::badRequest("missing token or direction parameter");
+        return false;
+    }
+    if (!entry["token"].is_string() || !entry["direction"].is_string()) {
+        error = ResponseBuilder::badRequest("token and direction must be strings");
+        return false;
+    }
+
+    const std::string& token = entry["token"].get_ref<const std::string&>();
+    const std::string& directionStr = entry["direction"].get_ref<const std::string&>();
+
+    // 2. 参数基础验证
+    if (token.empty()) {
+        LOG_WARNING("Empty token in move request");
+        error = ResponseBuilder::badRequest("token cannot be empty");
+        return false;
+    }
+
+    if (directionStr.empty()) {
+        LOG_WARNING("Empty direction in move request");
+        error = ResponseBuilder::badRequest("direction cannot be empty");
+        return false;
+    }
+
+    // 3. 验证 token（一次分片哈希探测同时取得玩家对象）
+    auto player = playerManager_->getPlayerByToken(token);
+    if (!player) {
+        LOG_WARNING("Invalid token in move request: " + token);
+        error = ResponseBuilder::unauthorized("invalid token");
+        return false;
+    }
+    playerId = player->getId();
+
+    // 4. 验证方向
+    try {
+        direction = DirectionUtils::fromString(directionStr);
+    } catch (const std::invalid_argument& e) {
+        LOG_WARNING("Invalid direction in move request: " + directionStr);
+        error = ResponseBuilder::badRequest("invalid direction");
+        return false;
+    }
+
+    // 方向不能是 NONE
+    if (direction == Direction::NONE) {
+        LOG_WARNING("Direction cannot be NONE in move request");
+        error = ResponseBuilder::badRequest("invalid direction");
+        return false;
+    }
+    return true;
+}
+
+crow::response RouteHandler::submitMoveRequest(const nlohmann::json& requestData, int& appliedAfterRound) {
+    std::string playerId;
+    Direction direction = Direction::NONE;
+    nlohmann::json error;
+    if (!parseMoveEntry(requestData, playerId, direction, error)) {
+        return buildResponse(error);
+    }
+
+    // 提交移动指令到游戏管理器（GameManager 会检查是否重复提交）
+    if (!gameManager_->submitMove(playerId, direction, &appliedAfterRound)) {
+        LOG_WARNING("Move already submitted this round for player: " + playerId);
+        return buildResponse(ResponseBuilder::tooManyRequests(
+            "move already submitted this round", 0));
+    }
+
+    LOG_DEBUG("Move submitted successfully: Player=" + playerId +
+             ", Direction=" + DirectionUtils::toString(direction));
+
+    return buildResponse(ResponseBuilder::success());
+}
+
 crow::response RouteHandler::handleLeaderboard(const crow::request& req) {
     try {
         PerformanceMonitor::ScopedRequest metricsGuard("leaderboard");
@@ -540,6 +702,52 @@ crow::response RouteHandler::handleMetrics(const crow::request& req) {
     }
 }
 
+crow::response RouteHandler::handleDebugTrace(const crow::request& req) {
+    try {
+        // 调试端点：录制期间会占用一个工作线程，仅允许本机访问
+        if (!isLoopbackRequest(req)) {
+            return buildResponse(ResponseBuilder::forbidden("debug endpoint is loopback only"));
+        }
+
+        constexpr int kDefaultRounds = 5;
+        constexpr int kMaxRounds = 100;
+        int rounds = kDefaultRounds;
+        if (const char* roundsParam = req.url_params.get("rounds")) {
+            try {
+                rounds = std::stoi(roundsParam);
+            } catch (...) {
+                return buildResponse(ResponseBuilder::badRequest("invalid rounds"));
+            }
+        }
+        if (rounds < 1 || rounds > kMaxRounds) {
+            return buildResponse(ResponseBuilder::badRequest(
+                "rounds must be between 1 and " + std::to_string(kMaxRounds)));
+        }
+
+        auto& tracer = TraceRecorder::getInstance();
+        if (!tracer.beginCapture(rounds)) {
+            return buildResponse(ResponseBuilder::conflict("trace capture already in progress"));
+        }
+
+        // 等待 rounds 个完整回合（首个回合需等到下一个回合边界），另留出余量
+        const int roundTimeMs = Config::getInstance().getGame().roundTimeMs;
+        const auto timeout = std::chrono::milliseconds(
+            static_cast<long long>(roundTimeMs) * (rounds + 2) + 1000);
+        LOG_INFO("Trace capture started for " + std::to_string(rounds) + " rounds");
+        nlohmann::json trace = tracer.finishCapture(timeout);
+
+        crow::response res;
+        res.set_header("Content-Type", "application/json");
+        res.set_header("Content-Disposition", "attachment; filename=\"snake-trace.json\"");
+        res.body = trace.dump();
+        res.code = 200;
+        return res;
+    }
+    catch (const std::exception& e) {
+        return handleException(e);
+    }
+}
+
 std::string RouteHandler::getClientIp(const crow::request& req) {
     // 尝试从X-Forwarded-For头获取真实IP
     auto xff_it = req.headers.find("X-Forwarded-For");
@@ -586,44 +794,160 @@ bool RouteHandler::isLoopbackRequest(const crow::request& req) const {
     return isLoopbackAddress(req.remote_ip_address);
 }
 
-bool RouteHandler::checkRateLimit(const std::string& key, const std::string& endpoint) {
+bool RouteHandler::rateLimitParams(RateLimiter::Endpoint endpoint, int& maxRequests,
+                                   std::chrono::milliseconds& window) const {
     const auto& rateLimitConfig = Config::getInstance().getRateLimit();
-    if (!rateLimitConfig.enabled) {
+    switch (endpoint) {
+        case RateLimiter::Endpoint::STATUS:
+            maxRequests = rateLimitConfig.statusPerMinute;
+            window = std::chrono::seconds(rateLimitConfig.statusWindowSeconds);
+            return true;
+        case RateLimiter::Endpoint::LOGIN:
+            maxRequests = rateLimitConfig.loginPerMinute;
+            window = std::chrono::seconds(rateLimitConfig.loginWindowSeconds);
+            return true;
+        case RateLimiter::Endpoint::JOIN:
+            maxRequests = rateLimitConfig.joinPerMinute;
+            window = std::chrono::seconds(rateLimitConfig.joinWindowSeconds);
+            return true;
+        case RateLimiter::Endpoint::MOVE:
+            // move端点限制：每回合 movePerRound 次（按毫秒计，避免回合时长被截断）
+            maxRequests = rateLimitConfig.movePerRound;
+            window = std::chrono::milliseconds(Config::getInstance().getGame().roundTimeMs);
+            return true;
+        case RateLimiter::Endpoint::MAP:
+            maxRequests = rateLimitConfig.mapPerSecond;
+            window = std::chrono::seconds(rateLimitConfig.mapWindowSeconds);
+            return true;
+        default:
+            return false;
+    }
+}
+
+bool RouteHandler::checkRateLimit(const std::string& key, RateLimiter::Endpoint endpoint) {
+    if (!Config::getInstance().getRateLimit().enabled) {
         return true;
     }
-    
-    if (endpoint == "status") {
-        return rateLimiter_.checkLimit(
-            "status:" + key,
-            rateLimitConfig.statusPerMinute,
-            rateLimitConfig.statusWindowSeconds);
-    }
-    else if (endpoint == "login") {
-        return rateLimiter_.checkLimit(
-            "login:" + key,
-            rateLimitConfig.loginPerMinute,
-            rateLimitConfig.loginWindowSeconds);
-    }
-    else if (endpoint == "join") {
-        return rateLimiter_.checkLimit(
-            "join:" + key,
-            rateLimitConfig.joinPerMinute,
-            rateLimitConfig.joinWindowSeconds);
-    }
-    else if (endpoint == "move") {
-        // move端点限制：每回合1次
-        int roundTime = Config::getInstance().getGame().roundTimeMs / 1000;
-        return rateLimiter_.checkLimit("move:" + key, rateLimitConfig.movePerRound, roundTime);
-    }
-    else if (endpoint == "map") {
-        return rateLimiter_.checkLimit(
-            "map:" + key,
-            rateLimitConfig.mapPerSecond,
-            rateLimitConfig.mapWindowSeconds);
+
+    int maxRequests = 0;
+    std::chrono::milliseconds window{0};
+    if (!rateLimitParams(endpoint, maxRequests, window)) {
+        // 默认允许通过
+        return true;
     }
-    
-    // 默认允许通过
-    return true;
+    return rateLimiter_.checkLimit(endpoint, key, maxRequests, window);
+}
+
+int RouteHandler::getRetryAfter(const std::string& key, RateLimiter::Endpoint endpoint) const {
+    int maxRequests = 0;
+    std::chrono::milliseconds window{0};
+    if (!rateLimitParams(endpoint, maxRequests, window)) {
+        return 0;
+    }
+    return rateLimiter_.getRetryAfter(endpoint, key, maxRequests, window);
+}
+
+std::shared_ptr<const std::string> RouteHandler::deltaResponseBody() {
+    // 先读版本号再序列化：序列化期间状态变化时，缓存的版本号偏旧，下一次请求会重新生成
+    const std::uint64_t version = gameManager_->getStateVersion();
+    {
+        std::lock_guard<std::mutex> lock(deltaCacheMutex_);
+        if (deltaCacheBody_ && deltaCacheVersion_ == version) {
+            return deltaCacheBody_;
+        }
+    }
+
+    nlohmann::json data = {
+        {"delta_state", gameManager_->getDeltaState()}
+    };
+    auto body = std::make_shared<const std::string>(ResponseBuilder::success(data).dump());
+
+    std::lock_guard<std::mutex> lock(deltaCacheMutex_);
+    deltaCacheVersion_ = version;
+    deltaCacheBody_ = body;
+    return body;
+}
+
+std::shared_ptr<const std::string> RouteHandler::mapStateBody() {
+    // 与增量缓存相同：先读版本号再序列化，状态变化后的下一次请求重新生成
+    const std::uint64_t version = gameManager_->getStateVersion();
+    {
+        std::lock_guard<std::mutex> lock(mapCacheMutex_);
+        if (mapCacheBody_ && mapCacheVersion_ == version) {
+            return mapCacheBody_;
+        }
+    }
+
+    auto body = std::make_shared<const std::string>(gameManager_->getMapState().dump());
+
+    std::lock_guard<std::mutex> lock(mapCacheMutex_);
+    mapCacheVersion_ = version;
+    mapCacheBody_ = body;
+    return body;
+}
+
+crow::response RouteHandler::joinResponse(const std::string& token, const std::string& playerId,
+                                          Direction initialDirection) {
+    try {
+        // 只序列化本玩家的字段，map_state 直接拼接共享快照
+        nlohmann::json data = {
+            {"token", token},
+            {"id", playerId},
+            {"initial_direction", DirectionUtils::toString(initialDirection)}
+        };
+        std::string dataBody = data.dump();
+        dataBody.pop_back();
+
+        crow::response res;
+        res.set_header("Content-Type", "application/json");
+        res.body = "{\"code\":0,\"data\":" + dataBody + ",\"map_state\":" + *mapStateBody() +
+                   "},\"msg\":\"success\"}";
+        res.code = 200;
+        return res;
+    }
+    catch (const std::exception& e) {
+        return handleException(e);
+    }
+}
+
+crow::response RouteHandler::deltaResponse() {
+    try {
+        crow::response res;
+        res.set_header("Content-Type", "application/json");
+        res.body = *deltaResponseBody();
+        res.code = 200;
+        return res;
+    }
+    catch (const std::exception& e) {
+        return handleException(e);
+    }
+}
+
+int RouteHandler::defaultLongPollTimeoutMs() const {
+    // 默认最多等待两个回合，上限由配置决定
+    return clampLongPollTimeoutMs(std::max(100, Config::getInstance().getGame().roundTimeMs * 2));
+}
+
+int RouteHandler::clampLongPollTimeoutMs(int timeoutMs) const {
+    return std::max(0, std::min(timeoutMs, Config::getInstance().getServer().longPollMaxTimeoutMs));
+}
+
+void RouteHandler::respondDeltaAfterRound(crow::response& res, int afterRound, int timeoutMs,
+                                          std::shared_ptr<PerformanceMonitor::ScopedRequest> metricsGuard) {
+    // 回合推进或超时都返回当时的增量状态，客户端以 round 字段判断是否已推进
+    const bool parked = gameManager_->waitForRoundAfter(afterRound, std::chrono::milliseconds(timeoutMs),
+        [this, &res, metricsGuard](bool) {
+            respond(res, deltaResponse());
+        });
+    if (!parked) {
+        LOG_WARNING("Long-poll waiter limit reached, rejecting request");
+        respond(res, buildResponse(ResponseBuilder::serviceUnavailable("too many waiting requests")));
+    }
+}
+
+void RouteHandler::respond(crow::response& res, crow::response&& built) {
+    res = std::move(built);
+    res.end();
 }
 
 crow::response RouteHandler::buildResponse(const nlohmann::json& jsonData) {
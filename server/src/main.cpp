@@ -1,9 +1,14 @@
 #include <crow.h>
 #include <crow/middlewares/cors.h>
 #include <nlohmann/json.hpp>
+#include <asio.hpp>
+#include <csignal>
 #include <iostream>
 #include <memory>
+#include <mutex>
+#include <stdexcept>
 #include <future>
+#include <thread>
 
 #include "models/Config.h"
 #include "managers/GameManager.h"
@@ -32,8 +37,15 @@ int main(int argc, char* argv[]) {
     }
 
     // 初始化日志系统
-    Logger::getInstance().setLevel(Logger::Level::INFO);
-    Logger::getInstance().enableConsole(true);
+    {
+        const auto& logConfig = config.getLogging();
+        auto& logger = Logger::getInstance();
+        logger.setLevel(Logger::parseLevel(logConfig.level));
+        logger.enableConsole(logConfig.console);
+        if (!logConfig.file.empty()) {
+            logger.setLogFile(logConfig.file, logConfig.maxBytes, logConfig.maxFiles);
+        }
+    }
     LOG_INFO("Snake Game Server initializing...");
 
     // 初始化性能监控
@@ -43,7 +55,6 @@ int main(int argc, char* argv[]) {
         monitorConfig.enabled = perfConfig.enabled;
         monitorConfig.sampleRate = perfConfig.sampleRate;
         monitorConfig.windowSeconds = perfConfig.windowSeconds;
-        monitorConfig.maxSamples = perfConfig.maxSamples;
         monitorConfig.logEnabled = perfConfig.logEnabled;
         monitorConfig.logIntervalSeconds = perfConfig.logIntervalSeconds;
         monitorConfig.logPath = perfConfig.logPath;
@@ -108,6 +119,40 @@ int main(int argc, char* argv[]) {
         routeHandler->registerRoutes(httpsApp);
     }
 
+    // 关闭顺序：先停止游戏循环与验证线程，让停放中的长轮询、step、加入与登录请求
+    // 在 Crow 仍在运行时结束响应，最后再停止 Crow。
+    // 因此不使用 Crow 自带的信号处理（它会直接停止 Crow），改为自行监听 SIGINT/SIGTERM
+    std::once_flag shutdownOnce;
+    auto shutdown = [&]() {
+        std::call_once(shutdownOnce, [&]() {
+            gameManager->stop();
+            routeHandler->shutdown();
+            httpApp.stop();
+            httpsApp.stop();
+        });
+    };
+
+    httpApp.signal_clear();
+    httpsApp.signal_clear();
+    asio::io_context signalContext;
+    asio::signal_set signals(signalContext, SIGINT, SIGTERM);
+    signals.async_wait([&](const asio::error_code& ec, int signalNumber) {
+        if (ec) {
+            return;
+        }
+        LOG_INFO("Received signal " + std::to_string(signalNumber) + ", shutting down...");
+        shutdown();
+    });
+    std::thread signalThread([&signalContext]() {
+        signalContext.run();
+    });
+    auto stopSignalThread = [&]() {
+        signalContext.stop();
+        if (signalThread.joinable()) {
+            signalThread.join();
+        }
+    };
+
     // 启动游戏循环
     gameManager->start();
     LOG_INFO("Game loop started");
@@ -143,8 +188,7 @@ int main(int argc, char* argv[]) {
             httpsApp.stop();
             httpsFuture.get();
 #else
-            LOG_ERROR("Crow was built without SSL support, cannot enable HTTPS");
-            return 1;
+            throw std::runtime_error("Crow was built without SSL support, cannot enable HTTPS");
 #endif
         } else if (serverConfig.httpEnabled) {
             LOG_INFO("Server starting HTTP on " + serverConfig.bindAddress + ":" +
@@ -175,23 +219,28 @@ int main(int argc, char* argv[]) {
                     .run();
             }
 #else
-            LOG_ERROR("Crow was built without SSL support, cannot enable HTTPS");
-            return 1;
+            throw std::runtime_error("Crow was built without SSL support, cannot enable HTTPS");
 #endif
         }
     } catch (const std::exception& e) {
         LOG_ERROR(std::string("Server failed to start: ") + e.what());
-        gameManager->stop();
+        shutdown();
+        stopSignalThread();
         PerformanceMonitor::getInstance().stop();
+        Logger::getInstance().shutdown();
         return 1;
     }
 
-    // 关闭游戏循环
-    gameManager->stop();
+    // Crow 因其他原因退出时同样走完关闭流程（已关闭则为空操作）
+    shutdown();
+    stopSignalThread();
     LOG_INFO("Server shutdown complete");
 
     // 关闭性能监控
     PerformanceMonitor::getInstance().stop();
 
+    // 写出剩余日志
+    Logger::getInstance().shutdown();
+
     return 0;
 }
@@ -1,11 +1,16 @@
 #include "../include/managers/GameManager.h"
 #include "../include/managers/MapManager.h"
 #include "../include/managers/PlayerManager.h"
+#include "../include/managers/HouseBotManager.h"
 #include "../include/models/Config.h"
 #include "../include/database/LeaderboardManager.h"
 #include "../include/utils/Logger.h"
 #include "../include/utils/PerformanceMonitor.h"
+#include "../include/utils/TraceRecorder.h"
+#include "../include/utils/TickScheduler.h"
+#include <algorithm>
 #include <chrono>
+#include <cstdlib>
 #include <thread>
 
 namespace snake {
@@ -19,6 +24,49 @@ std::unique_lock<std::mutex> lockWithMetrics(std::mutex& mutex, const char* name
     PerformanceMonitor::getInstance().recordLockWait(name, waitMs);
     return lock;
 }
+
+// 出生点周围不允许有蛇身的半径
+constexpr int kSpawnSafeRadius = 5;
+
+snake_rules::Move toRuleMove(Direction direction) {
+    switch (direction) {
+        case Direction::UP: return snake_rules::MOVE_UP;
+        case Direction::DOWN: return snake_rules::MOVE_DOWN;
+        case Direction::LEFT: return snake_rules::MOVE_LEFT;
+        case Direction::RIGHT: return snake_rules::MOVE_RIGHT;
+        default: return snake_rules::MOVE_NONE;
+    }
+}
+
+Direction fromRuleMove(snake_rules::Move move) {
+    switch (move) {
+        case snake_rules::MOVE_UP: return Direction::UP;
+        case snake_rules::MOVE_DOWN: return Direction::DOWN;
+        case snake_rules::MOVE_LEFT: return Direction::LEFT;
+        case snake_rules::MOVE_RIGHT: return Direction::RIGHT;
+        default: return Direction::NONE;
+    }
+}
+
+// 排行榜写入计时：累计到本回合合计值，录制中时输出 trace 区间
+class LeaderboardWriteTimer {
+public:
+    explicit LeaderboardWriteTimer(double& totalMs)
+        : totalMs_(totalMs)
+        , span_("leaderboard", "tick")
+        , start_(std::chrono::steady_clock::now()) {
+    }
+
+    ~LeaderboardWriteTimer() {
+        totalMs_ += std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - start_).count();
+    }
+
+private:
+    double& totalMs_;
+    TraceRecorder::ScopedSpan span_;
+    std::chrono::steady_clock::time_point start_;
+};
 }
 
 GameManager::GameManager(std::shared_ptr<MapManager> mapManager,
@@ -27,7 +75,24 @@ GameManager::GameManager(std::shared_ptr<MapManager> mapManager,
     : mapManager_(mapManager)
     , playerManager_(playerManager)
     , leaderboardManager_(leaderboardManager)
+    , roundWaiters_(static_cast<std::size_t>(Config::getInstance().getServer().longPollMaxWaiters))
     , running_(false) {
+    const auto& config = Config::getInstance().getGame();
+    scheduler_ = std::make_unique<TickScheduler>(
+        std::chrono::milliseconds(config.roundTimeMs),
+        std::chrono::microseconds(config.tickSpinUs));
+    arenaMode_ = config.arenaMode;
+    if (arenaMode_) {
+        scheduler_->setMinInterval(std::chrono::milliseconds(config.arenaMinIntervalMs));
+        LOG_INFO("Arena mode enabled: rounds advance once all live players have moved (min interval " +
+                 std::to_string(config.arenaMinIntervalMs) + "ms)");
+    }
+    if (Config::getInstance().getHouseBots().enabled) {
+        houseBots_ = std::make_unique<HouseBotManager>(mapManager_, playerManager_);
+        if (houseBots_->empty()) {
+            houseBots_.reset();
+        }
+    }
     LOG_INFO("GameManager initialized");
 }
 
@@ -41,15 +106,12 @@ void GameManager::start() {
         return;
     }
     
-    // 初始化下一回合的时间戳
+    // 重置回合调度器，并发布第一个回合的截止时间
     {
+        scheduler_->reset();
         auto lock = lockWithMetrics(stateMutex_, "GameManager.state");
-        const auto& config = Config::getInstance().getGame();
-        auto nextRoundStart = std::chrono::system_clock::now() + 
-                              std::chrono::milliseconds(config.roundTimeMs);
-        long long nextRoundTimestamp = std::chrono::duration_cast<std::chrono::milliseconds>(
-            nextRoundStart.time_since_epoch()).count();
-        gameState_.setNextRoundTimestamp(nextRoundTimestamp);
+        gameState_.setNextRoundTimestamp(scheduler_->deadlineUnixMs());
+        roundWaiters_.publish(gameState_.getCurrentRound());
     }
 
     // 初始化占用索引（仅在启动时构建一次）
@@ -66,6 +128,16 @@ void GameManager::start() {
         }
     }
     
+    {
+        const int round = getCurrentRound();
+        auto lock = lockWithMetrics(movesMutex_, "GameManager.moves");
+        movesAppliedAfterRound_ = round;
+    }
+
+    if (arenaMode_) {
+        refreshArenaRoster();
+    }
+
     running_ = true;
     gameThread_ = std::thread(&GameManager::gameLoop, this);
     LOG_INFO("GameManager started, game loop thread launched");
@@ -78,10 +150,24 @@ void GameManager::stop() {
     
     LOG_INFO("Stopping GameManager...");
     running_ = false;
+    scheduler_->interrupt();
     
     if (gameThread_.joinable()) {
         gameThread_.join();
     }
+    // 停放中的长轮询请求以超时方式返回
+    roundWaiters_.shutdown();
+
+    // 尚未处理的加入请求：撤销会话并通知失败
+    std::vector<PendingJoin> pending;
+    {
+        std::lock_guard<std::mutex> lock(joinsMutex_);
+        pending.swap(pendingJoins_);
+    }
+    for (auto& join : pending) {
+        playerManager_->removePlayer(join.player->getId());
+        join.callback(false);
+    }
     
     LOG_INFO("GameManager stopped");
 }
@@ -93,52 +179,139 @@ bool GameManager::isRunning() const {
 void GameManager::tick() {
     LOG_DEBUG("Tick - Round: " + std::to_string(gameState_.getCurrentRound()));
     
+    leaderboardWriteMs_ = 0.0;
+
     // 0. 交换移动指令缓冲区：将上回合收到的指令准备执行
     {
+        PerformanceMonitor::ScopedPhase phase("swapMoves");
         auto lock = lockWithMetrics(movesMutex_, "GameManager.moves");
         double pendingSize = static_cast<double>(currentMoves_.size());
         nextMoves_ = std::move(currentMoves_);
         currentMoves_.clear();
+        // 本回合推进到 round+1；此后收到的指令在再下一次推进中执行
+        movesAppliedAfterRound_ = gameState_.getCurrentRound() + 1;
+        if (arenaMode_) {
+            // 交换前到达的提前推进请求已由本回合消费
+            arenaMoved_ = 0;
+            scheduler_->cancelEarlyWake();
+        }
         PerformanceMonitor::getInstance().setGauge("moves_current_size", 0.0);
         PerformanceMonitor::getInstance().setGauge("moves_pending_size", pendingSize);
     }
     
-    // 0.5. 清空上一回合的增量追踪数据（为本回合的变化记录做准备）
+    // 0.1. 清空上一回合的增量追踪数据（为本回合的变化记录做准备）
+    //      须在加入之前执行，否则本回合加入的玩家不会出现在 joined_players 中
     {
+        PerformanceMonitor::ScopedPhase phase("clearDelta");
         auto lock = lockWithMetrics(stateMutex_, "GameManager.state");
         gameState_.clearDeltaTracking();
     }
+
+    // 0.2. 批量加入：为排队的玩家分配互不冲突的出生点
+    {
+        PerformanceMonitor::ScopedPhase phase("applyJoins");
+        applyJoins();
+    }
+
+    // 0.3. 内置 Bot：加入/重生，并基于上回合结束时的状态写入本回合指令
+    if (houseBots_) {
+        PerformanceMonitor::ScopedPhase phase("houseBots");
+        runHouseBots();
+    }
     
     // 1. 处理所有玩家的移动（应用上回合提交的方向指令）
-    processMovements();
+    {
+        PerformanceMonitor::ScopedPhase phase("processMovements");
+        processMovements();
+    }
     
     // 2. 检测碰撞（无敌玩家不会死亡）
-    checkCollisions();
+    {
+        PerformanceMonitor::ScopedPhase phase("checkCollisions");
+        checkCollisions();
+    }
     
     // 3. 处理食物收集
-    handleFoodCollection();
+    {
+        PerformanceMonitor::ScopedPhase phase("handleFoodCollection");
+        handleFoodCollection();
+    }
     
     // 4. 生成新食物
-    generateFood();
+    {
+        PerformanceMonitor::ScopedPhase phase("generateFood");
+        generateFood();
+    }
     
     // 5. 更新无敌状态（在回合结束时递减，这样无敌1回合的玩家在整个回合内都保持无敌）
-    updateInvincibility();
+    {
+        PerformanceMonitor::ScopedPhase phase("updateInvincibility");
+        updateInvincibility();
+    }
     
     // 6. 增加回合数和时间戳
     {
+        PerformanceMonitor::ScopedPhase phase("advanceRound");
         auto lock = lockWithMetrics(stateMutex_, "GameManager.state");
         gameState_.incrementRound();
         gameState_.updateTimestamp();
+        stateVersion_.fetch_add(1, std::memory_order_release);
         // 注意：增量追踪数据在这个回合内保持有效，
         // 将在下一个回合开始时清空（在步骤0之后）
     }
+
+    // 7. 回收死亡超过保留期的玩家（保留期内客户端仍可用旧 token 查询到自己的死亡）
+    {
+        PerformanceMonitor::ScopedPhase phase("compactPlayers");
+        compactDeadPlayers();
+    }
+
+    // 排行榜写入分散在碰撞和食物阶段内，按回合合计上报（本回合没有写入时不记样本，避免 0 值拉低分位数）
+    if (leaderboardWriteMs_ > 0.0) {
+        PerformanceMonitor::getInstance().observePhase("leaderboard", leaderboardWriteMs_);
+    }
+
+    if (arenaMode_) {
+        refreshArenaRoster();
+    }
     
     LOG_DEBUG("Tick completed - Round: " + std::to_string(gameState_.getCurrentRound()));
 }
 
-bool GameManager::submitMove(const std::string& playerId, Direction direction) {
+bool GameManager::submitMove(const std::string& playerId, Direction direction, int* appliedAfterRound) {
     auto lock = lockWithMetrics(movesMutex_, "GameManager.moves");
     
+    if (!queueMoveLocked(playerId, direction)) {
+        return false;
+    }
+    if (appliedAfterRound) {
+        *appliedAfterRound = movesAppliedAfterRound_;
+    }
+    PerformanceMonitor::getInstance().setGauge("moves_current_size", static_cast<double>(currentMoves_.size()));
+
+    // 竞技场模式：所有存活玩家都已提交时唤醒回合线程提前推进
+    if (arenaMode_ && !arenaRoster_.empty() && arenaMoved_ >= arenaRoster_.size()) {
+        scheduler_->wakeEarly();
+    }
+    return true;
+}
+
+std::vector<bool> GameManager::submitMoves(const std::vector<std::pair<std::string, Direction>>& moves) {
+    std::vector<bool> accepted(moves.size(), false);
+    auto lock = lockWithMetrics(movesMutex_, "GameManager.moves");
+
+    for (std::size_t i = 0; i < moves.size(); ++i) {
+        accepted[i] = queueMoveLocked(moves[i].first, moves[i].second);
+    }
+    PerformanceMonitor::getInstance().setGauge("moves_current_size", static_cast<double>(currentMoves_.size()));
+
+    if (arenaMode_ && !arenaRoster_.empty() && arenaMoved_ >= arenaRoster_.size()) {
+        scheduler_->wakeEarly();
+    }
+    return accepted;
+}
+
+bool GameManager::queueMoveLocked(const std::string& playerId, Direction direction) {
     // 检查玩家是否已经提交过移动指令
     if (currentMoves_.find(playerId) != currentMoves_.end()) {
         LOG_WARNING("Player " + playerId + " already submitted a move this round");
@@ -147,7 +320,9 @@ bool GameManager::submitMove(const std::string& playerId, Direction direction) {
     
     // 记录移动指令到当前缓冲区（下回合执行）
     currentMoves_[playerId] = direction;
-    PerformanceMonitor::getInstance().setGauge("moves_current_size", static_cast<double>(currentMoves_.size()));
+    if (arenaMode_ && arenaRoster_.count(playerId) > 0) {
+        ++arenaMoved_;
+    }
     LOG_DEBUG("Player " + playerId + " submitted move: " + DirectionUtils::toString(direction) + " (will execute next round)");
     return true;
 }
@@ -167,6 +342,17 @@ nlohmann::json GameManager::getDeltaState() const {
     return gameState_.toDeltaJson();
 }
 
+std::uint64_t GameManager::getStateVersion() const {
+    return stateVersion_.load(std::memory_order_acquire);
+}
+
+bool GameManager::waitForRoundAfter(int afterRound, std::chrono::milliseconds timeout,
+                                    RoundWaitList::Callback callback) {
+    const bool parked = roundWaiters_.add(afterRound, RoundWaitList::Clock::now() + timeout, std::move(callback));
+    PerformanceMonitor::getInstance().setGauge("long_poll_waiters", static_cast<double>(roundWaiters_.size()));
+    return parked;
+}
+
 bool GameManager::addPlayer(std::shared_ptr<Player> player) {
     if (!player) {
         LOG_ERROR("Cannot add null player");
@@ -174,7 +360,10 @@ bool GameManager::addPlayer(std::shared_ptr<Player> player) {
     }
     
     auto lock = lockWithMetrics(stateMutex_, "GameManager.state");
-    
+    return addPlayerLocked(player);
+}
+
+bool GameManager::addPlayerLocked(std::shared_ptr<Player> player) {
     // 检查玩家是否已存在
     if (gameState_.getPlayer(player->getId()) != nullptr) {
         LOG_WARNING("Player " + player->getId() + " already in game");
@@ -184,6 +373,7 @@ bool GameManager::addPlayer(std::shared_ptr<Player> player) {
     gameState_.addPlayer(player);
     // 追踪玩家加入
     gameState_.trackPlayerJoined(player->getId());
+    stateVersion_.fetch_add(1, std::memory_order_release);
     // 初始化占用索引
     if (player->isInGame() && player->getSnake().isAlive()) {
         addSnakeToOccupancy(player->getSnake());
@@ -208,9 +398,11 @@ void GameManager::removePlayer(const std::string& playerId) {
     auto player = gameState_.getPlayer(playerId);
     if (player != nullptr) {
         if (player->isInGame() && player->getSnake().isAlive()) {
+            createSnakeDeathDrops(player->getSnake().getBlocks()); // 添加蛇被移除时掉落的食物
             removeSnakeFromOccupancy(player->getSnake());
         }
         gameState_.removePlayer(playerId);
+        stateVersion_.fetch_add(1, std::memory_order_release);
         LOG_INFO("Player " + playerId + " removed from game");
     }
 }
@@ -233,141 +425,285 @@ void GameManager::respawnPlayer(const std::string& playerId) {
     player->initSnake(spawnPos, config.initialSnakeLength);
     player->setInGame(true);
     addSnakeToOccupancy(player->getSnake());
+    stateVersion_.fetch_add(1, std::memory_order_release);
     
     LOG_INFO("Player " + playerId + " respawned at (" + 
              std::to_string(spawnPos.x) + ", " + std::to_string(spawnPos.y) + ")");
 }
 
+nlohmann::json GameManager::getMapState() const {
+    nlohmann::json j;
+    auto lock = lockWithMetrics(stateMutex_, "GameManager.state");
+    gameState_.toJsonOptimized(j);
+    return j;
+}
+
+bool GameManager::queueJoin(std::shared_ptr<Player> player, JoinCallback callback) {
+    if (!player) {
+        LOG_ERROR("Cannot queue null player");
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(joinsMutex_);
+    // 与 stop() 的清理共用 joinsMutex_：停止后不再接受，停止前排入的由 stop() 统一回调
+    if (!running_) {
+        return false;
+    }
+    pendingJoins_.push_back(PendingJoin{std::move(player), std::move(callback)});
+    PerformanceMonitor::getInstance().setGauge("joins_pending", static_cast<double>(pendingJoins_.size()));
+    return true;
+}
+
+void GameManager::applyJoins() {
+    std::vector<PendingJoin> batch;
+    {
+        std::lock_guard<std::mutex> lock(joinsMutex_);
+        batch.swap(pendingJoins_);
+    }
+    auto& monitor = PerformanceMonitor::getInstance();
+    monitor.setGauge("joins_pending", 0.0);
+    monitor.setGauge("join_batch_size", static_cast<double>(batch.size()));
+    if (batch.empty()) {
+        return;
+    }
+
+    // 一次加锁处理整批：每条蛇加入后即计入占用索引，后续出生点自然避开
+    std::vector<bool> joined(batch.size(), false);
+    int round = 0;
+    {
+        auto lock = lockWithMetrics(stateMutex_, "GameManager.state");
+        round = gameState_.getCurrentRound();
+        for (std::size_t i = 0; i < batch.size(); ++i) {
+            joined[i] = spawnPlayerLocked(batch[i].player);
+        }
+    }
+
+    // 本回合发布后由派发线程统一回调，响应共享同一份地图快照
+    const auto deadline = RoundWaitList::Clock::now() +
+        std::chrono::milliseconds(Config::getInstance().getServer().longPollMaxTimeoutMs);
+    for (std::size_t i = 0; i < batch.size(); ++i) {
+        if (!joined[i]) {
+            playerManager_->removePlayer(batch[i].player->getId());
+            batch[i].player->setInGame(false);
+        }
+        const bool ok = joined[i];
+        roundWaiters_.add(round, deadline,
+            [callback = std::move(batch[i].callback), ok](bool advanced) {
+                callback(ok && advanced);
+            },
+            false);
+    }
+}
+
+bool GameManager::spawnPlayerLocked(const std::shared_ptr<Player>& player) {
+    const Point spawnPos = mapManager_->getRandomSafePositionFast(occupiedCounts_, kSpawnSafeRadius);
+    if (spawnPos.isNull()) {
+        LOG_WARNING("No safe spawn position for player " + player->getId());
+        return false;
+    }
+
+    // 初始化蛇、无敌回合与随机初始方向
+    const auto& config = Config::getInstance().getGame();
+    static const Direction kDirections[] = {Direction::UP, Direction::DOWN, Direction::LEFT, Direction::RIGHT};
+    player->initSnake(spawnPos, config.initialSnakeLength);
+    player->getSnake().setInvincibleRounds(config.invincibleRounds);
+    player->getSnake().setDirection(kDirections[std::rand() % 4]);
+    return addPlayerLocked(player);
+}
+
+void GameManager::runHouseBots() {
+    auto moveLock = lockWithMetrics(movesMutex_, "GameManager.moves");
+    auto stateLock = lockWithMetrics(stateMutex_, "GameManager.state");
+
+    for (auto& player : houseBots_->prepareJoins(gameState_)) {
+        if (!spawnPlayerLocked(player)) {
+            houseBots_->cancelJoin(player->getId());
+            playerManager_->removePlayer(player->getId());
+        }
+    }
+    // 新加入的 Bot 已在 GameState 中，决策视图与客户端看到的是同一局面
+    houseBots_->decideMoves(gameState_, nextMoves_);
+    PerformanceMonitor::getInstance().setGauge("house_bots_active", static_cast<double>(houseBots_->activeCount()));
+}
+
+void GameManager::refreshArenaRoster() {
+    std::unordered_set<std::string> roster;
+    {
+        auto lock = lockWithMetrics(stateMutex_, "GameManager.state");
+        for (const auto& player : gameState_.getPlayers()) {
+            // 内置 Bot 在回合开始时才写入指令，不参与提前推进的等待
+            if (player && houseBots_ && houseBots_->isHouseBot(player->getId())) {
+                continue;
+            }
+            if (player && player->isInGame() && player->getSnake().isAlive()) {
+                roster.insert(player->getId());
+            }
+        }
+    }
+
+    // 回合执行期间已有玩家为下一回合提交了移动，需要计入
+    auto lock = lockWithMetrics(movesMutex_, "GameManager.moves");
+    arenaRoster_.swap(roster);
+    arenaMoved_ = 0;
+    for (const auto& move : currentMoves_) {
+        if (arenaRoster_.count(move.first) > 0) {
+            ++arenaMoved_;
+        }
+    }
+    PerformanceMonitor::getInstance().setGauge("arena_roster_size", static_cast<double>(arenaRoster_.size()));
+    if (!arenaRoster_.empty() && arenaMoved_ >= arenaRoster_.size()) {
+        scheduler_->wakeEarly();
+    } else {
+        // 回合执行期间旧名单的提交可能已请求提前推进；新名单未齐时撤销，新加入的玩家保有完整的提交窗口
+        scheduler_->cancelEarlyWake();
+    }
+}
+
 void GameManager::gameLoop() {
     const auto& config = Config::getInstance().getGame();
-    const auto roundTime = std::chrono::milliseconds(config.roundTimeMs);
+    auto& monitor = PerformanceMonitor::getInstance();
+    auto& tracer = TraceRecorder::getInstance();
+    std::uint64_t earlyTicks = 0;
     
     LOG_INFO("Game loop started with round time: " + std::to_string(config.roundTimeMs) + "ms");
     
     while (running_) {
+        // 等待到本回合的绝对截止时间（已在上一回合结束时发布给客户端）
+        if (!scheduler_->waitForDeadline()) {
+            break;
+        }
+        if (scheduler_->lastWakeEarly()) {
+            monitor.setGauge("arena_early_ticks", static_cast<double>(++earlyTicks));
+        } else {
+            monitor.observeTickJitter(static_cast<double>(scheduler_->lastLateness().count()) / 1000.0);
+        }
         auto startTime = std::chrono::steady_clock::now();
         
         // 执行一个回合
+        tracer.onTickStart(getCurrentRound());
         tick();
+        tracer.onTickEnd();
         
-        // 计算下一回合的开始时间（系统时钟）
-        auto nextRoundStart = std::chrono::system_clock::now() + roundTime;
-        long long nextRoundTimestamp = std::chrono::duration_cast<std::chrono::milliseconds>(
-            nextRoundStart.time_since_epoch()).count();
-        
-        // 更新游戏状态中的下一回合时间戳
+        // 截止时间按固定网格推进，回合耗时不会累积成漂移；先发布再进入等待
+        auto endTime = std::chrono::steady_clock::now();
+        const int missed = scheduler_->advance(endTime);
+        int publishedRound = 0;
         {
             auto lock = lockWithMetrics(stateMutex_, "GameManager.state");
-            gameState_.setNextRoundTimestamp(nextRoundTimestamp);
+            gameState_.setNextRoundTimestamp(scheduler_->deadlineUnixMs());
+            publishedRound = gameState_.getCurrentRound();
+            // 时间戳也是状态的一部分：使推进阶段之后生成的响应缓存失效
+            stateVersion_.fetch_add(1, std::memory_order_release);
         }
+        // 唤醒等待本回合的长轮询请求（由派发线程回调，不占用回合线程）
+        roundWaiters_.publish(publishedRound);
         
-        // 计算已用时间
-        auto endTime = std::chrono::steady_clock::now();
-        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(endTime - startTime);
-        PerformanceMonitor::getInstance().observeRoundDuration(static_cast<double>(elapsed.count()));
-        
-        // 等待剩余时间
-        if (elapsed < roundTime) {
-            std::this_thread::sleep_for(roundTime - elapsed);
-        } else {
+        auto elapsed = std::chrono::duration<double, std::milli>(endTime - startTime);
+        monitor.observeRoundDuration(elapsed.count());
+        if (missed > 0) {
+            monitor.recordTickOverrun(missed);
             LOG_WARNING("Tick took longer than round time: " + 
-                       std::to_string(elapsed.count()) + "ms");
+                       std::to_string(static_cast<long long>(elapsed.count())) + "ms, skipped " +
+                       std::to_string(missed) + " deadline(s)");
         }
     }
     
     LOG_INFO("Game loop ended");
 }
 
+void GameManager::loadRules() {
+    ruleSlots_.clear();
+    ruleSlotIndex_.clear();
+    int longest = 1;
+    for (const auto& player : gameState_.getPlayers()) {
+        if (!player || !player->isInGame() || !player->getSnake().isAlive()) {
+            continue;
+        }
+        ruleSlotIndex_[player->getId()] = static_cast<int>(ruleSlots_.size());
+        ruleSlots_.push_back(player);
+        longest = std::max(longest, player->getSnake().getLength());
+    }
+
+    // 一步最多成长一格；形状不够时按两倍余量重新分配，平时 clear() 复用缓冲区
+    const int slots = static_cast<int>(ruleSlots_.size());
+    const int width = mapManager_->getWidth();
+    const int height = mapManager_->getHeight();
+    if (!rules_.hasShape(width, height, slots, longest + 1)) {
+        rules_.reset(width, height, std::max(16, slots * 2), std::max(64, (longest + 1) * 2));
+    } else {
+        rules_.clear();
+    }
+
+    for (int slot = 0; slot < slots; ++slot) {
+        const auto& snake = ruleSlots_[slot]->getSnake();
+        ruleBody_.clear();
+        for (const auto& block : snake.getBlocks()) {
+            ruleBody_.emplace_back(block.x, block.y);
+        }
+        rules_.placeSnake(slot, ruleBody_.data(), static_cast<int>(ruleBody_.size()),
+                          toRuleMove(snake.getCurrentDirection()),
+                          snake.getInvincibleRounds(), snake.getGrowthPending());
+    }
+    for (const auto& food : gameState_.getFoodSet()) {
+        rules_.addFood(food.x, food.y);
+    }
+    rules_.setRound(gameState_.getCurrentRound());
+    ruleMoves_.assign(static_cast<std::size_t>(rules_.maxSnakes()), snake_rules::MOVE_NONE);
+}
+
 void GameManager::processMovements() {
     auto moveLock = lockWithMetrics(movesMutex_, "GameManager.moves");
     auto stateLock = lockWithMetrics(stateMutex_, "GameManager.state");
 
-    // 清空上一回合的自撞预判
-    pendingSelfCollisions_.clear();
-    
-    // 第一阶段：应用上回合提交的方向指令
+    loadRules();
+
+    // 第一阶段：把上回合提交的方向指令交给引擎（反向指令由引擎忽略）
     for (auto& [playerId, direction] : nextMoves_) {
-        auto player = gameState_.getPlayer(playerId);
-        if (!player || !player->isInGame()) {
+        auto it = ruleSlotIndex_.find(playerId);
+        if (it == ruleSlotIndex_.end()) {
             continue;
         }
-        
-        auto& snake = player->getSnake();
-        Direction currentDir = snake.getCurrentDirection();
-        
-        // 验证方向：不能反向移动
-        if (currentDir != Direction::NONE && 
+
+        Direction currentDir = ruleSlots_[it->second]->getSnake().getCurrentDirection();
+        if (currentDir != Direction::NONE &&
             DirectionUtils::isOpposite(currentDir, direction)) {
             LOG_WARNING("Player " + playerId + " tried to move in opposite direction");
             continue;
         }
-        
-        // 只设置方向，稍后统一移动
-        snake.setDirection(direction);
+
+        ruleMoves_[it->second] = toRuleMove(direction);
         LOG_DEBUG("Player " + playerId + " direction set to " + DirectionUtils::toString(direction));
     }
-    
-    // 第二阶段：预判自撞（使用移动前的身体位置）
-    for (auto& player : gameState_.getPlayers()) {
-        if (!player->isInGame()) {
-            continue;
-        }
 
+    // 第二阶段：引擎推进一步（自撞预判、移动、碰撞、死亡掉落、进食、无敌递减）
+    rules_.step(ruleMoves_.data());
+
+    // 第三阶段：按引擎结果移动存活的蛇；死亡的蛇保持原样，由碰撞阶段移除
+    for (int slot = 0; slot < static_cast<int>(ruleSlots_.size()); ++slot) {
+        auto& player = ruleSlots_[slot];
         auto& snake = player->getSnake();
-        Direction dir = snake.getCurrentDirection();
-        if (dir == Direction::NONE) {
+        snake.setDirection(fromRuleMove(rules_.direction(slot)));
+        if (!rules_.alive(slot) || snake.getCurrentDirection() == Direction::NONE) {
             continue;
         }
 
-        Point nextHead = snake.getHead();
-        switch (dir) {
-            case Direction::UP:
-                nextHead.y -= 1;
-                break;
-            case Direction::DOWN:
-                nextHead.y += 1;
-                break;
-            case Direction::LEFT:
-                nextHead.x -= 1;
-                break;
-            case Direction::RIGHT:
-                nextHead.x += 1;
-                break;
-            case Direction::NONE:
-                break;
-        }
-
-        if (snake.collidesWithSelf(nextHead)) {
-            pendingSelfCollisions_.insert(player->getId());
-        }
-    }
-
-    // 第三阶段：所有蛇统一移动（包括没有提交新方向的蛇，它们会沿用当前方向）
-    for (auto& player : gameState_.getPlayers()) {
-        if (!player->isInGame()) {
-            continue;
-        }
-        
-        auto& snake = player->getSnake();
-        if (snake.getCurrentDirection() != Direction::NONE) {
-            auto result = snake.moveWithDelta();
-            if (result.moved) {
-                // 新头加入占用索引
-                occupiedCounts_[result.newHead] += 1;
-
-                // 旧尾移除占用索引
-                if (result.tailRemoved) {
-                    auto it = occupiedCounts_.find(result.removedTail);
-                    if (it != occupiedCounts_.end()) {
-                        it->second -= 1;
-                        if (it->second <= 0) {
-                            occupiedCounts_.erase(it);
-                        }
+        const snake_rules::Cell head = rules_.head(slot);
+        auto result = snake.applyMove(Point(head.x, head.y), rules_.length(slot) > snake.getLength());
+        if (result.moved) {
+            // 新头加入占用索引
+            occupiedCounts_[result.newHead] += 1;
+
+            // 旧尾移除占用索引
+            if (result.tailRemoved) {
+                auto it = occupiedCounts_.find(result.removedTail);
+                if (it != occupiedCounts_.end()) {
+                    it->second -= 1;
+                    if (it->second <= 0) {
+                        occupiedCounts_.erase(it);
                     }
                 }
             }
-            LOG_DEBUG("Player " + player->getId() + " moved");
         }
+        LOG_DEBUG("Player " + player->getId() + " moved");
     }
     
     // 清空下回合的移动指令缓冲区
@@ -377,168 +713,118 @@ void GameManager::processMovements() {
 
 void GameManager::checkCollisions() {
     auto lock = lockWithMetrics(stateMutex_, "GameManager.state");
-    
-    // 先收集所有碰撞信息，避免顺序依赖
-    std::vector<std::pair<std::string, MapManager::CollisionType>> collisions;
 
-    // 构建位置 -> 玩家ID列表，用于击杀归因（只包含非无敌玩家）
-    std::unordered_map<Point, std::vector<std::string>, PointHash> occupancyByPlayer;
-    for (const auto& player : gameState_.getPlayers()) {
-        if (!player || !player->isInGame()) {
-            continue;
-        }
-        // 无敌玩家的身体不作为障碍物
-        if (player->getSnake().getInvincibleRounds() > 0) {
+    // 按槽位顺序处理引擎判定的死亡（击杀者已由引擎按同样顺序归因）
+    bool anyDeath = false;
+    for (int slot = 0; slot < static_cast<int>(ruleSlots_.size()); ++slot) {
+        const snake_rules::DeathCause cause = rules_.deathCause(slot);
+        if (cause == snake_rules::DEATH_NONE) {
             continue;
         }
-        for (const auto& block : player->getSnake().getBlocks()) {
-            occupancyByPlayer[block].push_back(player->getId());
+        anyDeath = true;
+        auto& player = ruleSlots_[slot];
+
+        const int killerSlot = rules_.killer(slot);
+        if (killerSlot >= 0 && leaderboardManager_) {
+            // 击杀者可能在本回合稍后的槽位中同样死亡，此时取其死亡时的长度
+            const auto& killerPlayer = ruleSlots_[killerSlot];
+            const int killerLength = rules_.alive(killerSlot) ? rules_.length(killerSlot)
+                                                               : rules_.deathLength(killerSlot);
+            LeaderboardWriteTimer timer(leaderboardWriteMs_);
+            leaderboardManager_->updateOnRound(
+                killerPlayer->getUid(),
+                killerPlayer->getName(),
+                gameState_.getCurrentRound(),
+                killerLength,
+                0,
+                1
+            );
         }
-    }
-    
-    // 重新构建仅包含非无敌玩家的占用索引
-    std::unordered_map<Point, int, PointHash> validOccupiedCounts;
-    for (const auto& player : gameState_.getPlayers()) {
-        if (!player || !player->isInGame()) {
-            continue;
+        if (leaderboardManager_) {
+            LeaderboardWriteTimer timer(leaderboardWriteMs_);
+            leaderboardManager_->updateOnDeath(
+                player->getUid(),
+                player->getName(),
+                gameState_.getCurrentRound(),
+                rules_.deathLength(slot)
+            );
         }
-        // 无敌玩家的身体不参与碰撞检测
-        if (player->getSnake().getInvincibleRounds() > 0) {
-            continue;
-        }
-        for (const auto& block : player->getSnake().getBlocks()) {
-            validOccupiedCounts[block] += 1;
+
+        // 从占用索引中移除该蛇（须在 setInGame(false) 清空蛇身之前）
+        removeSnakeFromOccupancy(player->getSnake());
+        player->setInGame(false);
+        // 追踪玩家死亡
+        gameState_.trackPlayerDied(player->getId());
+        deadPlayers_.emplace_back(gameState_.getCurrentRound(), player->getId());
+        std::string reason;
+        switch (cause) {
+            case snake_rules::DEATH_WALL: reason = "hit wall"; break;
+            case snake_rules::DEATH_SELF: reason = "hit self"; break;
+            case snake_rules::DEATH_SNAKE: reason = "hit other snake"; break;
+            default: reason = "unknown"; break;
         }
+        LOG_INFO("Player " + player->getId() + " (" + player->getName() + ") died: " + reason);
     }
-    
-    // 检查每个玩家的碰撞
-    for (auto& player : gameState_.getPlayers()) {
-        if (!player->isInGame()) {
-            continue;
-        }
-        
-        auto& snake = player->getSnake();
-        const Point& head = snake.getHead();
-        
-        // 跳过无敌玩家
-        if (snake.getInvincibleRounds() > 0) {
-            continue;
-        }
 
-        const bool pendingSelfCollision =
-            (pendingSelfCollisions_.find(player->getId()) != pendingSelfCollisions_.end());
-        
-        // 检查碰撞（使用仅包含非无敌玩家的空间索引）
-        MapManager::CollisionType collision = MapManager::CollisionType::NONE;
+    if (!anyDeath) {
+        return;
+    }
 
-        if (mapManager_->isOutOfBounds(head)) {
-            collision = MapManager::CollisionType::WALL;
-        } else if (pendingSelfCollision) {
-            collision = MapManager::CollisionType::SELF;
-        } else {
-            auto it = validOccupiedCounts.find(head);
-            if (it != validOccupiedCounts.end() && it->second > 1) {
-                collision = MapManager::CollisionType::OTHER_SNAKE;
-            }
+    // 同步死亡掉落：引擎中有而服务器没有的食物都来自本回合的尸体
+    rules_.forEachFood([this](int x, int y) {
+        const Point p(x, y);
+        if (!gameState_.hasFoodAt(p)) {
+            gameState_.trackFoodAdded(p);
+            gameState_.addFood(Food(p));
         }
-        
-        if (collision != MapManager::CollisionType::NONE) {
-            collisions.push_back({player->getId(), collision});
+    });
+    // 掉落后同回合即被吃掉的食物已不在引擎中，仍先记为新增，再由进食阶段移除
+    for (int slot = 0; slot < static_cast<int>(ruleSlots_.size()); ++slot) {
+        if (!rules_.ate(slot)) {
+            continue;
         }
-    }
-    
-    // 统一处理所有碰撞
-    for (const auto& [playerId, collisionType] : collisions) {
-        auto player = gameState_.getPlayer(playerId);
-        if (player && player->isInGame()) {
-            const int finalLength = player->getSnake().getLength();
-            if (collisionType == MapManager::CollisionType::OTHER_SNAKE && leaderboardManager_) {
-                const Point& head = player->getSnake().getHead();
-                auto it = occupancyByPlayer.find(head);
-                if (it != occupancyByPlayer.end()) {
-                    for (const auto& occupantId : it->second) {
-                        if (occupantId == playerId) {
-                            continue;
-                        }
-                        auto killerPlayer = gameState_.getPlayer(occupantId);
-                        if (!killerPlayer || !killerPlayer->isInGame()) {
-                            continue;
-                        }
-                        leaderboardManager_->updateOnRound(
-                            killerPlayer->getUid(),
-                            killerPlayer->getName(),
-                            gameState_.getCurrentRound(),
-                            killerPlayer->getSnake().getLength(),
-                            0,
-                            1
-                        );
-                        break;
-                    }
-                }
-            }
-            if (leaderboardManager_) {
-                leaderboardManager_->updateOnDeath(
-                    player->getUid(),
-                    player->getName(),
-                    gameState_.getCurrentRound(),
-                    finalLength
-                );
-            }
-
-            player->setInGame(false);
-            // 追踪玩家死亡
-            gameState_.trackPlayerDied(playerId);
-            // 从占用索引中移除该蛇
-            removeSnakeFromOccupancy(player->getSnake());
-            std::string reason;
-            switch(collisionType) {
-                case MapManager::CollisionType::WALL: reason = "hit wall"; break;
-                case MapManager::CollisionType::SELF: reason = "hit self"; break;
-                case MapManager::CollisionType::OTHER_SNAKE: reason = "hit other snake"; break;
-                default: reason = "unknown"; break;
-            }
-            LOG_INFO("Player " + player->getId() + " (" + player->getName() + ") died: " + reason);
+        const snake_rules::Cell head = rules_.head(slot);
+        const Point p(head.x, head.y);
+        if (!gameState_.hasFoodAt(p)) {
+            gameState_.trackFoodAdded(p);
+            gameState_.addFood(Food(p));
         }
     }
-
-    // 清空本回合自撞预判
-    pendingSelfCollisions_.clear();
 }
 
 void GameManager::handleFoodCollection() {
     auto lock = lockWithMetrics(stateMutex_, "GameManager.state");
     
-    // 检查每个玩家是否吃到食物
-    for (auto& player : gameState_.getPlayers()) {
-        if (!player->isInGame()) {
+    // 引擎已判定进食并记下待成长次数，这里同步蛇身、食物与排行榜
+    for (int slot = 0; slot < static_cast<int>(ruleSlots_.size()); ++slot) {
+        if (!rules_.ate(slot)) {
             continue;
         }
-        
-        const Point& head = player->getSnake().getHead();
-        
-        // 检查是否有食物在蛇头位置（O(1)）
-        if (gameState_.hasFoodAt(head)) {
-            // 蛇成长
-            player->getSnake().grow();
-
-            // 追踪食物移除
-            gameState_.trackFoodRemoved(head);
-            // 移除食物
-            gameState_.removeFood(head);
-
-            LOG_INFO("Player " + player->getId() + " ate food at (" +
-                    std::to_string(head.x) + ", " + std::to_string(head.y) + ")");
-
-            if (leaderboardManager_) {
-                leaderboardManager_->updateOnRound(
-                    player->getUid(),
-                    player->getName(),
-                    gameState_.getCurrentRound(),
-                    player->getSnake().getLength(),
-                    1,
-                    0
-                );
-            }
+        auto& player = ruleSlots_[slot];
+        const snake_rules::Cell cell = rules_.head(slot);
+        const Point head(cell.x, cell.y);
+
+        // 蛇成长
+        player->getSnake().grow();
+
+        // 追踪食物移除
+        gameState_.trackFoodRemoved(head);
+        // 移除食物
+        gameState_.removeFood(head);
+
+        LOG_INFO("Player " + player->getId() + " ate food at (" +
+                std::to_string(head.x) + ", " + std::to_string(head.y) + ")");
+
+        if (leaderboardManager_) {
+            LeaderboardWriteTimer timer(leaderboardWriteMs_);
+            leaderboardManager_->updateOnRound(
+                player->getUid(),
+                player->getName(),
+                gameState_.getCurrentRound(),
+                player->getSnake().getLength(),
+                1,
+                0
+            );
         }
     }
 }
@@ -606,8 +892,6 @@ void GameManager::removeSnakeFromOccupancy(const Snake& snake) {
         return;
     }
 
-    createSnakeDeathDrops(snake.getBlocks()); // 添加蛇被移除时掉落的食物
-
     for (const auto& block : snake.getBlocks()) {
         auto it = occupiedCounts_.find(block);
         if (it != occupiedCounts_.end()) {
@@ -619,28 +903,72 @@ void GameManager::removeSnakeFromOccupancy(const Snake& snake) {
     }
 }
 
+void GameManager::compactDeadPlayers() {
+    const int retention = Config::getInstance().getGame().deadPlayerRetentionRounds;
+    std::unordered_set<std::string> reclaimed;
+    std::size_t live = 0;
+    std::size_t retained = 0;
+    {
+        auto lock = lockWithMetrics(stateMutex_, "GameManager.state");
+        const int round = gameState_.getCurrentRound();
+        while (!deadPlayers_.empty() && deadPlayers_.front().first + retention < round) {
+            reclaimed.insert(std::move(deadPlayers_.front().second));
+            deadPlayers_.pop_front();
+        }
+
+        // 一次遍历：排除保留期内被重生的玩家，同时统计存活/保留数量
+        for (const auto& player : gameState_.getPlayers()) {
+            if (player->isInGame()) {
+                ++live;
+                reclaimed.erase(player->getId());
+            } else if (reclaimed.count(player->getId()) == 0) {
+                ++retained;
+            }
+        }
+        if (gameState_.removePlayers(reclaimed) > 0) {
+            stateVersion_.fetch_add(1, std::memory_order_release);
+        }
+    }
+
+    // 会话表分片加锁，无需持有状态锁
+    for (const auto& playerId : reclaimed) {
+        playerManager_->removePlayer(playerId);
+    }
+
+    auto& monitor = PerformanceMonitor::getInstance();
+    monitor.setGauge("players_live", static_cast<double>(live));
+    monitor.setGauge("players_retained", static_cast<double>(retained));
+    monitor.setGauge("sessions_total", static_cast<double>(playerManager_->getPlayerCount()));
+}
+
 void GameManager::updateInvincibility() {
     auto lock = lockWithMetrics(stateMutex_, "GameManager.state");
     
-    // 递减每个玩家的无敌回合数
-    for (auto& player : gameState_.getPlayers()) {
-        if (player->isInGame()) {
-            auto& snake = player->getSnake();
-            if (snake.getInvincibleRounds() > 0) {
-                snake.setInvincibleRounds(snake.getInvincibleRounds() - 1);
-                
-                if (snake.getInvincibleRounds() == 0) {
-                    LOG_INFO("Player " + player->getId() + " invincibility expired");
-                }
+    // 无敌回合数已由引擎在本步末尾递减，这里同步给存活的蛇
+    for (int slot = 0; slot < static_cast<int>(ruleSlots_.size()); ++slot) {
+        if (!rules_.alive(slot)) {
+            continue;
+        }
+        auto& snake = ruleSlots_[slot]->getSnake();
+        if (snake.getInvincibleRounds() > 0) {
+            snake.setInvincibleRounds(rules_.invincibleRounds(slot));
+
+            if (snake.getInvincibleRounds() == 0) {
+                LOG_INFO("Player " + ruleSlots_[slot]->getId() + " invincibility expired");
             }
         }
     }
 }
 
-void GameManager::createSnakeDeathDrops(std::vector<Point> pos)
+void GameManager::createSnakeDeathDrops(const std::deque<Point>& pos)
 {
-    for (auto p : pos)
+    for (const auto& p : pos)
     {
+        // 撞墙死亡时蛇头在界外，界外不掉落食物（与 SnakeRules.hpp 一致）
+        if (!mapManager_->isValidPosition(p))
+        {
+            continue;
+        }
         if (!gameState_.hasFoodAt(p))
         {
             gameState_.trackFoodAdded(p);
@@ -0,0 +1,128 @@
+#include "../include/managers/HouseBotManager.h"
+#include "../include/managers/MapManager.h"
+#include "../include/managers/PlayerManager.h"
+#include "../include/models/Config.h"
+#include "../include/utils/Logger.h"
+#include <algorithm>
+
+namespace snake {
+
+HouseBotManager::HouseBotManager(std::shared_ptr<MapManager> mapManager,
+                                 std::shared_ptr<PlayerManager> playerManager)
+    : mapManager_(std::move(mapManager))
+    , playerManager_(std::move(playerManager)) {
+    const auto& config = Config::getInstance().getHouseBots();
+    if (!config.enabled) {
+        return;
+    }
+    for (std::size_t i = 0; i < config.bots.size(); ++i) {
+        const auto& entry = config.bots[i];
+        Bot bot;
+        bot.name = entry.name;
+        bot.color = entry.color;
+        // 按配置顺序编号，排行榜按 uid 累计
+        bot.uid = "house_" + std::to_string(i + 1);
+        // 策略名已由 Config 校验
+        HouseBotStrategies::parse(entry.strategy, bot.strategy);
+        bots_.push_back(bot);
+    }
+    LOG_INFO("House bots enabled: " + std::to_string(bots_.size()) + " bot(s)");
+}
+
+std::vector<std::shared_ptr<Player>> HouseBotManager::prepareJoins(const GameState& state) {
+    std::vector<std::shared_ptr<Player>> joins;
+    const int round = state.getCurrentRound();
+    const int respawnDelay = Config::getInstance().getHouseBots().respawnDelayRounds;
+
+    for (auto& bot : bots_) {
+        if (!bot.playerId.empty()) {
+            auto player = state.getPlayer(bot.playerId);
+            if (player && player->isInGame()) {
+                continue;
+            }
+            // 死亡（或被移除）：与客户端一样放弃旧会话，等待重生间隔后以新会话加入
+            activeIds_.erase(bot.playerId);
+            bot.playerId.clear();
+            bot.respawnAt = round + respawnDelay;
+        }
+        if (round < bot.respawnAt) {
+            continue;
+        }
+
+        auto joinResult = playerManager_->join("", bot.uid, bot.name, bot.color);
+        if (!joinResult.success) {
+            LOG_WARNING("House bot " + bot.name + " failed to join: " + joinResult.errorMsg);
+            bot.respawnAt = round + std::max(1, respawnDelay);
+            continue;
+        }
+        auto player = playerManager_->getPlayerById(joinResult.playerId);
+        if (!player) {
+            continue;
+        }
+
+        bot.playerId = joinResult.playerId;
+        activeIds_.insert(bot.playerId);
+        joins.push_back(player);
+    }
+    return joins;
+}
+
+void HouseBotManager::cancelJoin(const std::string& playerId) {
+    for (auto& bot : bots_) {
+        if (bot.playerId == playerId) {
+            // 保持 respawnAt 不变，下回合重试
+            activeIds_.erase(bot.playerId);
+            bot.playerId.clear();
+            return;
+        }
+    }
+}
+
+void HouseBotManager::decideMoves(const GameState& state, std::map<std::string, Direction>& moves) {
+    bool viewBuilt = false;
+    for (const auto& bot : bots_) {
+        if (bot.playerId.empty() || moves.count(bot.playerId) > 0) {
+            continue;
+        }
+        auto player = state.getPlayer(bot.playerId);
+        if (!player || !player->isInGame()) {
+            continue;
+        }
+        // 视图每回合只建一次，本回合所有 Bot 共用
+        if (!viewBuilt) {
+            buildView(state);
+            viewBuilt = true;
+        }
+        const Direction dir = strategies_.decide(bot.strategy, bot.playerId);
+        if (dir != Direction::NONE) {
+            moves[bot.playerId] = dir;
+        }
+    }
+}
+
+bool HouseBotManager::isHouseBot(const std::string& playerId) const {
+    return activeIds_.count(playerId) > 0;
+}
+
+void HouseBotManager::buildView(const GameState& state) {
+    strategies_.beginView(mapManager_->getWidth(), mapManager_->getHeight(), state.getCurrentRound());
+    for (const auto& player : state.getPlayers()) {
+        if (!player || !player->isInGame()) {
+            continue;
+        }
+        const auto& snake = player->getSnake();
+        if (!snake.isAlive()) {
+            continue;
+        }
+        body_.clear();
+        for (const auto& block : snake.getBlocks()) {
+            body_.emplace_back(block.x, block.y);
+        }
+        strategies_.addSnake(player->getId(), body_, snake.getInvincibleRounds());
+    }
+    for (const auto& food : state.getFoodSet()) {
+        strategies_.addFood(food.x, food.y);
+    }
+}
+
+} // namespace snake
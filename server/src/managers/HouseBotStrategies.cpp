@@ -0,0 +1,83 @@
+// 本编译单元只包含 bot/ 侧的头文件（客户端 SDK 与策略），不包含服务器的模型头文件
+#include "../include/managers/HouseBotStrategies.h"
+
+#include "CodingSnake.hpp"
+#include "strategies/GluttonStrategy.hpp"
+#include "strategies/InterceptorStrategy.hpp"
+#include "strategies/ParasiteStrategy.hpp"
+#include "strategies/PatrollerStrategy.hpp"
+
+namespace snake {
+
+struct HouseBotStrategies::View {
+    ::GameState state;
+    ::Snake scratch;
+};
+
+HouseBotStrategies::HouseBotStrategies()
+    : view_(new View()) {
+}
+
+HouseBotStrategies::~HouseBotStrategies() = default;
+
+bool HouseBotStrategies::parse(const std::string& name, Strategy& out) {
+    if (name == "glutton") {
+        out = Strategy::GLUTTON;
+    } else if (name == "interceptor") {
+        out = Strategy::INTERCEPTOR;
+    } else if (name == "parasite") {
+        out = Strategy::PARASITE;
+    } else if (name == "patroller") {
+        out = Strategy::PATROLLER;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+void HouseBotStrategies::beginView(int width, int height, int round) {
+    ::GameState& state = view_->state;
+    if (state.getMapWidth() != width || state.getMapHeight() != height) {
+        state.setMapSize(width, height);
+    }
+    state.setCurrentRound(round);
+    state.clearPlayers();
+    state.clearFoods();
+}
+
+void HouseBotStrategies::addSnake(const std::string& id, const std::vector<std::pair<int, int>>& body,
+                                  int invincibleRounds) {
+    if (body.empty()) {
+        return;
+    }
+    ::Snake& snake = view_->scratch;
+    snake.id = id;
+    snake.blocks.clear();
+    for (const auto& cell : body) {
+        snake.blocks.push_back(::Point(cell.first, cell.second));
+    }
+    snake.head = snake.blocks[0];
+    snake.length = static_cast<int>(body.size());
+    snake.invincible_rounds = invincibleRounds;
+    view_->state.addOrUpdatePlayer(snake);
+}
+
+void HouseBotStrategies::addFood(int x, int y) {
+    view_->state.addFood(::Point(x, y));
+}
+
+Direction HouseBotStrategies::decide(Strategy strategy, const std::string& selfId) {
+    ::GameState& state = view_->state;
+    state.setMyId(selfId);
+
+    std::string move;
+    switch (strategy) {
+        case Strategy::GLUTTON: move = bot::decideGlutton(state); break;
+        case Strategy::INTERCEPTOR: move = bot::decideInterceptor(state); break;
+        case Strategy::PARASITE: move = bot::decideParasite(state); break;
+        case Strategy::PATROLLER: move = bot::decidePatroller(state); break;
+    }
+    return DirectionUtils::fromString(move);
+}
+
+} // namespace snake
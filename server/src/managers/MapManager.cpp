@@ -30,7 +30,8 @@ bool MapManager::isOutOfBounds(const Point& pos) const {
     return !isValidPosition(pos);
 }
 
-Point MapManager::getRandomSafePosition(const std::vector<std::shared_ptr<Player>>& players, int safeRadius) {
+template <typename IsSafe>
+Point MapManager::sampleSafePosition(int safeRadius, IsSafe isSafe) {
     const int clampedRadius = std::max(0, safeRadius);
     
     if (width_ <= 0 || height_ <= 0) {
@@ -69,7 +70,7 @@ Point MapManager::getRandomSafePosition(const std::vector<std::shared_ptr<Player
     for (int attempt = 0; attempt < maxAttempts; ++attempt) {
         Point candidate{distX(rng_), distY(rng_)};
         
-        if (isValidPosition(candidate) && isSafeArea(candidate, clampedRadius, players)) {
+        if (isValidPosition(candidate) && isSafe(candidate, clampedRadius)) {
             return candidate;
         }
     }
@@ -78,6 +79,35 @@ Point MapManager::getRandomSafePosition(const std::vector<std::shared_ptr<Player
     return Point::Null();
 }
 
+Point MapManager::getRandomSafePosition(const std::vector<std::shared_ptr<Player>>& players, int safeRadius) {
+    return sampleSafePosition(safeRadius, [&](const Point& candidate, int radius) {
+        return isSafeArea(candidate, radius, players);
+    });
+}
+
+/**
+ * @brief 基于空间索引选取安全出生点
+ * @param occupiedCounts 蛇身占用计数（GameManager 的空间索引）
+ * @param safeRadius 出生点周围（切比雪夫距离）不允许有蛇身的半径
+ *
+ * 说明：
+ * - 每次采样只查询 (2r+1)^2 个格子，与蛇的数量和长度无关
+ * - 同一批次内先加入的蛇已计入索引，后续出生点自然避开它们
+ */
+Point MapManager::getRandomSafePositionFast(const std::unordered_map<Point, int, PointHash>& occupiedCounts,
+                                            int safeRadius) {
+    return sampleSafePosition(safeRadius, [&](const Point& candidate, int radius) {
+        for (int dy = -radius; dy <= radius; ++dy) {
+            for (int dx = -radius; dx <= radius; ++dx) {
+                if (occupiedCounts.find(Point(candidate.x + dx, candidate.y + dy)) != occupiedCounts.end()) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    });
+}
+
 /**
  * @brief 检测玩家在新位置是否发生碰撞
  * @param player 当前玩家
@@ -1,12 +1,16 @@
 #include "../include/managers/PlayerManager.h"
 #include "../include/utils/Logger.h"
 #include "../include/utils/Validator.h"
+#include "../include/utils/PerformanceMonitor.h"
 #include "../include/models/Config.h"
 #include <sstream>
 #include <iomanip>
 #include <random>
 #include <chrono>
 #include <atomic>
+#include <algorithm>
+#include <functional>
+#include <utility>
 #include <openssl/sha.h>
 
 namespace snake {
@@ -18,6 +22,7 @@ PlayerManager::PlayerManager()
     if (!db_->initialize(dbPath)) {
         LOG_ERROR("Failed to initialize database for PlayerManager");
     }
+    loadKeyIndex();
     LOG_INFO("PlayerManager initialized");
 }
 
@@ -28,23 +33,89 @@ PlayerManager::~PlayerManager() {
 
 
 
-std::string PlayerManager::login(const std::string& uid, const std::string& paste) {
-    // 1. 验证洛谷剪贴板
-    if (!checkLogin(uid, paste)) {
-        LOG_WARNING("Login validation failed for UID: " + uid);
-        return "";
+void PlayerManager::loadKeyIndex() {
+    /**
+     * 启动时一次性加载账号索引
+     * 
+     * - 整表扫描 players(uid, key, paste)，按键哈希写入 key -> uid 与 uid -> key/paste 两组分片
+     * - 之后 validateKey / login 的读取全部在内存完成，不再访问 SQLite
+     * - 加载耗时与条目数写入日志和性能指标
+     */
+    auto start = std::chrono::steady_clock::now();
+
+    std::size_t entryCount = 0;
+    auto rs = db_->query("SELECT uid, key, paste FROM players");
+    while (rs.next()) {
+        std::string uid = rs.getString(0);
+        std::string key = rs.getString(1);
+        keyShards_[keyIndexShard(key)].keyToUid[key] = uid;
+        auto& slot = accountShards_[keyIndexShard(uid)].byUid[uid];
+        if (!slot) {
+            ++entryCount;
+        }
+        slot = std::make_shared<const AccountEntry>(AccountEntry{std::move(key), rs.getString(2)});
+    }
+    accountCount_.store(entryCount, std::memory_order_relaxed);
+
+    const double elapsedMs = std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - start).count();
+
+    PerformanceMonitor::getInstance().setGauge("key_index_entries", static_cast<double>(entryCount));
+    PerformanceMonitor::getInstance().setGauge("key_index_load_ms", elapsedMs);
+    LOG_INFO("Key index loaded: " + std::to_string(entryCount) + " accounts in " +
+             std::to_string(elapsedMs) + "ms");
+}
+
+std::size_t PlayerManager::keyIndexShard(const std::string& key) {
+    return std::hash<std::string>{}(key) % kKeyIndexShards;
+}
+
+std::shared_ptr<const PlayerManager::AccountEntry> PlayerManager::findAccount(const std::string& uid) const {
+    const auto& shard = accountShards_[keyIndexShard(uid)];
+    std::shared_lock<std::shared_mutex> lock(shard.mutex);
+    auto it = shard.byUid.find(uid);
+    return it != shard.byUid.end() ? it->second : nullptr;
+}
+
+void PlayerManager::publishAccount(const std::string& uid,
+                                   const std::string& key,
+                                   const std::string& paste) {
+    // 调用方需持有 keyWriteMutex_：只替换该账号的条目，代价与账号总数无关
+    auto entry = std::make_shared<const AccountEntry>(AccountEntry{key, paste});
+    std::shared_ptr<const AccountEntry> previous;
+    {
+        auto& shard = accountShards_[keyIndexShard(uid)];
+        std::unique_lock<std::shared_mutex> lock(shard.mutex);
+        previous = std::exchange(shard.byUid[uid], std::move(entry));
+    }
+    {
+        // 先登记新key再移除旧key，并发校验不会看到两者都无效的窗口
+        auto& shard = keyShards_[keyIndexShard(key)];
+        std::unique_lock<std::shared_mutex> lock(shard.mutex);
+        shard.keyToUid[key] = uid;
+    }
+    if (previous && previous->key != key) {
+        auto& shard = keyShards_[keyIndexShard(previous->key)];
+        std::unique_lock<std::shared_mutex> lock(shard.mutex);
+        shard.keyToUid.erase(previous->key);  // 旧key失效
     }
 
-    std::unique_lock<std::shared_mutex> lock(mutex_);
+    const std::size_t count = previous ? accountCount_.load(std::memory_order_relaxed)
+                                       : accountCount_.fetch_add(1, std::memory_order_relaxed) + 1;
+    PerformanceMonitor::getInstance().setGauge("key_index_entries", static_cast<double>(count));
+}
+
+std::string PlayerManager::login(const std::string& uid, const std::string& paste) {
+    // 1. 洛谷身份已由调用方（RouteHandler + PasteVerifier）验证，这里不再重复远程请求
+    std::lock_guard<std::mutex> lock(keyWriteMutex_);
 
-    // 2. 检查用户是否已存在
-    std::string sql = "SELECT key, paste FROM players WHERE uid = ?";
-    auto rs = db_->queryWithParams(sql, {uid});
+    // 2. 检查用户是否已存在（查内存账号索引，不访问数据库）
+    auto account = findAccount(uid);
     
-    if (rs.next()) {
+    if (account) {
         // 用户已存在，检查paste是否匹配
-        std::string existingKey = rs.getString(0);
-        std::string existingPaste = rs.getString(1);
+        const std::string& existingKey = account->key;
+        const std::string& existingPaste = account->paste;
         
         auto now = std::chrono::system_clock::now().time_since_epoch().count();
         
@@ -71,10 +142,8 @@ std::string PlayerManager::login(const std::string& uid, const std::string& past
                 return "";
             }
             
-            // 更新内存缓存
-            keyToUid_.erase(existingKey);  // 移除旧key
-            uidToKey_[uid] = newKey;
-            keyToUid_[newKey] = uid;
+            // 更新内存账号索引（移除旧key）
+            publishAccount(uid, newKey, paste);
             
             LOG_INFO("User login with new paste, key updated: UID=" + uid + ", old_key=" + existingKey + ", new_key=" + newKey);
             return newKey;
@@ -99,44 +168,36 @@ std::string PlayerManager::login(const std::string& uid, const std::string& past
         return "";
     }
 
-    // 4. 缓存到内存映射
-    uidToKey_[uid] = key;
-    keyToUid_[key] = uid;
+    // 4. 写入内存账号索引
+    publishAccount(uid, key, paste);
 
     LOG_INFO("New user registered: UID=" + uid + ", key=" + key);
     return key;
 }
 
-bool PlayerManager::checkLogin(const std::string& uid, const std::string& paste) {
-    // 获取配置中的验证文本
-    const std::string& expectedText = Config::getInstance().getAuth().luoguValidationText;
-    
-    // 调用 Validator 进行验证
-    bool isValid = Validator::validateLuoguPaste(uid, paste);
-    
-    if (isValid) {
-        LOG_INFO("Login validation successful for UID: " + uid);
-    } else {
-        LOG_WARNING("Login validation failed for UID: " + uid);
-    }
-    
-    return isValid;
-}
-
 PlayerManager::JoinResult PlayerManager::join(const std::string& key, 
                                                const std::string& name, 
                                                const std::string& color) {
-    JoinResult result;
-    result.success = false;
-
     // 1. 验证key
     std::string uid;
     if (!validateKey(key, uid)) {
+        JoinResult result;
+        result.success = false;
         result.errorMsg = "Invalid key";
         LOG_WARNING("Join failed: invalid key");
         return result;
     }
 
+    return join(key, uid, name, color);
+}
+
+PlayerManager::JoinResult PlayerManager::join(const std::string& key,
+                                               const std::string& uid,
+                                               const std::string& name,
+                                               const std::string& color) {
+    JoinResult result;
+    result.success = false;
+
     // 2. 验证玩家名称
     if (!Validator::isValidPlayerName(name)) {
         result.errorMsg = "Invalid player name";
@@ -154,15 +215,12 @@ PlayerManager::JoinResult PlayerManager::join(const std::string& key,
         return result;
     }
 
-    std::unique_lock<std::shared_mutex> lock(mutex_);
-
-    // 4. 检查玩家是否已在游戏中
-    for (const auto& [pid, player] : players_) {
-        if (player->getUid() == uid && player->isInGame()) {
-            result.errorMsg = "Player already in game";
-            LOG_WARNING("Join failed: player already in game");
-            return result;
-        }
+    // 4. 检查玩家是否已在游戏中（快速失败；最终以 SessionTable::insert 的原子检查为准）
+    auto active = sessions_.findActiveByUid(uid);
+    if (active && active->isInGame()) {
+        result.errorMsg = "Player already in game";
+        LOG_WARNING("Join failed: player already in game");
+        return result;
     }
 
     // 5. 生成playerId和token（playerId 使用单调序列，避免随机碰撞）
@@ -171,55 +229,55 @@ PlayerManager::JoinResult PlayerManager::join(const std::string& key,
      * 
      * PlayerId 生成：
      * - 为本次游戏会话分配唯一的玩家ID
-     * - 格式：p_{uid}_{随机数}
+     * - 格式：p_{uid}_{单调序列}
      * 
      * Token 生成：
      * - 生成游戏会话凭证
      * - 基于 playerId + 时间戳 + 随机数的 SHA256 哈希
      * - 用于后续所有游戏操作的身份认证
      * 
-     * 存储策略：
-     * - tokenToPlayerId_: 快速通过 token 查找 playerId
-     * - players_: 存储完整的 Player 对象
-     * 
-     * 关联关系：
-     * token -> playerId -> Player
+     * 存储策略（SessionTable，按键哈希分片）：
+     * - token -> Player：move 路径一次哈希探测完成鉴权
+     * - playerId -> Player：按 ID 查询
+     * - uid -> Player：当前活跃会话，替代对全部玩家的线性扫描
      */
-    std::string playerId = generatePlayerId(uid);
-    while (players_.find(playerId) != players_.end()) {
-        // 理论上不会触发：generatePlayerId 使用进程内全局单调序列
-        LOG_WARNING("PlayerId collision detected, regenerating: " + playerId);
-        playerId = generatePlayerId(uid);
-    }
+    auto player = std::make_shared<Player>(uid, name, playerColor);
+    player->setKey(key);
+    player->setInGame(true);
 
     constexpr int kMaxGenerateAttempts = 128;
 
-    std::string token;
-    for (int attempt = 0; attempt < kMaxGenerateAttempts; ++attempt) {
-        std::string candidate = generateToken(playerId);
-        if (tokenToPlayerId_.find(candidate) == tokenToPlayerId_.end()) {
-            token = std::move(candidate);
-            break;
+    bool inserted = false;
+    for (int attempt = 0; attempt < kMaxGenerateAttempts && !inserted; ++attempt) {
+        player->setId(generatePlayerId(uid));
+        player->setToken(generateToken(player->getId()));
+
+        switch (sessions_.insert(player)) {
+            case SessionTable::InsertResult::OK:
+                inserted = true;
+                break;
+            case SessionTable::InsertResult::UID_IN_GAME:
+                result.errorMsg = "Player already in game";
+                LOG_WARNING("Join failed: player already in game");
+                return result;
+            case SessionTable::InsertResult::ID_EXISTS:
+                // 理论上不会触发：generatePlayerId 使用进程内全局单调序列
+                LOG_WARNING("PlayerId collision detected, regenerating: " + player->getId());
+                break;
+            case SessionTable::InsertResult::TOKEN_EXISTS:
+                LOG_WARNING("Token collision detected, regenerating token for playerId=" + player->getId());
+                break;
         }
-        LOG_WARNING("Token collision detected, regenerating token for playerId=" + playerId);
     }
 
-    if (token.empty()) {
+    if (!inserted) {
         result.errorMsg = "failed to allocate session token";
-        LOG_ERROR("Join failed: unable to allocate unique token for playerId=" + playerId);
+        LOG_ERROR("Join failed: unable to allocate unique token for playerId=" + player->getId());
         return result;
     }
 
-    // 6. 创建玩家对象
-    auto player = std::make_shared<Player>(uid, name, playerColor);
-    player->setId(playerId);
-    player->setToken(token);
-    player->setKey(key);
-    player->setInGame(true);
-
-    // 7. 存储到内存映射
-    players_[playerId] = player;
-    tokenToPlayerId_[token] = playerId;
+    const std::string& playerId = player->getId();
+    const std::string& token = player->getToken();
 
     result.success = true;
     result.token = token;
@@ -230,29 +288,15 @@ PlayerManager::JoinResult PlayerManager::join(const std::string& key,
 }
 
 bool PlayerManager::validateKey(const std::string& key, std::string& uid) const {
-    std::shared_lock<std::shared_mutex> lock(mutex_);
-
-    // 1. 先检查内存缓存
-    auto it = keyToUid_.find(key);
-    if (it != keyToUid_.end()) {
+    // 只查内存账号索引（启动时全量加载，login 时同步更新），不访问数据库
+    const auto& shard = keyShards_[keyIndexShard(key)];
+    std::shared_lock<std::shared_mutex> lock(shard.mutex);
+    auto it = shard.keyToUid.find(key);
+    if (it != shard.keyToUid.end()) {
         uid = it->second;
         return true;
     }
 
-    // 2. 从数据库查询
-    lock.unlock();
-    std::string sql = "SELECT uid FROM players WHERE key = ?";
-    auto rs = db_->queryWithParams(sql, {key});
-    
-    if (rs.next()) {
-        uid = rs.getString(0);
-        
-        // 注意：不能在const函数中修改成员变量
-        // 这里我们选择不缓存，或者需要使用mutable关键字
-        
-        return true;
-    }
-
     return false;
 }
 
@@ -263,24 +307,22 @@ bool PlayerManager::validateToken(const std::string& token, std::string& playerI
      * 功能：验证 token 是否有效，并返回对应的 playerId
      * 
      * 验证流程：
-     * 1. 使用读锁保护共享数据（支持多线程并发读取）
-     * 2. 在内存映射表中查找 token
+     * 1. 按 token 哈希定位 SessionTable 分片，加分片读锁
+     * 2. 在分片内查找 token
      * 3. 如果找到，返回 true 并设置 playerId
      * 4. 如果未找到，返回 false
      * 
      * 线程安全性：
-     * - 使用 shared_lock 允许多个线程同时验证
-     * - 不会阻塞其他读操作
+     * - 只锁定一个分片，不涉及全局锁
+     * - 不同 token 的验证通常落在不同分片，互不阻塞
      * 
      * 性能优化：
      * - 仅查询内存，不访问数据库（token 是临时会话凭证）
-     * - O(log n) 时间复杂度（使用 std::map）
+     * - 一次哈希探测，平均 O(1)
      */
-    std::shared_lock<std::shared_mutex> lock(mutex_);
-
-    auto it = tokenToPlayerId_.find(token);
-    if (it != tokenToPlayerId_.end()) {
-        playerId = it->second;
+    auto player = sessions_.findByToken(token);
+    if (player) {
+        playerId = player->getId();
         LOG_DEBUG("Token validated successfully: playerId=" + playerId);
         return true;
     }
@@ -290,23 +332,11 @@ bool PlayerManager::validateToken(const std::string& token, std::string& playerI
 }
 
 std::shared_ptr<Player> PlayerManager::getPlayerById(const std::string& playerId) {
-    std::shared_lock<std::shared_mutex> lock(mutex_);
-    
-    auto it = players_.find(playerId);
-    if (it != players_.end()) {
-        return it->second;
-    }
-    return nullptr;
+    return sessions_.findById(playerId);
 }
 
 std::shared_ptr<Player> PlayerManager::getPlayerByToken(const std::string& token) {
-    std::shared_lock<std::shared_mutex> lock(mutex_);
-    
-    auto it = tokenToPlayerId_.find(token);
-    if (it != tokenToPlayerId_.end()) {
-        return getPlayerById(it->second);
-    }
-    return nullptr;
+    return sessions_.findByToken(token);
 }
 
 std::shared_ptr<Player> PlayerManager::getPlayerByKey(const std::string& key) {
@@ -315,80 +345,22 @@ std::shared_ptr<Player> PlayerManager::getPlayerByKey(const std::string& key) {
         return nullptr;
     }
     
-    std::shared_lock<std::shared_mutex> lock(mutex_);
-    
-    for (const auto& [playerId, player] : players_) {
-        if (player->getUid() == uid) {
-            return player;
-        }
-    }
-    return nullptr;
+    return sessions_.findActiveByUid(uid);
 }
 
 void PlayerManager::removePlayer(const std::string& playerId) {
-    std::unique_lock<std::shared_mutex> lock(mutex_);
-    
-    auto it = players_.find(playerId);
-    if (it != players_.end()) {
-        // 移除token映射
-        const std::string& token = it->second->getToken();
-        tokenToPlayerId_.erase(token);
-        
-        // 移除玩家
-        players_.erase(it);
-        
+    if (sessions_.erase(playerId)) {
         LOG_INFO("Player removed: " + playerId);
     }
 }
 
 bool PlayerManager::isPlayerInGame(const std::string& playerId) const {
-    std::shared_lock<std::shared_mutex> lock(mutex_);
-    
-    auto it = players_.find(playerId);
-    return it != players_.end() && it->second->isInGame();
+    auto player = sessions_.findById(playerId);
+    return player && player->isInGame();
 }
 
 int PlayerManager::getPlayerCount() const {
-    std::shared_lock<std::shared_mutex> lock(mutex_);
-    return players_.size();
-}
-
-std::vector<std::shared_ptr<Player>> PlayerManager::getAllPlayers() const {
-    /**
-     * 获取所有在线玩家列表
-     * 
-     * 功能：返回当前所有在游戏中的玩家对象
-     * 
-     * 返回值：
-     * - 包含所有玩家智能指针的向量
-     * - 按照插入顺序（实际上 map 会按 key 排序）
-     * 
-     * 线程安全性：
-     * - 使用 shared_lock 保护读操作
-     * - 可与其他读操作并发执行
-     * 
-     * 使用场景：
-     * - GameManager 需要遍历所有玩家进行回合推进
-     * - MapManager 检测碰撞时需要获取所有玩家位置
-     * - RouteHandler 返回游戏状态时需要玩家列表
-     * 
-     * 性能考虑：
-     * - 返回 vector 会进行拷贝，但拷贝的是智能指针（开销小）
-     * - 时间复杂度：O(n)，n 为玩家数量
-     */
-    std::shared_lock<std::shared_mutex> lock(mutex_);
-    
-    std::vector<std::shared_ptr<Player>> result;
-    result.reserve(players_.size()); // 预分配空间，避免多次扩容
-    
-    for (const auto& [playerId, player] : players_) {
-        if (player && player->isInGame()) {
-            result.push_back(player);
-        }
-    }
-    
-    LOG_DEBUG("getAllPlayers() returned " + std::to_string(result.size()) + " players");
-    return result;
+    return static_cast<int>(sessions_.size());
 }
 
 void PlayerManager::removeAllPlayers() {
@@ -398,26 +370,18 @@ void PlayerManager::removeAllPlayers() {
      * 功能：清空所有玩家数据，用于游戏重置或服务器关闭
      * 
      * 操作步骤：
-     * 1. 获取写锁（独占访问）
-     * 2. 清空玩家映射表
-     * 3. 清空 token 映射表
+     * 1. 逐个分片获取写锁
+     * 2. 清空 SessionTable 的全部索引
      * 
      * 线程安全性：
-     * - 使用 unique_lock 保护写操作
-     * - 会阻塞所有其他读写操作
+     * - 分片依次加写锁，不会长时间阻塞全部读操作
      * 
      * 注意事项：
-     * - 不清空 uidToKey_ 和 keyToUid_（账号级别数据保留）
+     * - 不清空账号索引（账号级别数据保留）
      * - 这样用户可以重新加入游戏而无需重新登录
      * - 数据库中的玩家记录不受影响
      */
-    std::unique_lock<std::shared_mutex> lock(mutex_);
-    
-    int playerCount = players_.size();
-    
-    // 清空玩家相关的映射表
-    players_.clear();
-    tokenToPlayerId_.clear();
+    const std::size_t playerCount = sessions_.clear();
     
     LOG_INFO("Removed all players, count: " + std::to_string(playerCount));
 }
@@ -433,18 +397,16 @@ std::vector<std::shared_ptr<Player>> PlayerManager::getPlayersByUid(const std::s
      * - 检测是否有重复登录
      * 
      * 实现：
-     * - 遍历所有玩家，筛选出匹配的 UID
+     * - 遍历所有会话，筛选出匹配的 UID
      * - 时间复杂度：O(n)
      * 
-     * 优化空间：
-     * - 如果频繁使用，可以添加 uidToPlayerIds_ 映射
-     * - 当前实现简单直接，适合当前需求
+     * 说明：
+     * - 只需要活跃会话时应使用 SessionTable::findActiveByUid（O(1)）
+     * - 本函数需要返回历史会话，仍保留遍历实现
      */
-    std::shared_lock<std::shared_mutex> lock(mutex_);
-    
     std::vector<std::shared_ptr<Player>> result;
     
-    for (const auto& [playerId, player] : players_) {
+    for (const auto& player : sessions_.snapshot()) {
         if (player && player->getUid() == uid) {
             result.push_back(player);
         }
@@ -0,0 +1,148 @@
+#include "../include/managers/SessionTable.h"
+#include <functional>
+#include <mutex>
+
+namespace snake {
+
+std::size_t SessionTable::shardIndex(const std::string& key) {
+    return std::hash<std::string>{}(key) % kShardCount;
+}
+
+SessionTable::Shard& SessionTable::shardFor(ShardArray& shards, const std::string& key) {
+    return shards[shardIndex(key)];
+}
+
+const SessionTable::Shard& SessionTable::shardFor(const ShardArray& shards, const std::string& key) {
+    return shards[shardIndex(key)];
+}
+
+std::shared_ptr<Player> SessionTable::find(const ShardArray& shards, const std::string& key) {
+    const Shard& shard = shardFor(shards, key);
+    std::shared_lock<std::shared_mutex> lock(shard.mutex);
+    auto it = shard.entries.find(key);
+    return it != shard.entries.end() ? it->second : nullptr;
+}
+
+SessionTable::InsertResult SessionTable::insert(const std::shared_ptr<Player>& player) {
+    /**
+     * 插入流程：
+     * 1. 锁定 uid 分片，检查该用户是否已有在游戏中的会话
+     * 2. 依次锁定 id 分片与 token 分片，检查冲突后写入
+     *
+     * uid 分片的写锁在整个插入过程中保持，保证同一用户的并发 join
+     * 只有一个能成功。
+     */
+    const std::string& uid = player->getUid();
+    const std::string& playerId = player->getId();
+    const std::string& token = player->getToken();
+
+    Shard& uidShard = shardFor(byUid_, uid);
+    std::unique_lock<std::shared_mutex> uidLock(uidShard.mutex);
+
+    auto active = uidShard.entries.find(uid);
+    if (active != uidShard.entries.end() && active->second && active->second->isInGame()) {
+        return InsertResult::UID_IN_GAME;
+    }
+
+    Shard& idShard = shardFor(byId_, playerId);
+    std::unique_lock<std::shared_mutex> idLock(idShard.mutex);
+    if (idShard.entries.find(playerId) != idShard.entries.end()) {
+        return InsertResult::ID_EXISTS;
+    }
+
+    Shard& tokenShard = shardFor(byToken_, token);
+    std::unique_lock<std::shared_mutex> tokenLock(tokenShard.mutex);
+    if (tokenShard.entries.find(token) != tokenShard.entries.end()) {
+        return InsertResult::TOKEN_EXISTS;
+    }
+
+    tokenShard.entries.emplace(token, player);
+    idShard.entries.emplace(playerId, player);
+    uidShard.entries[uid] = player;
+    size_.fetch_add(1, std::memory_order_relaxed);
+    return InsertResult::OK;
+}
+
+std::shared_ptr<Player> SessionTable::findByToken(const std::string& token) const {
+    return find(byToken_, token);
+}
+
+std::shared_ptr<Player> SessionTable::findById(const std::string& playerId) const {
+    return find(byId_, playerId);
+}
+
+std::shared_ptr<Player> SessionTable::findActiveByUid(const std::string& uid) const {
+    return find(byUid_, uid);
+}
+
+std::shared_ptr<Player> SessionTable::erase(const std::string& playerId) {
+    auto player = findById(playerId);
+    if (!player) {
+        return nullptr;
+    }
+
+    const std::string& uid = player->getUid();
+    Shard& uidShard = shardFor(byUid_, uid);
+    std::unique_lock<std::shared_mutex> uidLock(uidShard.mutex);
+
+    Shard& idShard = shardFor(byId_, playerId);
+    std::unique_lock<std::shared_mutex> idLock(idShard.mutex);
+    auto idIt = idShard.entries.find(playerId);
+    if (idIt == idShard.entries.end() || idIt->second != player) {
+        // 已被并发移除
+        return nullptr;
+    }
+    idShard.entries.erase(idIt);
+
+    Shard& tokenShard = shardFor(byToken_, player->getToken());
+    {
+        std::unique_lock<std::shared_mutex> tokenLock(tokenShard.mutex);
+        tokenShard.entries.erase(player->getToken());
+    }
+
+    // 仅当 uid 的活跃会话就是该玩家时才清除
+    auto uidIt = uidShard.entries.find(uid);
+    if (uidIt != uidShard.entries.end() && uidIt->second == player) {
+        uidShard.entries.erase(uidIt);
+    }
+
+    size_.fetch_sub(1, std::memory_order_relaxed);
+    return player;
+}
+
+std::size_t SessionTable::clear() {
+    std::size_t removed = 0;
+    for (auto& shard : byUid_) {
+        std::unique_lock<std::shared_mutex> lock(shard.mutex);
+        shard.entries.clear();
+    }
+    for (auto& shard : byId_) {
+        std::unique_lock<std::shared_mutex> lock(shard.mutex);
+        removed += shard.entries.size();
+        shard.entries.clear();
+    }
+    for (auto& shard : byToken_) {
+        std::unique_lock<std::shared_mutex> lock(shard.mutex);
+        shard.entries.clear();
+    }
+    size_.store(0, std::memory_order_relaxed);
+    return removed;
+}
+
+std::size_t SessionTable::size() const {
+    return size_.load(std::memory_order_relaxed);
+}
+
+std::vector<std::shared_ptr<Player>> SessionTable::snapshot() const {
+    std::vector<std::shared_ptr<Player>> result;
+    result.reserve(size());
+    for (const auto& shard : byId_) {
+        std::shared_lock<std::shared_mutex> lock(shard.mutex);
+        for (const auto& entry : shard.entries) {
+            result.push_back(entry.second);
+        }
+    }
+    return result;
+}
+
+} // namespace snake
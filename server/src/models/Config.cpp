@@ -1,4 +1,5 @@
 #include "models/Config.h"
+#include "utils/Logger.h"
 #include <fstream>
 #include <iostream>
 #include <stdexcept>
@@ -78,6 +79,15 @@ bool Config::loadFromJson(const nlohmann::json& j) {
             if (server.contains("ssl_use_chain_file")) {
                 server_.sslUseChainFile = server["ssl_use_chain_file"].get<bool>();
             }
+            if (server.contains("long_poll_max_timeout_ms")) {
+                server_.longPollMaxTimeoutMs = server["long_poll_max_timeout_ms"].get<int>();
+            }
+            if (server.contains("long_poll_max_waiters")) {
+                server_.longPollMaxWaiters = server["long_poll_max_waiters"].get<int>();
+            }
+            if (server.contains("move_batch_max_size")) {
+                server_.moveBatchMaxSize = server["move_batch_max_size"].get<int>();
+            }
         }
 
         // 加载游戏配置
@@ -101,6 +111,18 @@ bool Config::loadFromJson(const nlohmann::json& j) {
             if (game.contains("food_density")) {
                 game_.foodDensity = game["food_density"].get<double>();
             }
+            if (game.contains("tick_spin_us")) {
+                game_.tickSpinUs = game["tick_spin_us"].get<int>();
+            }
+            if (game.contains("arena_mode")) {
+                game_.arenaMode = game["arena_mode"].get<bool>();
+            }
+            if (game.contains("arena_min_interval_ms")) {
+                game_.arenaMinIntervalMs = game["arena_min_interval_ms"].get<int>();
+            }
+            if (game.contains("dead_player_retention_rounds")) {
+                game_.deadPlayerRetentionRounds = game["dead_player_retention_rounds"].get<int>();
+            }
         }
 
         // 加载数据库配置
@@ -159,6 +181,12 @@ bool Config::loadFromJson(const nlohmann::json& j) {
             if (rate.contains("map_window_seconds")) {
                 rateLimit_.mapWindowSeconds = rate["map_window_seconds"].get<int>();
             }
+            if (rate.contains("sweep_interval_seconds")) {
+                rateLimit_.sweepIntervalSeconds = rate["sweep_interval_seconds"].get<int>();
+            }
+            if (rate.contains("max_tracked_keys")) {
+                rateLimit_.maxTrackedKeys = rate["max_tracked_keys"].get<int>();
+            }
         }
 
         // 加载认证配置
@@ -170,6 +198,21 @@ bool Config::loadFromJson(const nlohmann::json& j) {
             if (auth.contains("universal_paste")) {
                 auth_.universalPaste = auth["universal_paste"].get<std::string>();
             }
+            if (auth.contains("verify_threads")) {
+                auth_.verifyThreads = auth["verify_threads"].get<int>();
+            }
+            if (auth.contains("verify_cache_ttl_seconds")) {
+                auth_.verifyCacheTtlSeconds = auth["verify_cache_ttl_seconds"].get<int>();
+            }
+            if (auth.contains("verify_negative_ttl_seconds")) {
+                auth_.verifyNegativeTtlSeconds = auth["verify_negative_ttl_seconds"].get<int>();
+            }
+            if (auth.contains("verify_cache_max_entries")) {
+                auth_.verifyCacheMaxEntries = auth["verify_cache_max_entries"].get<int>();
+            }
+            if (auth.contains("verify_max_pending")) {
+                auth_.verifyMaxPending = auth["verify_max_pending"].get<int>();
+            }
         }
 
         // 加载排行榜配置
@@ -198,9 +241,6 @@ bool Config::loadFromJson(const nlohmann::json& j) {
             if (perf.contains("window_seconds")) {
                 performanceMonitor_.windowSeconds = perf["window_seconds"].get<int>();
             }
-            if (perf.contains("max_samples")) {
-                performanceMonitor_.maxSamples = perf["max_samples"].get<int>();
-            }
             if (perf.contains("log_enabled")) {
                 performanceMonitor_.logEnabled = perf["log_enabled"].get<bool>();
             }
@@ -218,6 +258,47 @@ bool Config::loadFromJson(const nlohmann::json& j) {
             }
         }
 
+        // 加载日志配置
+        if (j.contains("logging")) {
+            const auto& logging = j["logging"];
+            if (logging.contains("level")) {
+                logging_.level = logging["level"].get<std::string>();
+            }
+            if (logging.contains("console")) {
+                logging_.console = logging["console"].get<bool>();
+            }
+            if (logging.contains("file")) {
+                logging_.file = logging["file"].get<std::string>();
+            }
+            if (logging.contains("max_bytes")) {
+                logging_.maxBytes = logging["max_bytes"].get<std::size_t>();
+            }
+            if (logging.contains("max_files")) {
+                logging_.maxFiles = logging["max_files"].get<int>();
+            }
+        }
+
+        // 加载内置 Bot 配置
+        if (j.contains("house_bots")) {
+            const auto& houseBots = j["house_bots"];
+            if (houseBots.contains("enabled")) {
+                houseBots_.enabled = houseBots["enabled"].get<bool>();
+            }
+            if (houseBots.contains("respawn_delay_rounds")) {
+                houseBots_.respawnDelayRounds = houseBots["respawn_delay_rounds"].get<int>();
+            }
+            if (houseBots.contains("bots")) {
+                houseBots_.bots.clear();
+                for (const auto& bot : houseBots["bots"]) {
+                    HouseBotEntry entry;
+                    entry.name = bot.value("name", "");
+                    entry.strategy = bot.value("strategy", entry.strategy);
+                    entry.color = bot.value("color", "");
+                    houseBots_.bots.push_back(entry);
+                }
+            }
+        }
+
         // 配置验证
         if (!validate()) {
             std::cerr << "[Config] 配置验证失败" << std::endl;
@@ -277,6 +358,21 @@ bool Config::validate() const {
         std::cerr << "[Config] bind_address 不能为空" << std::endl;
         return false;
     }
+    if (server_.longPollMaxTimeoutMs < 100 || server_.longPollMaxTimeoutMs > 120000) {
+        std::cerr << "[Config] 长轮询最长等待时间无效: " << server_.longPollMaxTimeoutMs
+                  << " (应在 100-120000 之间)" << std::endl;
+        return false;
+    }
+    if (server_.longPollMaxWaiters < 1 || server_.longPollMaxWaiters > 1000000) {
+        std::cerr << "[Config] 长轮询停放上限无效: " << server_.longPollMaxWaiters
+                  << " (应在 1-1000000 之间)" << std::endl;
+        return false;
+    }
+    if (server_.moveBatchMaxSize < 1 || server_.moveBatchMaxSize > 10000) {
+        std::cerr << "[Config] 批量移动条目上限无效: " << server_.moveBatchMaxSize
+                  << " (应在 1-10000 之间)" << std::endl;
+        return false;
+    }
 
     // 验证游戏配置
     if (game_.mapWidth < 10 || game_.mapWidth > 200000) {
@@ -287,8 +383,24 @@ bool Config::validate() const {
         std::cerr << "[Config] 地图高度无效: " << game_.mapHeight << " (应在 10-200000 之间)" << std::endl;
         return false;
     }
-    if (game_.roundTimeMs < 100 || game_.roundTimeMs > 100000000) {
-        std::cerr << "[Config] 回合时间无效: " << game_.roundTimeMs << " (应在 100-100000000 之间)" << std::endl;
+    if (game_.roundTimeMs < 20 || game_.roundTimeMs > 100000000) {
+        std::cerr << "[Config] 回合时间无效: " << game_.roundTimeMs << " (应在 20-100000000 之间)" << std::endl;
+        return false;
+    }
+    if (game_.tickSpinUs < 0 || game_.tickSpinUs > 20000 ||
+        static_cast<long long>(game_.tickSpinUs) >= static_cast<long long>(game_.roundTimeMs) * 1000) {
+        std::cerr << "[Config] 回合自旋时长无效: " << game_.tickSpinUs
+                  << " (应在 0-20000 微秒之间，且小于回合时间)" << std::endl;
+        return false;
+    }
+    if (game_.arenaMinIntervalMs < 0 || game_.arenaMinIntervalMs > game_.roundTimeMs) {
+        std::cerr << "[Config] 竞技场最小回合间隔无效: " << game_.arenaMinIntervalMs
+                  << " (应在 0-回合时间 之间)" << std::endl;
+        return false;
+    }
+    if (game_.deadPlayerRetentionRounds < 0 || game_.deadPlayerRetentionRounds > 100000) {
+        std::cerr << "[Config] 死亡玩家保留回合数无效: " << game_.deadPlayerRetentionRounds
+                  << " (应在 0-100000 之间)" << std::endl;
         return false;
     }
     if (game_.initialSnakeLength < 1 || game_.initialSnakeLength > 10) {
@@ -350,11 +462,6 @@ bool Config::validate() const {
                   << " (应在 1-3600 之间)" << std::endl;
         return false;
     }
-    if (performanceMonitor_.maxSamples < 10 || performanceMonitor_.maxSamples > 200000) {
-        std::cerr << "[Config] 性能监控样本上限无效: " << performanceMonitor_.maxSamples
-                  << " (应在 10-200000 之间)" << std::endl;
-        return false;
-    }
     if (performanceMonitor_.logEnabled) {
         if (performanceMonitor_.logIntervalSeconds < 1 || performanceMonitor_.logIntervalSeconds > 3600) {
             std::cerr << "[Config] 监控日志间隔无效: " << performanceMonitor_.logIntervalSeconds
@@ -373,6 +480,75 @@ bool Config::validate() const {
         return false;
     }
 
+    // 验证身份验证配置
+    if (auth_.verifyThreads < 1 || auth_.verifyThreads > 32) {
+        std::cerr << "[Config] 剪贴板验证线程数无效: " << auth_.verifyThreads
+                  << " (应在 1-32 之间)" << std::endl;
+        return false;
+    }
+    if (auth_.verifyCacheTtlSeconds < 0 || auth_.verifyCacheTtlSeconds > 86400) {
+        std::cerr << "[Config] 验证缓存时间无效: " << auth_.verifyCacheTtlSeconds
+                  << " (应在 0-86400 之间，0表示不缓存)" << std::endl;
+        return false;
+    }
+    if (auth_.verifyNegativeTtlSeconds < 0 || auth_.verifyNegativeTtlSeconds > 3600) {
+        std::cerr << "[Config] 验证失败缓存时间无效: " << auth_.verifyNegativeTtlSeconds
+                  << " (应在 0-3600 之间，0表示不缓存)" << std::endl;
+        return false;
+    }
+    if (auth_.verifyCacheMaxEntries < 1 || auth_.verifyCacheMaxEntries > 1000000) {
+        std::cerr << "[Config] 验证缓存上限无效: " << auth_.verifyCacheMaxEntries
+                  << " (应在 1-1000000 之间)" << std::endl;
+        return false;
+    }
+    if (auth_.verifyMaxPending < 1 || auth_.verifyMaxPending > 100000) {
+        std::cerr << "[Config] 待验证任务上限无效: " << auth_.verifyMaxPending
+                  << " (应在 1-100000 之间)" << std::endl;
+        return false;
+    }
+
+    // 验证日志配置
+    // 与 Logger::parseLevel 接受同一组取值，避免能被日志模块识别的级别在这里被拒绝
+    Logger::Level level;
+    if (!Logger::tryParseLevel(logging_.level, level)) {
+        std::cerr << "[Config] 日志级别无效: " << logging_.level
+                  << " (应为 debug/info/warning/error，不区分大小写，也可写作 warn)" << std::endl;
+        return false;
+    }
+    if (!logging_.file.empty() && logging_.maxBytes < 1024) {
+        std::cerr << "[Config] 日志文件大小上限无效: " << logging_.maxBytes
+                  << " (应至少 1024 字节)" << std::endl;
+        return false;
+    }
+    if (logging_.maxFiles < 1 || logging_.maxFiles > 50) {
+        std::cerr << "[Config] 日志滚动数量无效: " << logging_.maxFiles
+                  << " (应在 1-50 之间)" << std::endl;
+        return false;
+    }
+
+    // 验证内置 Bot 配置
+    if (houseBots_.respawnDelayRounds < 0 || houseBots_.respawnDelayRounds > 10000) {
+        std::cerr << "[Config] 内置 Bot 重生间隔无效: " << houseBots_.respawnDelayRounds
+                  << " (应在 0-10000 之间)" << std::endl;
+        return false;
+    }
+    if (houseBots_.bots.size() > 64) {
+        std::cerr << "[Config] 内置 Bot 数量过多: " << houseBots_.bots.size() << " (最多 64 个)" << std::endl;
+        return false;
+    }
+    for (const auto& bot : houseBots_.bots) {
+        if (bot.name.empty() || bot.name.length() > 20) {
+            std::cerr << "[Config] 内置 Bot 名称无效: \"" << bot.name << "\" (长度应在 1-20 之间)" << std::endl;
+            return false;
+        }
+        if (bot.strategy != "glutton" && bot.strategy != "interceptor" &&
+            bot.strategy != "parasite" && bot.strategy != "patroller") {
+            std::cerr << "[Config] 内置 Bot 策略无效: " << bot.strategy
+                      << " (应为 glutton/interceptor/parasite/patroller)" << std::endl;
+            return false;
+        }
+    }
+
     // 验证速率限制配置（允许通过 enabled 关闭限制）
     if (rateLimit_.enabled) {
         if (rateLimit_.statusPerMinute < 0 || rateLimit_.statusPerMinute > 10000) {
@@ -411,6 +587,14 @@ bool Config::validate() const {
             std::cerr << "[Config] 地图查询窗口无效: " << rateLimit_.mapWindowSeconds << " (应在 0-60 之间，0表示不限制)" << std::endl;
             return false;
         }
+        if (rateLimit_.sweepIntervalSeconds < 1 || rateLimit_.sweepIntervalSeconds > 3600) {
+            std::cerr << "[Config] 速率限制清扫间隔无效: " << rateLimit_.sweepIntervalSeconds << " (应在 1-3600 之间)" << std::endl;
+            return false;
+        }
+        if (rateLimit_.maxTrackedKeys < 16 || rateLimit_.maxTrackedKeys > 10000000) {
+            std::cerr << "[Config] 速率限制键数量上限无效: " << rateLimit_.maxTrackedKeys << " (应在 16-10000000 之间)" << std::endl;
+            return false;
+        }
     }
 
     return true;
@@ -448,4 +632,12 @@ const Config::PerformanceMonitorConfig& Config::getPerformanceMonitor() const {
     return performanceMonitor_;
 }
 
+const Config::LoggingConfig& Config::getLogging() const {
+    return logging_;
+}
+
+const Config::HouseBotConfig& Config::getHouseBots() const {
+    return houseBots_;
+}
+
 } // namespace snake
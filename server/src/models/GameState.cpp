@@ -97,6 +97,30 @@ void GameState::removePlayer(const std::string& playerId) {
     );
 }
 
+/**
+ * @brief 批量移除玩家
+ * @param playerIds 要移除的玩家 ID 集合
+ * @return 实际移除的玩家数量
+ *
+ * 说明：
+ * - 一次 erase-remove 遍历完成，避免逐个 removePlayer 的 O(n·k)
+ * - 保持剩余玩家的相对顺序
+ */
+std::size_t GameState::removePlayers(const std::unordered_set<std::string>& playerIds) {
+    if (playerIds.empty()) {
+        return 0;
+    }
+    const std::size_t before = players_.size();
+    players_.erase(
+        std::remove_if(players_.begin(), players_.end(),
+            [&playerIds](const std::shared_ptr<Player>& p) {
+                return p && playerIds.count(p->getId()) > 0;
+            }),
+        players_.end()
+    );
+    return before - players_.size();
+}
+
 /**
  * @brief 根据 ID 获取玩家
  * @param playerId 玩家 ID
@@ -89,14 +89,33 @@ Snake::MoveResult Snake::moveWithDelta() {
             return result;  // 双重保险
     }
 
+    return applyMove(newHead, growthPending_ > 0);
+}
+
+/**
+ * @brief 按给定的新头部移动一格并返回增量信息
+ * @param newHead 新的头部位置
+ * @param keepTail 为 true 时保留尾部（本次移动成长一格，消耗一次待成长次数）
+ *
+ * 说明：服务器回合由规则引擎推进，引擎给出新头部和是否成长，这里只同步蛇身
+ */
+Snake::MoveResult Snake::applyMove(const Point& newHead, bool keepTail) {
+    MoveResult result;
+
+    if (!alive_) {
+        return result;
+    }
+
     result.moved = true;
     result.newHead = newHead;
 
-    // 如果有待成长次数，下次移动不移除尾部：先插入新头
-    if (growthPending_ > 0) {
+    // 成长时不移除尾部：先插入新头
+    if (keepTail) {
         blocks_.push_front(newHead);
         blockSet_.insert(newHead);
-        growthPending_--;
+        if (growthPending_ > 0) {
+            growthPending_--;
+        }
         result.tailRemoved = false;
     } else {
         // 非生长情况：先移除尾部再插入新头
@@ -158,6 +177,13 @@ Direction Snake::getCurrentDirection() const {
     return currentDirection_;
 }
 
+/**
+ * @brief 获取待成长次数
+ */
+int Snake::getGrowthPending() const {
+    return growthPending_;
+}
+
 /**
  * @brief 获取剩余无敌回合数
  */
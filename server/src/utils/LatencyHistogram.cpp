@@ -0,0 +1,164 @@
+#include "utils/LatencyHistogram.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace snake {
+
+namespace {
+
+int highestBit(std::uint64_t value) {
+#if defined(__GNUC__) || defined(__clang__)
+    return 63 - __builtin_clzll(value);
+#else
+    int bit = 0;
+    while (value >>= 1) {
+        ++bit;
+    }
+    return bit;
+#endif
+}
+
+// 单写者递增：load + store 即可，避免 fetch_add 的总线锁
+inline void bump(std::atomic<std::uint64_t>& counter, std::uint64_t delta) {
+    counter.store(counter.load(std::memory_order_relaxed) + delta, std::memory_order_relaxed);
+}
+
+} // namespace
+
+std::size_t LatencyHistogram::bucketIndex(std::uint64_t valueUs) {
+    if (valueUs > kMaxValue) {
+        valueUs = kMaxValue;
+    }
+    if (valueUs < 2 * kSubBucketCount) {
+        return static_cast<std::size_t>(valueUs);
+    }
+    // 最高位为 msb 时右移 shift 位，使结果落在 [kSubBucketCount, 2 * kSubBucketCount)
+    const int shift = highestBit(valueUs) - kSubBucketBits;
+    const std::uint64_t top = valueUs >> shift;
+    return static_cast<std::size_t>(2 * kSubBucketCount +
+                                    (shift - 1) * kSubBucketCount +
+                                    (top - kSubBucketCount));
+}
+
+std::uint64_t LatencyHistogram::bucketUpperBound(std::size_t index) {
+    if (index < 2 * kSubBucketCount) {
+        return index;
+    }
+    const std::uint64_t offset = index - 2 * kSubBucketCount;
+    const int shift = static_cast<int>(offset / kSubBucketCount) + 1;
+    const std::uint64_t top = offset % kSubBucketCount + kSubBucketCount;
+    return ((top + 1) << shift) - 1;
+}
+
+void LatencyHistogram::record(std::uint64_t valueUs) {
+    bump(buckets_[bucketIndex(valueUs)], 1);
+    bump(sumUs_, valueUs);
+    if (valueUs > maxUs_.load(std::memory_order_relaxed)) {
+        maxUs_.store(valueUs, std::memory_order_relaxed);
+    }
+}
+
+void LatencyHistogram::reset() {
+    for (auto& bucket : buckets_) {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+    sumUs_.store(0, std::memory_order_relaxed);
+    maxUs_.store(0, std::memory_order_relaxed);
+}
+
+void LatencyHistogram::Snapshot::merge(const LatencyHistogram& histogram) {
+    // 计数以各桶之和为准，保证与分位数计算使用的数据一致
+    for (std::size_t i = 0; i < kBucketCount; ++i) {
+        const std::uint64_t n = histogram.buckets_[i].load(std::memory_order_relaxed);
+        buckets[i] += n;
+        count += n;
+    }
+    sumUs += histogram.sumUs_.load(std::memory_order_relaxed);
+    maxUs = std::max(maxUs, histogram.maxUs_.load(std::memory_order_relaxed));
+}
+
+void LatencyHistogram::Snapshot::merge(const Snapshot& other) {
+    for (std::size_t i = 0; i < kBucketCount; ++i) {
+        buckets[i] += other.buckets[i];
+    }
+    count += other.count;
+    sumUs += other.sumUs;
+    maxUs = std::max(maxUs, other.maxUs);
+}
+
+std::uint64_t LatencyHistogram::Snapshot::percentileUs(double p) const {
+    if (count == 0) {
+        return 0;
+    }
+    p = std::min(1.0, std::max(0.0, p));
+    const std::uint64_t target = std::max<std::uint64_t>(
+        1, static_cast<std::uint64_t>(std::ceil(p * static_cast<double>(count))));
+
+    std::uint64_t seen = 0;
+    for (std::size_t i = 0; i < kBucketCount; ++i) {
+        seen += buckets[i];
+        if (seen >= target) {
+            return std::min(bucketUpperBound(i), maxUs);
+        }
+    }
+    return maxUs;
+}
+
+double LatencyHistogram::Snapshot::meanUs() const {
+    return count == 0 ? 0.0 : static_cast<double>(sumUs) / static_cast<double>(count);
+}
+
+void WindowedHistogram::record(std::uint64_t valueUs, std::int64_t tick) {
+    Slice& slice = slices_[static_cast<std::size_t>(tick) % kSliceCount];
+    if (slice.tick.load(std::memory_order_relaxed) != tick) {
+        // 先作废标记再清零，读取端不会把旧时间片的数据算进新窗口
+        slice.tick.store(-1, std::memory_order_release);
+        slice.histogram.reset();
+        slice.tick.store(tick, std::memory_order_release);
+    }
+    slice.histogram.record(valueUs);
+    bump(total_, 1);
+}
+
+void WindowedHistogram::merge(LatencyHistogram::Snapshot& snapshot,
+                              std::int64_t fromTick, std::int64_t toTick) const {
+    for (const auto& slice : slices_) {
+        const std::int64_t tick = slice.tick.load(std::memory_order_acquire);
+        if (tick < fromTick || tick > toTick) {
+            continue;
+        }
+        LatencyHistogram::Snapshot part;
+        part.merge(slice.histogram);
+        // 读取期间被写入端轮换的时间片丢弃（数据已属于新时间片或部分清零）
+        if (slice.tick.load(std::memory_order_acquire) == tick) {
+            snapshot.merge(part);
+        }
+    }
+}
+
+std::uint64_t WindowedHistogram::total() const {
+    return total_.load(std::memory_order_relaxed);
+}
+
+void RateWindow::add(std::int64_t tick) {
+    Slot& slot = slots_[static_cast<std::size_t>(tick) % kSlotCount];
+    if (slot.tick.load(std::memory_order_relaxed) != tick) {
+        slot.count.store(0, std::memory_order_relaxed);
+        slot.tick.store(tick, std::memory_order_release);
+    }
+    bump(slot.count, 1);
+}
+
+std::uint64_t RateWindow::sum(std::int64_t fromTick, std::int64_t toTick) const {
+    std::uint64_t total = 0;
+    for (const auto& slot : slots_) {
+        const std::int64_t tick = slot.tick.load(std::memory_order_acquire);
+        if (tick >= fromTick && tick <= toTick) {
+            total += slot.count.load(std::memory_order_relaxed);
+        }
+    }
+    return total;
+}
+
+} // namespace snake
@@ -1,60 +1,280 @@
 #include "../include/utils/Logger.h"
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <ctime>
+#include <filesystem>
 #include <iostream>
 #include <iomanip>
-#include <chrono>
 #include <sstream>
 
 namespace snake {
 
+namespace {
+// 后台线程空闲时的最长等待，兜底生产者未唤醒的情况
+constexpr auto kDrainIdleWait = std::chrono::milliseconds(50);
+// 单批最多处理的条数，处理完一批再刷新输出
+constexpr std::size_t kDrainBatch = 512;
+}
+
 Logger& Logger::getInstance() {
     static Logger instance;
     return instance;
 }
 
 Logger::Logger()
-    : level_(Level::INFO)
-    , consoleEnabled_(true) {
+    : level_(static_cast<int>(Level::INFO))
+    , consoleEnabled_(true)
+    , ring_(new Slot[kQueueCapacity]) {
+    for (std::size_t i = 0; i < kQueueCapacity; ++i) {
+        ring_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+    running_.store(true, std::memory_order_release);
+    drainThread_ = std::thread(&Logger::drainLoop, this);
 }
 
 Logger::~Logger() {
-    if (logFile_.is_open()) {
-        logFile_.close();
-    }
+    shutdown();
 }
 
 void Logger::setLevel(Level level) {
-    level_ = level;
+    level_.store(static_cast<int>(level), std::memory_order_relaxed);
 }
 
-void Logger::setLogFile(const std::string& filename) {
-    // TODO: 实现日志文件设置
+Logger::Level Logger::getLevel() const {
+    return static_cast<Level>(level_.load(std::memory_order_relaxed));
+}
+
+void Logger::setLogFile(const std::string& filename, std::size_t maxBytes, int maxFiles) {
+    std::lock_guard<std::mutex> lock(sinkMutex_);
+    if (logFile_.is_open()) {
+        logFile_.close();
+    }
+    logPath_ = filename;
+    maxBytes_ = maxBytes;
+    maxFiles_ = std::max(1, maxFiles);
+    logBytes_ = 0;
+    if (logPath_.empty()) {
+        return;
+    }
+
+    std::error_code ec;
+    std::filesystem::path path(logPath_);
+    if (path.has_parent_path()) {
+        std::filesystem::create_directories(path.parent_path(), ec);
+    }
+    if (std::filesystem::exists(path, ec)) {
+        logBytes_ = static_cast<std::size_t>(std::filesystem::file_size(path, ec));
+    }
+    logFile_.open(logPath_, std::ios::app);
+    if (!logFile_.is_open()) {
+        std::cerr << "[Logger] 无法打开日志文件: " << logPath_ << std::endl;
+    }
 }
 
 void Logger::enableConsole(bool enable) {
-    consoleEnabled_ = enable;
+    consoleEnabled_.store(enable, std::memory_order_relaxed);
 }
 
 void Logger::debug(const std::string& msg) {
-    log(Level::DEBUG, msg);
+    if (shouldLog(Level::DEBUG)) {
+        log(Level::DEBUG, msg);
+    }
 }
 
 void Logger::info(const std::string& msg) {
-    log(Level::INFO, msg);
+    if (shouldLog(Level::INFO)) {
+        log(Level::INFO, msg);
+    }
 }
 
 void Logger::warning(const std::string& msg) {
-    log(Level::WARNING, msg);
+    if (shouldLog(Level::WARNING)) {
+        log(Level::WARNING, msg);
+    }
 }
 
 void Logger::error(const std::string& msg) {
-    log(Level::ERROR, msg);
+    if (shouldLog(Level::ERROR)) {
+        log(Level::ERROR, msg);
+    }
+}
+
+void Logger::log(Level level, std::string msg) {
+    if (!running_.load(std::memory_order_acquire)) {
+        // 后台线程已停止（进程退出阶段），直接同步写出
+        std::lock_guard<std::mutex> lock(sinkMutex_);
+        writeLog(level, std::chrono::system_clock::now(), msg);
+        if (logFile_.is_open()) {
+            logFile_.flush();
+        }
+        std::cout.flush();
+        return;
+    }
+
+    if (!tryEnqueue(level, msg)) {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    // 警告及以上尽快写出；其余由后台线程按批处理
+    if (level >= Level::WARNING) {
+        wakeCv_.notify_one();
+    }
+}
+
+bool Logger::tryEnqueue(Level level, std::string& msg) {
+    constexpr std::size_t mask = kQueueCapacity - 1;
+    std::size_t pos = enqueuePos_.load(std::memory_order_relaxed);
+    Slot* slot = nullptr;
+    for (;;) {
+        slot = &ring_[pos & mask];
+        const std::size_t seq = slot->sequence.load(std::memory_order_acquire);
+        const auto diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos);
+        if (diff == 0) {
+            if (enqueuePos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        } else if (diff < 0) {
+            return false;  // 队列已满
+        } else {
+            pos = enqueuePos_.load(std::memory_order_relaxed);
+        }
+    }
+
+    slot->level = level;
+    slot->time = std::chrono::system_clock::now();
+    slot->message = std::move(msg);
+    slot->sequence.store(pos + 1, std::memory_order_release);
+    enqueued_.fetch_add(1, std::memory_order_relaxed);
+    return true;
 }
 
-void Logger::log(Level level, const std::string& msg) {
-    // TODO: 实现完整的日志记录逻辑
-    if (consoleEnabled_ && level >= level_) {
-        std::cout << "[" << levelToString(level) << "] " << msg << std::endl;
+bool Logger::tryDequeue(Level& level, std::chrono::system_clock::time_point& time, std::string& msg) {
+    Slot& slot = ring_[dequeuePos_ & (kQueueCapacity - 1)];
+    const std::size_t seq = slot.sequence.load(std::memory_order_acquire);
+    if (seq != dequeuePos_ + 1) {
+        return false;
     }
+
+    level = slot.level;
+    time = slot.time;
+    msg = std::move(slot.message);
+    slot.message.clear();
+    slot.sequence.store(dequeuePos_ + kQueueCapacity, std::memory_order_release);
+    ++dequeuePos_;
+    return true;
+}
+
+void Logger::drainLoop() {
+    Level level = Level::INFO;
+    std::chrono::system_clock::time_point time;
+    std::string msg;
+
+    for (;;) {
+        std::size_t batch = 0;
+        {
+            std::lock_guard<std::mutex> lock(sinkMutex_);
+            while (batch < kDrainBatch && tryDequeue(level, time, msg)) {
+                writeLog(level, time, msg);
+                ++batch;
+            }
+            if (batch > 0) {
+                if (logFile_.is_open()) {
+                    logFile_.flush();
+                }
+                if (consoleEnabled_.load(std::memory_order_relaxed)) {
+                    std::cout.flush();
+                }
+            }
+        }
+
+        if (batch > 0) {
+            written_.fetch_add(batch, std::memory_order_relaxed);
+            {
+                // 与 flush() 的等待同步，避免丢失通知
+                std::lock_guard<std::mutex> lock(wakeMutex_);
+            }
+            flushedCv_.notify_all();
+            continue;
+        }
+
+        if (!running_.load(std::memory_order_acquire)) {
+            break;
+        }
+
+        std::unique_lock<std::mutex> lock(wakeMutex_);
+        wakeCv_.wait_for(lock, kDrainIdleWait);
+    }
+}
+
+void Logger::flush() {
+    if (!running_.load(std::memory_order_acquire)) {
+        return;
+    }
+    const std::uint64_t target = enqueued_.load(std::memory_order_relaxed);
+    wakeCv_.notify_one();
+    std::unique_lock<std::mutex> lock(wakeMutex_);
+    flushedCv_.wait_for(lock, std::chrono::seconds(2), [this, target] {
+        return written_.load(std::memory_order_relaxed) >= target;
+    });
+}
+
+void Logger::shutdown() {
+    if (!running_.exchange(false, std::memory_order_acq_rel)) {
+        return;
+    }
+    wakeCv_.notify_one();
+    if (drainThread_.joinable()) {
+        drainThread_.join();
+    }
+
+    // 后台线程退出前可能仍有生产者刚写入的消息，由当前线程接手写出
+    std::lock_guard<std::mutex> lock(sinkMutex_);
+    Level level = Level::INFO;
+    std::chrono::system_clock::time_point time;
+    std::string msg;
+    while (tryDequeue(level, time, msg)) {
+        writeLog(level, time, msg);
+    }
+
+    const std::uint64_t dropped = dropped_.load(std::memory_order_relaxed);
+    if (dropped > 0) {
+        writeLog(Level::WARNING, std::chrono::system_clock::now(),
+                 "Logger dropped " + std::to_string(dropped) + " messages (queue full)");
+    }
+    if (logFile_.is_open()) {
+        logFile_.flush();
+    }
+    std::cout.flush();
+}
+
+std::uint64_t Logger::droppedCount() const {
+    return dropped_.load(std::memory_order_relaxed);
+}
+
+bool Logger::tryParseLevel(const std::string& name, Level& level) {
+    std::string lower = name;
+    std::transform(lower.begin(), lower.end(), lower.begin(), [](unsigned char c) {
+        return static_cast<char>(std::tolower(c));
+    });
+    if (lower == "debug") {
+        level = Level::DEBUG;
+    } else if (lower == "info") {
+        level = Level::INFO;
+    } else if (lower == "warning" || lower == "warn") {
+        level = Level::WARNING;
+    } else if (lower == "error") {
+        level = Level::ERROR;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+Logger::Level Logger::parseLevel(const std::string& name, Level fallback) {
+    Level level = fallback;
+    return tryParseLevel(name, level) ? level : fallback;
 }
 
 std::string Logger::levelToString(Level level) const {
@@ -67,13 +287,65 @@ std::string Logger::levelToString(Level level) const {
     }
 }
 
-std::string Logger::getCurrentTime() const {
-    // TODO: 实现时间格式化
-    return "";
+std::string Logger::formatTime(std::chrono::system_clock::time_point time) const {
+    const std::time_t seconds = std::chrono::system_clock::to_time_t(time);
+    const auto millis = std::chrono::duration_cast<std::chrono::milliseconds>(
+        time.time_since_epoch()).count() % 1000;
+
+    std::tm local{};
+    localtime_r(&seconds, &local);
+
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "%04d-%02d-%02d %02d:%02d:%02d.%03d",
+                  local.tm_year + 1900, local.tm_mon + 1, local.tm_mday,
+                  local.tm_hour, local.tm_min, local.tm_sec, static_cast<int>(millis));
+    return buffer;
+}
+
+void Logger::writeLog(Level level, std::chrono::system_clock::time_point time, const std::string& msg) {
+    // 调用方持有 sinkMutex_
+    if (consoleEnabled_.load(std::memory_order_relaxed)) {
+        std::cout << "[" << levelToString(level) << "] " << msg << '\n';
+    }
+
+    if (!logFile_.is_open()) {
+        return;
+    }
+
+    std::string line;
+    line.reserve(msg.size() + 40);
+    line += "[";
+    line += formatTime(time);
+    line += "] [";
+    line += levelToString(level);
+    line += "] ";
+    line += msg;
+    line += '\n';
+
+    logFile_.write(line.data(), static_cast<std::streamsize>(line.size()));
+    logBytes_ += line.size();
+    rotateIfNeededLocked();
 }
 
-void Logger::writeLog(Level level, const std::string& msg) {
-    // TODO: 实现日志写入
+void Logger::rotateIfNeededLocked() {
+    if (maxBytes_ == 0 || logBytes_ < maxBytes_ || logPath_.empty()) {
+        return;
+    }
+
+    logFile_.close();
+
+    std::error_code ec;
+    for (int i = maxFiles_ - 1; i >= 1; --i) {
+        std::filesystem::path src = logPath_ + "." + std::to_string(i);
+        std::filesystem::path dst = logPath_ + "." + std::to_string(i + 1);
+        if (std::filesystem::exists(src, ec)) {
+            std::filesystem::rename(src, dst, ec);
+        }
+    }
+    std::filesystem::rename(logPath_, logPath_ + ".1", ec);
+
+    logFile_.open(logPath_, std::ios::trunc);
+    logBytes_ = 0;
 }
 
 } // namespace snake
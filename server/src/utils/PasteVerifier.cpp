@@ -0,0 +1,234 @@
+#include "utils/PasteVerifier.h"
+#include "utils/Validator.h"
+#include "utils/Logger.h"
+#include "utils/PerformanceMonitor.h"
+#include <algorithm>
+#include <future>
+
+namespace snake {
+
+PasteVerifier::PasteVerifier(const Options& options, Fetcher fetcher)
+    : options_(options)
+    , fetcher_(fetcher ? std::move(fetcher) : Fetcher(&Validator::fetchLuoguPaste)) {
+    const int threads = std::max(1, options_.workerThreads);
+    workers_.reserve(static_cast<std::size_t>(threads));
+    for (int i = 0; i < threads; ++i) {
+        workers_.emplace_back(&PasteVerifier::workerLoop, this);
+    }
+}
+
+PasteVerifier::~PasteVerifier() {
+    shutdown();
+}
+
+void PasteVerifier::shutdown() {
+    std::deque<Job> pending;
+    {
+        std::lock_guard<std::mutex> lock(queueMutex_);
+        if (stopping_) {
+            return;
+        }
+        stopping_ = true;
+        pending.swap(queue_);
+    }
+    queueCv_.notify_all();
+    for (auto& worker : workers_) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+
+    // 未执行的任务通知等待者无法验证，避免请求悬挂
+    for (const auto& job : pending) {
+        complete(job.key, Verdict::UNAVAILABLE);
+    }
+}
+
+std::string PasteVerifier::makeKey(const std::string& uid, const std::string& paste) {
+    std::string key;
+    key.reserve(uid.size() + paste.size() + 1);
+    key += uid;
+    key += '\n';
+    key += paste;
+    return key;
+}
+
+void PasteVerifier::verifyAsync(const std::string& uid, const std::string& paste, Callback callback) {
+    // 万能 paste 与格式校验不需要访问网络，直接在调用线程返回
+    if (Validator::isUniversalPaste(paste)) {
+        LOG_INFO("Universal paste accepted for UID: " + uid);
+        callback(Verdict::ACCEPTED);
+        return;
+    }
+    if (!Validator::isValidUid(uid) || !Validator::isValidPasteId(paste)) {
+        LOG_WARNING("Invalid UID or paste format: " + uid);
+        callback(Verdict::REJECTED);
+        return;
+    }
+
+    const std::string key = makeKey(uid, paste);
+    Verdict cached = Verdict::UNAVAILABLE;
+    if (lookupCache(key, cached)) {
+        callback(cached);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(inflightMutex_);
+        // 加锁后再查一次缓存：上一个任务可能刚好完成；命中则在锁外回调
+        if (!lookupCache(key, cached)) {
+            auto it = inflight_.find(key);
+            if (it != inflight_.end()) {
+                // 已有相同请求在验证中，合并等待
+                it->second.push_back(std::move(callback));
+                return;
+            }
+            std::lock_guard<std::mutex> queueLock(queueMutex_);
+            if (stopping_) {
+                // 已停止：不再受理新的远程拉取
+                cached = Verdict::UNAVAILABLE;
+            } else if (inflight_.size() >= options_.maxPendingJobs) {
+                // 每个进行中的 key 对应一次远程拉取，超过上限时拒绝新任务而不是无限排队
+                LOG_WARNING("Paste verification queue full, rejecting UID: " + uid);
+                cached = Verdict::OVERLOADED;
+            } else {
+                inflight_[key].push_back(std::move(callback));
+                PerformanceMonitor::getInstance().setGauge("paste_verify_inflight",
+                                                           static_cast<double>(inflight_.size()));
+
+                queue_.push_back(Job{key, uid, paste});
+                queueCv_.notify_one();
+                return;
+            }
+        }
+    }
+    callback(cached);
+}
+
+PasteVerifier::Verdict PasteVerifier::verify(const std::string& uid, const std::string& paste) {
+    auto promise = std::make_shared<std::promise<Verdict>>();
+    auto future = promise->get_future();
+    verifyAsync(uid, paste, [promise](Verdict verdict) {
+        promise->set_value(verdict);
+    });
+    return future.get();
+}
+
+void PasteVerifier::setFetcher(Fetcher fetcher) {
+    std::lock_guard<std::mutex> lock(fetcherMutex_);
+    fetcher_ = fetcher ? std::move(fetcher) : Fetcher(&Validator::fetchLuoguPaste);
+}
+
+std::size_t PasteVerifier::cacheSize() const {
+    std::lock_guard<std::mutex> lock(cacheMutex_);
+    return cache_.size();
+}
+
+bool PasteVerifier::lookupCache(const std::string& key, Verdict& verdict) {
+    std::lock_guard<std::mutex> lock(cacheMutex_);
+    auto it = cache_.find(key);
+    if (it == cache_.end()) {
+        return false;
+    }
+    if (it->second.expiresAt <= std::chrono::steady_clock::now()) {
+        cache_.erase(it);
+        return false;
+    }
+    verdict = it->second.verdict;
+    return true;
+}
+
+void PasteVerifier::storeCache(const std::string& key, Verdict verdict) {
+    int ttlSeconds = 0;
+    if (verdict == Verdict::ACCEPTED) {
+        ttlSeconds = options_.positiveTtlSeconds;
+    } else if (verdict == Verdict::REJECTED) {
+        ttlSeconds = options_.negativeTtlSeconds;
+    }
+    if (ttlSeconds <= 0) {
+        return;
+    }
+
+    const auto now = std::chrono::steady_clock::now();
+    std::lock_guard<std::mutex> lock(cacheMutex_);
+    if (cache_.size() >= options_.maxCacheEntries) {
+        // 先清理过期项，仍然超限则整体清空（登录频率低，重建代价可接受）
+        for (auto it = cache_.begin(); it != cache_.end();) {
+            if (it->second.expiresAt <= now) {
+                it = cache_.erase(it);
+            } else {
+                ++it;
+            }
+        }
+        if (cache_.size() >= options_.maxCacheEntries) {
+            cache_.clear();
+        }
+    }
+    cache_[key] = CacheEntry{verdict, now + std::chrono::seconds(ttlSeconds)};
+    PerformanceMonitor::getInstance().setGauge("paste_verify_cache_entries",
+                                               static_cast<double>(cache_.size()));
+}
+
+PasteVerifier::Verdict PasteVerifier::runVerification(const Job& job) {
+    Fetcher fetcher;
+    {
+        std::lock_guard<std::mutex> lock(fetcherMutex_);
+        fetcher = fetcher_;
+    }
+
+    try {
+        LOG_INFO("Validating Luogu paste: https://www.luogu.com/paste/" + job.paste);
+        const std::string html = fetcher(job.paste);
+        if (html.empty()) {
+            LOG_WARNING("Failed to fetch paste content or paste not found");
+            return Verdict::UNAVAILABLE;
+        }
+        return Validator::verifyPasteHtml(job.uid, job.paste, html) ? Verdict::ACCEPTED : Verdict::REJECTED;
+    } catch (const std::exception& e) {
+        LOG_ERROR("Exception during paste validation: " + std::string(e.what()));
+        return Verdict::UNAVAILABLE;
+    }
+}
+
+void PasteVerifier::complete(const std::string& key, Verdict verdict) {
+    storeCache(key, verdict);
+
+    std::vector<Callback> waiters;
+    {
+        std::lock_guard<std::mutex> lock(inflightMutex_);
+        auto it = inflight_.find(key);
+        if (it != inflight_.end()) {
+            waiters.swap(it->second);
+            inflight_.erase(it);
+        }
+        PerformanceMonitor::getInstance().setGauge("paste_verify_inflight",
+                                                   static_cast<double>(inflight_.size()));
+    }
+
+    for (auto& waiter : waiters) {
+        try {
+            waiter(verdict);
+        } catch (const std::exception& e) {
+            LOG_ERROR("Paste verification callback failed: " + std::string(e.what()));
+        }
+    }
+}
+
+void PasteVerifier::workerLoop() {
+    for (;;) {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(queueMutex_);
+            queueCv_.wait(lock, [this] { return stopping_ || !queue_.empty(); });
+            if (stopping_) {
+                return;
+            }
+            job = std::move(queue_.front());
+            queue_.pop_front();
+        }
+
+        complete(job.key, runVerification(job));
+    }
+}
+
+} // namespace snake
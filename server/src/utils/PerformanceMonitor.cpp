@@ -1,4 +1,5 @@
 #include "utils/PerformanceMonitor.h"
+#include "utils/TraceRecorder.h"
 
 #include <algorithm>
 #include <cmath>
@@ -7,15 +8,50 @@
 #include <random>
 #include <sstream>
 #include <thread>
-#include <vector>
 
 namespace snake {
 
 namespace {
-constexpr double kPercentile95 = 0.95;
-constexpr double kPercentile99 = 0.99;
+
+// 对外输出的分位数：{JSON 字段名, Prometheus quantile 标签, 分位值}
+struct QuantileSpec {
+    const char* key;
+    const char* label;
+    double value;
+};
+
+constexpr QuantileSpec kQuantiles[] = {
+    {"p50", "0.5", 0.50},
+    {"p90", "0.9", 0.90},
+    {"p95", "0.95", 0.95},
+    {"p99", "0.99", 0.99},
+    {"p999", "0.999", 0.999},
+};
+
+double usToMs(std::uint64_t us) {
+    return static_cast<double>(us) / 1000.0;
+}
+
+std::uint64_t msToUs(double ms) {
+    if (!(ms > 0.0)) {
+        return 0;
+    }
+    return static_cast<std::uint64_t>(std::llround(ms * 1000.0));
+}
+
+nlohmann::json histogramToJson(const LatencyHistogram::Snapshot& snapshot) {
+    nlohmann::json result = nlohmann::json::object();
+    for (const auto& q : kQuantiles) {
+        result[q.key] = usToMs(snapshot.percentileUs(q.value));
+    }
+    result["max"] = usToMs(snapshot.maxUs);
+    result["avg"] = snapshot.meanUs() / 1000.0;
+    result["count"] = snapshot.count;
+    return result;
 }
 
+} // namespace
+
 PerformanceMonitor& PerformanceMonitor::getInstance() {
     static PerformanceMonitor instance;
     return instance;
@@ -35,17 +71,52 @@ PerformanceMonitor::ScopedRequest::ScopedRequest(const std::string& endpoint)
 }
 
 PerformanceMonitor::ScopedRequest::~ScopedRequest() {
-    if (!enabled_) {
+    auto& tracer = TraceRecorder::getInstance();
+    const bool tracing = tracer.isCapturing();
+    if (!enabled_ && !tracing) {
+        return;
+    }
+    auto end = std::chrono::steady_clock::now();
+    if (enabled_) {
+        double latencyMs = std::chrono::duration<double, std::milli>(end - start_).count();
+        PerformanceMonitor::getInstance().recordRequest(endpoint_, latencyMs);
+    }
+    if (tracing) {
+        tracer.recordSpan(endpoint_, "request", start_, end);
+    }
+}
+
+PerformanceMonitor::ScopedPhase::ScopedPhase(const char* phase)
+    : phase_(phase) {
+    enabled_ = PerformanceMonitor::getInstance().isEnabled();
+    tracing_ = TraceRecorder::getInstance().isCapturing();
+    if (enabled_ || tracing_) {
+        start_ = std::chrono::steady_clock::now();
+    }
+}
+
+PerformanceMonitor::ScopedPhase::~ScopedPhase() {
+    if (!enabled_ && !tracing_) {
         return;
     }
     auto end = std::chrono::steady_clock::now();
-    double latencyMs = std::chrono::duration<double, std::milli>(end - start_).count();
-    PerformanceMonitor::getInstance().recordRequest(endpoint_, latencyMs);
+    if (enabled_) {
+        double phaseMs = std::chrono::duration<double, std::milli>(end - start_).count();
+        PerformanceMonitor::getInstance().observePhase(phase_, phaseMs);
+    }
+    if (tracing_) {
+        TraceRecorder::getInstance().recordSpan(phase_, "tick", start_, end);
+    }
 }
 
 void PerformanceMonitor::configure(const Config& config) {
-    std::lock_guard<std::mutex> lock(mutex_);
     config_ = config;
+    // 统计窗口需要的槽位（含当前未满的一片）不能超过环形窗口容量
+    const int usableSlots = static_cast<int>(RateWindow::kSlotCount) - 2;
+    const int windowSeconds = std::max(1, config_.windowSeconds);
+    rateSlotSeconds_ = std::max(1, (windowSeconds + usableSlots - 1) / usableSlots);
+    const int fullSlices = static_cast<int>(WindowedHistogram::kSliceCount) - 1;
+    histogramSliceSeconds_ = std::max(1, (windowSeconds + fullSlices - 1) / fullSlices);
     enabled_.store(config_.enabled, std::memory_order_release);
 }
 
@@ -75,56 +146,121 @@ bool PerformanceMonitor::isEnabled() const {
     return enabled_.load(std::memory_order_acquire);
 }
 
-void PerformanceMonitor::recordRequest(const std::string& endpoint, double latencyMs) {
-    if (!isEnabled()) {
-        return;
+int PerformanceMonitor::NameRegistry::intern(const std::string& name) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = ids_.find(name);
+    if (it != ids_.end()) {
+        return it->second;
     }
+    if (names_.size() >= kMaxSeries) {
+        return -1;
+    }
+    const int id = static_cast<int>(names_.size());
+    names_.push_back(name);
+    ids_.emplace(name, id);
+    return id;
+}
 
-    auto now = std::chrono::steady_clock::now();
-
+std::vector<std::string> PerformanceMonitor::NameRegistry::names() const {
     std::lock_guard<std::mutex> lock(mutex_);
-    pruneDeque(qpsAll_, now);
-    qpsAll_.push_back(now);
+    return names_;
+}
 
-    auto& endpointQps = qpsByEndpoint_[endpoint];
-    pruneDeque(endpointQps, now);
-    endpointQps.push_back(now);
+PerformanceMonitor::ThreadShard& PerformanceMonitor::localShard() {
+    thread_local ThreadShard* shard = nullptr;
+    if (shard == nullptr) {
+        auto created = std::make_unique<ThreadShard>();
+        created->rngState = std::random_device{}() | 1ULL;
+        shard = created.get();
+        std::lock_guard<std::mutex> lock(shardsMutex_);
+        shards_.push_back(std::move(created));
+    }
+    return *shard;
+}
 
-    totalRequests_ += 1;
-    requestCounts_[endpoint] += 1;
+PerformanceMonitor::Series* PerformanceMonitor::localSeries(ThreadShard& shard, SeriesSlots& slots,
+                                                            std::unordered_map<std::string, int>& cache,
+                                                            NameRegistry& registry, const std::string& name,
+                                                            int& id) {
+    id = -1;
+    auto it = cache.find(name);
+    if (it != cache.end()) {
+        id = it->second;
+    } else {
+        id = registry.intern(name);
+        cache.emplace(name, id);
+    }
+    if (id < 0) {
+        return nullptr;
+    }
+
+    Series* series = slots[id].load(std::memory_order_relaxed);
+    if (series == nullptr) {
+        shard.owned.push_back(std::make_unique<Series>());
+        series = shard.owned.back().get();
+        // release：采集线程看到指针时，Series 已构造完成
+        slots[id].store(series, std::memory_order_release);
+    }
+    return series;
+}
 
-    if (!shouldSample()) {
-        return;
+std::vector<PerformanceMonitor::ThreadShard*> PerformanceMonitor::allShards() const {
+    std::lock_guard<std::mutex> lock(shardsMutex_);
+    std::vector<ThreadShard*> result;
+    result.reserve(shards_.size());
+    for (const auto& shard : shards_) {
+        result.push_back(shard.get());
     }
+    return result;
+}
+
+std::int64_t PerformanceMonitor::currentTick(std::chrono::steady_clock::time_point now) const {
+    const auto seconds = std::chrono::duration_cast<std::chrono::seconds>(now.time_since_epoch()).count();
+    return static_cast<std::int64_t>(seconds) / rateSlotSeconds_;
+}
+
+std::int64_t PerformanceMonitor::histogramTick(std::chrono::steady_clock::time_point now) const {
+    const auto seconds = std::chrono::duration_cast<std::chrono::seconds>(now.time_since_epoch()).count();
+    return static_cast<std::int64_t>(seconds) / histogramSliceSeconds_;
+}
+
+std::int64_t PerformanceMonitor::histogramTick() const {
+    return histogramTick(std::chrono::steady_clock::now());
+}
 
-    latencyAll_.push_back(latencyMs);
-    if (static_cast<int>(latencyAll_.size()) > config_.maxSamples) {
-        latencyAll_.pop_front();
+void PerformanceMonitor::recordRequest(const std::string& endpoint, double latencyMs) {
+    if (!isEnabled()) {
+        return;
     }
 
-    auto& samples = latencyByEndpoint_[endpoint];
-    samples.push_back(latencyMs);
-    if (static_cast<int>(samples.size()) > config_.maxSamples) {
-        samples.pop_front();
+    ThreadShard& shard = localShard();
+    int id = -1;
+    Series* series = localSeries(shard, shard.requests, shard.requestIds, requestNames_, endpoint, id);
+    if (series == nullptr) {
+        return;
     }
+    const auto now = std::chrono::steady_clock::now();
+    series->rate.add(currentTick(now));
+    series->latency.record(msToUs(latencyMs), histogramTick(now));
 }
 
 void PerformanceMonitor::recordLockWait(const std::string& lockName, double waitMs) {
     if (!isEnabled()) {
         return;
     }
-    if (!shouldSample()) {
+
+    ThreadShard& shard = localShard();
+    if (!shouldSample(shard)) {
         return;
     }
 
-    std::lock_guard<std::mutex> lock(mutex_);
-    auto& stat = lockStats_[lockName];
-    stat.count += 1;
-    stat.totalWaitMs += waitMs;
-    stat.lastWaitMs = waitMs;
-    if (waitMs > stat.maxWaitMs) {
-        stat.maxWaitMs = waitMs;
+    int id = -1;
+    Series* series = localSeries(shard, shard.locks, shard.lockIds, lockNames_, lockName, id);
+    if (series == nullptr) {
+        return;
     }
+    series->latency.record(msToUs(waitMs), histogramTick());
+    lockLastMs_[id].store(waitMs, std::memory_order_relaxed);
 }
 
 void PerformanceMonitor::observeRoundDuration(double roundMs) {
@@ -132,12 +268,38 @@ void PerformanceMonitor::observeRoundDuration(double roundMs) {
         return;
     }
 
-    std::lock_guard<std::mutex> lock(mutex_);
-    lastRoundMs_ = roundMs;
-    roundSamples_.push_back(roundMs);
-    if (static_cast<int>(roundSamples_.size()) > config_.maxSamples) {
-        roundSamples_.pop_front();
+    localShard().rounds.record(msToUs(roundMs), histogramTick());
+    lastRoundMs_.store(roundMs, std::memory_order_relaxed);
+}
+
+void PerformanceMonitor::observeTickJitter(double latenessMs) {
+    if (!isEnabled()) {
+        return;
+    }
+
+    localShard().tickJitter.record(msToUs(latenessMs), histogramTick());
+}
+
+void PerformanceMonitor::recordTickOverrun(int missedDeadlines) {
+    if (!isEnabled() || missedDeadlines <= 0) {
+        return;
+    }
+
+    tickOverruns_.fetch_add(static_cast<std::uint64_t>(missedDeadlines), std::memory_order_relaxed);
+}
+
+void PerformanceMonitor::observePhase(const std::string& phase, double phaseMs) {
+    if (!isEnabled()) {
+        return;
     }
+
+    ThreadShard& shard = localShard();
+    int id = -1;
+    Series* series = localSeries(shard, shard.phases, shard.phaseIds, phaseNames_, phase, id);
+    if (series == nullptr) {
+        return;
+    }
+    series->latency.record(msToUs(phaseMs), histogramTick());
 }
 
 void PerformanceMonitor::setGauge(const std::string& name, double value) {
@@ -145,8 +307,19 @@ void PerformanceMonitor::setGauge(const std::string& name, double value) {
         return;
     }
 
-    std::lock_guard<std::mutex> lock(mutex_);
-    gauges_[name] = value;
+    ThreadShard& shard = localShard();
+    int id = -1;
+    auto it = shard.gaugeIds.find(name);
+    if (it != shard.gaugeIds.end()) {
+        id = it->second;
+    } else {
+        id = gaugeNames_.intern(name);
+        shard.gaugeIds.emplace(name, id);
+    }
+    if (id < 0) {
+        return;
+    }
+    gauges_[id].store(value, std::memory_order_relaxed);
 }
 
 nlohmann::json PerformanceMonitor::toJson() const {
@@ -159,80 +332,122 @@ nlohmann::json PerformanceMonitor::toJson() const {
     auto nowSystem = std::chrono::system_clock::now();
     long long timestampMs = std::chrono::duration_cast<std::chrono::milliseconds>(
         nowSystem.time_since_epoch()).count();
+
+    /**
+     * QPS 窗口：最近 windowSlots 个完整时间片 + 当前未满的时间片，
+     * 分母使用实际覆盖的时长，避免当前时间片未满导致结果偏低。
+     */
     auto nowSteady = std::chrono::steady_clock::now();
-    auto windowStart = nowSteady - std::chrono::seconds(std::max(1, config_.windowSeconds));
+    const std::int64_t nowTick = currentTick(nowSteady);
+    const int windowSeconds = std::max(1, config_.windowSeconds);
+    const std::int64_t windowSlots = (windowSeconds + rateSlotSeconds_ - 1) / rateSlotSeconds_;
+    const double sinceEpoch = std::chrono::duration<double>(nowSteady.time_since_epoch()).count();
+    const double partialSeconds = sinceEpoch - static_cast<double>(nowTick * rateSlotSeconds_);
+    const double coveredSeconds = static_cast<double>(windowSlots * rateSlotSeconds_) + partialSeconds;
+    // 分位数窗口：最近 kSliceCount - 1 个完整直方图时间片 + 当前时间片
+    const std::int64_t histNow = histogramTick(nowSteady);
+    const std::int64_t histFrom = histNow - static_cast<std::int64_t>(WindowedHistogram::kSliceCount) + 1;
+
+    const std::vector<ThreadShard*> shards = allShards();
 
-    std::lock_guard<std::mutex> lock(mutex_);
     snapshot["enabled"] = true;
     snapshot["timestamp_ms"] = timestampMs;
     snapshot["config"] = {
         {"window_seconds", config_.windowSeconds},
+        {"histogram_slice_seconds", histogramSliceSeconds_},
         {"sample_rate", config_.sampleRate},
-        {"max_samples", config_.maxSamples}
+        {"thread_shards", shards.size()}
     };
 
-    std::size_t overallCount = static_cast<std::size_t>(std::count_if(
-        qpsAll_.begin(), qpsAll_.end(),
-        [&](const auto& ts) { return ts >= windowStart; }));
-    double overallQps = static_cast<double>(overallCount) /
-                        static_cast<double>(std::max(1, config_.windowSeconds));
-    snapshot["qps"]["overall"] = overallQps;
-
+    // 请求：逐个端点合并所有线程分片
+    const std::vector<std::string> endpoints = requestNames_.names();
+    LatencyHistogram::Snapshot overall;
+    std::uint64_t overallWindowCount = 0;
+    std::uint64_t overallTotal = 0;
     nlohmann::json qpsByEndpoint = nlohmann::json::object();
-    for (const auto& kv : qpsByEndpoint_) {
-        std::size_t count = static_cast<std::size_t>(std::count_if(
-            kv.second.begin(), kv.second.end(),
-            [&](const auto& ts) { return ts >= windowStart; }));
-        double qps = static_cast<double>(count) /
-                     static_cast<double>(std::max(1, config_.windowSeconds));
-        qpsByEndpoint[kv.first] = qps;
-    }
-    snapshot["qps"]["per_endpoint"] = qpsByEndpoint;
-
-    snapshot["requests_total"] = totalRequests_;
     nlohmann::json reqByEndpoint = nlohmann::json::object();
-    for (const auto& kv : requestCounts_) {
-        reqByEndpoint[kv.first] = kv.second;
-    }
-    snapshot["requests_total_per_endpoint"] = reqByEndpoint;
-
-    snapshot["latency_ms"]["overall"] = {
-        {"p95", percentile(latencyAll_, kPercentile95)},
-        {"p99", percentile(latencyAll_, kPercentile99)},
-        {"sample_count", latencyAll_.size()}
-    };
-
     nlohmann::json latencyPerEndpoint = nlohmann::json::object();
-    for (const auto& kv : latencyByEndpoint_) {
-        latencyPerEndpoint[kv.first] = {
-            {"p95", percentile(kv.second, kPercentile95)},
-            {"p99", percentile(kv.second, kPercentile99)},
-            {"sample_count", kv.second.size()}
-        };
+    for (std::size_t id = 0; id < endpoints.size(); ++id) {
+        LatencyHistogram::Snapshot merged;
+        std::uint64_t windowCount = 0;
+        std::uint64_t total = 0;
+        for (const ThreadShard* shard : shards) {
+            const Series* series = shard->requests[id].load(std::memory_order_acquire);
+            if (series == nullptr) {
+                continue;
+            }
+            series->latency.merge(merged, histFrom, histNow);
+            windowCount += series->rate.sum(nowTick - windowSlots, nowTick);
+            total += series->latency.total();
+        }
+        overall.merge(merged);
+        overallWindowCount += windowCount;
+        overallTotal += total;
+
+        qpsByEndpoint[endpoints[id]] = static_cast<double>(windowCount) / coveredSeconds;
+        reqByEndpoint[endpoints[id]] = total;
+        latencyPerEndpoint[endpoints[id]] = histogramToJson(merged);
     }
+
+    snapshot["qps"]["overall"] = static_cast<double>(overallWindowCount) / coveredSeconds;
+    snapshot["qps"]["per_endpoint"] = qpsByEndpoint;
+    snapshot["requests_total"] = overallTotal;
+    snapshot["requests_total_per_endpoint"] = reqByEndpoint;
+    snapshot["latency_ms"]["overall"] = histogramToJson(overall);
     snapshot["latency_ms"]["per_endpoint"] = latencyPerEndpoint;
 
-    snapshot["round_ms"] = {
-        {"last", lastRoundMs_},
-        {"p95", percentile(roundSamples_, kPercentile95)},
-        {"p99", percentile(roundSamples_, kPercentile99)},
-        {"sample_count", roundSamples_.size()}
-    };
+    LatencyHistogram::Snapshot rounds;
+    LatencyHistogram::Snapshot tickJitter;
+    for (const ThreadShard* shard : shards) {
+        shard->rounds.merge(rounds, histFrom, histNow);
+        shard->tickJitter.merge(tickJitter, histFrom, histNow);
+    }
+    snapshot["round_ms"] = histogramToJson(rounds);
+    snapshot["round_ms"]["last"] = lastRoundMs_.load(std::memory_order_relaxed);
+    snapshot["tick_jitter_ms"] = histogramToJson(tickJitter);
+    snapshot["tick_overruns"] = tickOverruns_.load(std::memory_order_relaxed);
+
+    // 回合各阶段耗时（leaderboard 为嵌套在碰撞/食物阶段内的排行榜写入合计）
+    const std::vector<std::string> phaseNames = phaseNames_.names();
+    nlohmann::json phases = nlohmann::json::object();
+    for (std::size_t id = 0; id < phaseNames.size(); ++id) {
+        LatencyHistogram::Snapshot merged;
+        for (const ThreadShard* shard : shards) {
+            const Series* series = shard->phases[id].load(std::memory_order_acquire);
+            if (series != nullptr) {
+                series->latency.merge(merged, histFrom, histNow);
+            }
+        }
+        phases[phaseNames[id]] = histogramToJson(merged);
+    }
+    snapshot["tick_phases_ms"] = phases;
 
+    const std::vector<std::string> lockNames = lockNames_.names();
     nlohmann::json lockStats = nlohmann::json::object();
-    for (const auto& kv : lockStats_) {
-        const auto& stat = kv.second;
-        double avg = (stat.count == 0) ? 0.0 : (stat.totalWaitMs / stat.count);
-        lockStats[kv.first] = {
-            {"count", stat.count},
-            {"avg_ms", avg},
-            {"max_ms", stat.maxWaitMs},
-            {"last_ms", stat.lastWaitMs}
+    for (std::size_t id = 0; id < lockNames.size(); ++id) {
+        LatencyHistogram::Snapshot merged;
+        for (const ThreadShard* shard : shards) {
+            const Series* series = shard->locks[id].load(std::memory_order_acquire);
+            if (series != nullptr) {
+                series->latency.merge(merged, histFrom, histNow);
+            }
+        }
+        lockStats[lockNames[id]] = {
+            {"count", merged.count},
+            {"avg_ms", merged.meanUs() / 1000.0},
+            {"p99_ms", usToMs(merged.percentileUs(0.99))},
+            {"max_ms", usToMs(merged.maxUs)},
+            {"last_ms", lockLastMs_[id].load(std::memory_order_relaxed)}
         };
     }
     snapshot["locks"] = lockStats;
 
-    snapshot["gauges"] = gauges_;
+    const std::vector<std::string> gaugeNames = gaugeNames_.names();
+    nlohmann::json gauges = nlohmann::json::object();
+    for (std::size_t id = 0; id < gaugeNames.size(); ++id) {
+        gauges[gaugeNames[id]] = gauges_[id].load(std::memory_order_relaxed);
+    }
+    snapshot["gauges"] = gauges;
 
     snapshot["memory"] = {
         {"rss_bytes", getRssBytes()}
@@ -267,31 +482,57 @@ std::string PerformanceMonitor::toPrometheus() const {
     out << "# HELP snake_request_latency_ms Request latency percentiles\n";
     out << "# TYPE snake_request_latency_ms gauge\n";
     auto overallLatency = snapshot["latency_ms"]["overall"];
-    out << "snake_request_latency_ms{quantile=\"0.95\",endpoint=\"all\"} "
-        << overallLatency["p95"].get<double>() << "\n";
-    out << "snake_request_latency_ms{quantile=\"0.99\",endpoint=\"all\"} "
-        << overallLatency["p99"].get<double>() << "\n";
+    for (const auto& q : kQuantiles) {
+        out << "snake_request_latency_ms{quantile=\"" << q.label << "\",endpoint=\"all\"} "
+            << overallLatency[q.key].get<double>() << "\n";
+    }
 
     for (auto& kv : snapshot["latency_ms"]["per_endpoint"].items()) {
         const auto& entry = kv.value();
-        out << "snake_request_latency_ms{quantile=\"0.95\",endpoint=\"" << kv.key() << "\"} "
-            << entry["p95"].get<double>() << "\n";
-        out << "snake_request_latency_ms{quantile=\"0.99\",endpoint=\"" << kv.key() << "\"} "
-            << entry["p99"].get<double>() << "\n";
+        for (const auto& q : kQuantiles) {
+            out << "snake_request_latency_ms{quantile=\"" << q.label << "\",endpoint=\"" << kv.key() << "\"} "
+                << entry[q.key].get<double>() << "\n";
+        }
     }
 
     out << "# HELP snake_round_duration_ms Round duration percentiles\n";
     out << "# TYPE snake_round_duration_ms gauge\n";
     auto roundMs = snapshot["round_ms"];
     out << "snake_round_duration_ms{quantile=\"last\"} " << roundMs["last"].get<double>() << "\n";
-    out << "snake_round_duration_ms{quantile=\"0.95\"} " << roundMs["p95"].get<double>() << "\n";
-    out << "snake_round_duration_ms{quantile=\"0.99\"} " << roundMs["p99"].get<double>() << "\n";
+    for (const auto& q : kQuantiles) {
+        out << "snake_round_duration_ms{quantile=\"" << q.label << "\"} "
+            << roundMs[q.key].get<double>() << "\n";
+    }
+
+    out << "# HELP snake_tick_jitter_ms Tick start lateness relative to the scheduled deadline\n";
+    out << "# TYPE snake_tick_jitter_ms gauge\n";
+    auto jitterMs = snapshot["tick_jitter_ms"];
+    for (const auto& q : kQuantiles) {
+        out << "snake_tick_jitter_ms{quantile=\"" << q.label << "\"} "
+            << jitterMs[q.key].get<double>() << "\n";
+    }
+
+    out << "# HELP snake_tick_overruns_total Deadlines skipped because a tick overran the round time\n";
+    out << "# TYPE snake_tick_overruns_total counter\n";
+    out << "snake_tick_overruns_total " << snapshot["tick_overruns"].get<std::uint64_t>() << "\n";
+
+    out << "# HELP snake_tick_phase_ms Tick phase duration percentiles\n";
+    out << "# TYPE snake_tick_phase_ms gauge\n";
+    for (auto& kv : snapshot["tick_phases_ms"].items()) {
+        const auto& entry = kv.value();
+        for (const auto& q : kQuantiles) {
+            out << "snake_tick_phase_ms{phase=\"" << kv.key() << "\",quantile=\"" << q.label << "\"} "
+                << entry[q.key].get<double>() << "\n";
+        }
+    }
 
     out << "# HELP snake_lock_wait_ms Lock wait statistics\n";
     out << "# TYPE snake_lock_wait_ms gauge\n";
     for (auto& kv : snapshot["locks"].items()) {
         out << "snake_lock_wait_ms{lock=\"" << kv.key() << "\",stat=\"avg\"} "
             << kv.value()["avg_ms"].get<double>() << "\n";
+        out << "snake_lock_wait_ms{lock=\"" << kv.key() << "\",stat=\"p99\"} "
+            << kv.value()["p99_ms"].get<double>() << "\n";
         out << "snake_lock_wait_ms{lock=\"" << kv.key() << "\",stat=\"max\"} "
             << kv.value()["max_ms"].get<double>() << "\n";
         out << "snake_lock_wait_ms{lock=\"" << kv.key() << "\",stat=\"last\"} "
@@ -312,35 +553,20 @@ std::string PerformanceMonitor::toPrometheus() const {
     return out.str();
 }
 
-bool PerformanceMonitor::shouldSample() const {
+bool PerformanceMonitor::shouldSample(ThreadShard& shard) const {
     if (config_.sampleRate >= 1.0) {
         return true;
     }
     if (config_.sampleRate <= 0.0) {
         return false;
     }
-    thread_local std::mt19937 rng(std::random_device{}());
-    std::uniform_real_distribution<double> dist(0.0, 1.0);
-    return dist(rng) < config_.sampleRate;
-}
-
-void PerformanceMonitor::pruneDeque(std::deque<std::chrono::steady_clock::time_point>& deque,
-                                   const std::chrono::steady_clock::time_point& now) const {
-    auto windowStart = now - std::chrono::seconds(std::max(1, config_.windowSeconds));
-    while (!deque.empty() && deque.front() < windowStart) {
-        deque.pop_front();
-    }
-}
-
-double PerformanceMonitor::percentile(const std::deque<double>& samples, double p) const {
-    if (samples.empty()) {
-        return 0.0;
-    }
-    std::vector<double> values(samples.begin(), samples.end());
-    std::sort(values.begin(), values.end());
-    double idx = std::ceil(p * (values.size() - 1));
-    std::size_t pos = static_cast<std::size_t>(std::min<double>(idx, values.size() - 1));
-    return values[pos];
+    // xorshift64：比 mt19937 + 分布对象便宜得多，采样只需要粗略的均匀性
+    std::uint64_t x = shard.rngState;
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    shard.rngState = x;
+    return static_cast<double>(x >> 11) * (1.0 / 9007199254740992.0) < config_.sampleRate;
 }
 
 std::uint64_t PerformanceMonitor::getRssBytes() const {
@@ -1,108 +1,224 @@
 #include "utils/RateLimiter.h"
+#include "utils/PerformanceMonitor.h"
+#include <algorithm>
+#include <functional>
 
 namespace snake {
 
-RateLimiter::RateLimiter() {
-    // 构造函数
+RateLimiter::RateLimiter(int sweepIntervalSeconds, std::size_t maxTrackedKeys)
+    : maxKeysPerShard_(std::max<std::size_t>(1, maxTrackedKeys / kShardCount))
+    , sweepInterval_(std::max(1, sweepIntervalSeconds)) {
+    if (sweepIntervalSeconds > 0) {
+        sweepThread_ = std::thread(&RateLimiter::sweepLoop, this);
+    }
 }
 
 RateLimiter::~RateLimiter() {
-    // 析构函数
+    {
+        std::lock_guard<std::mutex> lock(sweepMutex_);
+        stopping_ = true;
+    }
+    sweepCv_.notify_all();
+    if (sweepThread_.joinable()) {
+        sweepThread_.join();
+    }
 }
 
-bool RateLimiter::checkLimit(const std::string& key, int maxRequests, int windowSeconds) {
-    if (maxRequests <= 0 || windowSeconds <= 0) {
+std::int64_t RateLimiter::nowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+std::int64_t RateLimiter::emissionIntervalNs(int maxRequests, std::chrono::milliseconds window) {
+    const std::int64_t windowNs = std::chrono::duration_cast<std::chrono::nanoseconds>(window).count();
+    return std::max<std::int64_t>(1, windowNs / maxRequests);
+}
+
+std::size_t RateLimiter::shardIndex(const std::string& key) {
+    return std::hash<std::string>{}(key) % kShardCount;
+}
+
+bool RateLimiter::checkLimit(Endpoint endpoint, const std::string& key,
+                             int maxRequests, std::chrono::milliseconds window) {
+    if (maxRequests <= 0 || window.count() <= 0) {
+        return true;
+    }
+
+    /**
+     * GCRA 判定：
+     * - T   = window / maxRequests（两次请求的理想间隔）
+     * - tau = window - T（允许的突发容差，即窗口内最多 maxRequests 次连续请求）
+     * - 若 TAT - tau > now 则拒绝；否则放行并令 TAT = max(TAT, now) + T
+     */
+    const std::int64_t now = nowNs();
+    const std::int64_t interval = emissionIntervalNs(maxRequests, window);
+    const std::int64_t tolerance = std::chrono::duration_cast<std::chrono::nanoseconds>(window).count() - interval;
+
+    Shard& shard = shards_[shardIndex(key)];
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto& tats = shard.tats[static_cast<std::size_t>(endpoint)];
+
+    auto it = tats.find(key);
+    if (it != tats.end()) {
+        const std::int64_t tat = std::max(it->second.tat, now);
+        if (tat - tolerance > now) {
+            return false; // 超过限制
+        }
+        it->second.tat = tat + interval;
         return true;
     }
 
-    std::lock_guard<std::mutex> lock(mutex_);
-    
-    auto now = std::chrono::system_clock::now();
-    auto windowStart = now - std::chrono::seconds(windowSeconds);
-    
-    // 获取或创建记录
-    auto& record = records_[key];
-    
-    // 清理过期的时间戳
-    while (!record.timestamps.empty() && record.timestamps.front() < windowStart) {
-        record.timestamps.pop_front();
-    }
-    
-    // 检查是否超过限制
-    if (static_cast<int>(record.timestamps.size()) >= maxRequests) {
-        return false; // 超过限制
-    }
-    
-    // 记录当前请求时间
-    record.timestamps.push_back(now);
-    
+    // 新键：分片已满时淘汰一条（全量清扫留给后台线程）
+    if (shard.keyCount >= maxKeysPerShard_) {
+        evictOneLocked(shard, now);
+    }
+
+    const std::uint64_t seq = shard.nextSeq++;
+    tats.emplace(key, TatEntry{now + interval, seq});
+    shard.ring.push_back(RingEntry{static_cast<std::uint8_t>(endpoint), seq, key});
+    shard.keyCount += 1;
+    trackedKeys_.fetch_add(1, std::memory_order_relaxed);
     return true; // 允许通过
 }
 
-int RateLimiter::getRetryAfter(const std::string& key, int maxRequests, int windowSeconds) const {
-    if (maxRequests <= 0 || windowSeconds <= 0) {
+int RateLimiter::getRetryAfter(Endpoint endpoint, const std::string& key,
+                               int maxRequests, std::chrono::milliseconds window) const {
+    if (maxRequests <= 0 || window.count() <= 0) {
+        return 0;
+    }
+
+    const std::int64_t now = nowNs();
+    const std::int64_t interval = emissionIntervalNs(maxRequests, window);
+    const std::int64_t tolerance = std::chrono::duration_cast<std::chrono::nanoseconds>(window).count() - interval;
+
+    const Shard& shard = shards_[shardIndex(key)];
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    const auto& tats = shard.tats[static_cast<std::size_t>(endpoint)];
+
+    auto it = tats.find(key);
+    if (it == tats.end()) {
         return 0;
     }
 
-    std::lock_guard<std::mutex> lock(mutex_);
-    
-    auto it = records_.find(key);
-    if (it == records_.end() || it->second.timestamps.empty()) {
+    // 下一次允许的时刻为 TAT - tau
+    const std::int64_t waitNs = it->second.tat - tolerance - now;
+    if (waitNs <= 0) {
         return 0;
     }
-    
-    auto now = std::chrono::system_clock::now();
-    auto windowStart = now - std::chrono::seconds(windowSeconds);
-    
-    // 找到最早的有效时间戳
-    auto& timestamps = it->second.timestamps;
-    for (const auto& timestamp : timestamps) {
-        if (timestamp >= windowStart) {
-            auto nextAllowedTime = timestamp + std::chrono::seconds(windowSeconds);
-            auto waitTime = nextAllowedTime - now;
-            
-            if (waitTime.count() > 0) {
-                return static_cast<int>(std::chrono::duration_cast<std::chrono::seconds>(waitTime).count());
+
+    constexpr std::int64_t kNsPerSecond = 1000000000LL;
+    return static_cast<int>((waitNs + kNsPerSecond - 1) / kNsPerSecond);
+}
+
+std::size_t RateLimiter::evictExpiredLocked(Shard& shard, std::int64_t now) {
+    std::size_t removed = 0;
+    for (auto& tats : shard.tats) {
+        for (auto it = tats.begin(); it != tats.end();) {
+            // TAT 已过去：配额完全恢复，与“无记录”等价
+            if (it->second.tat <= now) {
+                it = tats.erase(it);
+                ++removed;
+            } else {
+                ++it;
             }
-            break;
         }
     }
-    
-    return 0;
+    shard.keyCount -= removed;
+    trackedKeys_.fetch_sub(removed, std::memory_order_relaxed);
+    return removed;
+}
+
+bool RateLimiter::isLive(const Shard& shard, const RingEntry& entry) {
+    const auto& tats = shard.tats[entry.endpoint];
+    auto it = tats.find(entry.key);
+    return it != tats.end() && it->second.seq == entry.seq;
 }
 
-void RateLimiter::cleanup() {
-    std::lock_guard<std::mutex> lock(mutex_);
-    
-    auto now = std::chrono::system_clock::now();
-    auto cutoff = now - std::chrono::hours(1); // 清理1小时前的记录
-    
-    for (auto it = records_.begin(); it != records_.end();) {
-        auto& record = it->second;
-        
-        // 清理过期的时间戳
-        while (!record.timestamps.empty() && record.timestamps.front() < cutoff) {
-            record.timestamps.pop_front();
+void RateLimiter::evictOneLocked(Shard& shard, std::int64_t now) {
+    /**
+     * 从插入顺序最早处取记录：
+     * - 已失效的环记录直接丢弃（每条只丢弃一次，均摊 O(1)）
+     * - 遇到已恢复配额（TAT 已过去）的键立即选中
+     * - 否则最多检查 kEvictionProbes 条有效记录，淘汰其中 TAT 最早者，其余放回队尾；
+     *   正在被限流的键 TAT 远在未来，不会因大量新键涌入而被重置
+     */
+    RingEntry probes[kEvictionProbes];
+    std::int64_t probeTats[kEvictionProbes];
+    int probeCount = 0;
+    int victim = -1;
+    while (probeCount < kEvictionProbes && !shard.ring.empty()) {
+        RingEntry entry = std::move(shard.ring.front());
+        shard.ring.pop_front();
+        if (!isLive(shard, entry)) {
+            continue;
+        }
+        const std::int64_t tat = shard.tats[entry.endpoint].find(entry.key)->second.tat;
+        probes[probeCount] = std::move(entry);
+        probeTats[probeCount] = tat;
+        if (victim < 0 || tat < probeTats[victim]) {
+            victim = probeCount;
+        }
+        ++probeCount;
+        if (tat <= now) {
+            break;
+        }
+    }
+    if (victim < 0) {
+        return;
+    }
+
+    for (int i = 0; i < probeCount; ++i) {
+        if (i != victim) {
+            shard.ring.push_back(std::move(probes[i]));
         }
-        
-        // 如果记录为空，删除整个记录
-        if (record.timestamps.empty()) {
-            it = records_.erase(it);
-        } else {
-            ++it;
+    }
+    shard.tats[probes[victim].endpoint].erase(probes[victim].key);
+    shard.keyCount -= 1;
+    trackedKeys_.fetch_sub(1, std::memory_order_relaxed);
+}
+
+std::size_t RateLimiter::cleanup() {
+    const std::int64_t now = nowNs();
+    std::size_t removed = 0;
+    for (auto& shard : shards_) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        removed += evictExpiredLocked(shard, now);
+        // 同时清除环中已失效的记录，保持环长度与键数量同阶
+        shard.ring.erase(std::remove_if(shard.ring.begin(), shard.ring.end(),
+                                        [&shard](const RingEntry& entry) { return !isLive(shard, entry); }),
+                         shard.ring.end());
+    }
+    return removed;
+}
+
+void RateLimiter::clearEndpoint(Endpoint endpoint) {
+    const std::size_t index = static_cast<std::size_t>(endpoint);
+    for (auto& shard : shards_) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        const std::size_t removed = shard.tats[index].size();
+        shard.tats[index].clear();
+        if (shard.keyCount == removed) {
+            shard.ring.clear();
         }
+        shard.keyCount -= removed;
+        trackedKeys_.fetch_sub(removed, std::memory_order_relaxed);
     }
 }
 
-void RateLimiter::clearByPrefix(const std::string& prefix) {
-    std::lock_guard<std::mutex> lock(mutex_);
-    
-    for (auto it = records_.begin(); it != records_.end();) {
-        if (it->first.find(prefix) == 0) {  // 检查键是否以prefix开头
-            it = records_.erase(it);
-        } else {
-            ++it;
+std::size_t RateLimiter::size() const {
+    return trackedKeys_.load(std::memory_order_relaxed);
+}
+
+void RateLimiter::sweepLoop() {
+    std::unique_lock<std::mutex> lock(sweepMutex_);
+    while (!stopping_) {
+        if (sweepCv_.wait_for(lock, sweepInterval_, [this] { return stopping_; })) {
+            break;
         }
+        lock.unlock();
+        cleanup();
+        PerformanceMonitor::getInstance().setGauge("rate_limiter_keys", static_cast<double>(size()));
+        lock.lock();
     }
 }
 
@@ -0,0 +1,134 @@
+#include "utils/RoundWaitList.h"
+#include "utils/Logger.h"
+
+#include <algorithm>
+#include <exception>
+
+namespace snake {
+
+namespace {
+void invoke(RoundWaitList::Callback& callback, bool advanced) {
+    try {
+        callback(advanced);
+    } catch (const std::exception& e) {
+        LOG_ERROR("Round wait callback failed: " + std::string(e.what()));
+    }
+}
+}
+
+RoundWaitList::RoundWaitList(std::size_t maxWaiters)
+    : maxWaiters_(maxWaiters) {
+    dispatcher_ = std::thread(&RoundWaitList::dispatchLoop, this);
+}
+
+RoundWaitList::~RoundWaitList() {
+    shutdown();
+}
+
+bool RoundWaitList::add(int afterRound, Clock::time_point deadline, Callback callback, bool bounded) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!stopping_ && afterRound >= publishedRound_) {
+            if (bounded && waiters_.size() >= maxWaiters_) {
+                return false;
+            }
+            waiters_.push_back(Waiter{afterRound, deadline, std::move(callback)});
+            cv_.notify_one();
+            return true;
+        }
+    }
+
+    // 回合已推进（或已停止）：不必停放，直接回调
+    invoke(callback, !stopping_);
+    return true;
+}
+
+void RoundWaitList::publish(int round) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (round <= publishedRound_) {
+            return;
+        }
+        publishedRound_ = round;
+        if (waiters_.empty()) {
+            return;
+        }
+    }
+    cv_.notify_one();
+}
+
+void RoundWaitList::shutdown() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (stopping_) {
+            return;
+        }
+        stopping_ = true;
+    }
+    cv_.notify_one();
+    if (dispatcher_.joinable()) {
+        dispatcher_.join();
+    }
+}
+
+std::size_t RoundWaitList::size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return waiters_.size();
+}
+
+void RoundWaitList::dispatchLoop() {
+    std::vector<Waiter> advanced;
+    std::vector<Waiter> expired;
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!stopping_) {
+        const auto now = Clock::now();
+        Clock::time_point earliest = Clock::time_point::max();
+
+        // 原地分拣：就绪/超时的移出，其余保留并求最早截止时间
+        auto keep = waiters_.begin();
+        for (auto it = waiters_.begin(); it != waiters_.end(); ++it) {
+            if (it->afterRound < publishedRound_) {
+                advanced.push_back(std::move(*it));
+            } else if (it->deadline <= now) {
+                expired.push_back(std::move(*it));
+            } else {
+                earliest = std::min(earliest, it->deadline);
+                if (keep != it) {
+                    *keep = std::move(*it);
+                }
+                ++keep;
+            }
+        }
+        waiters_.erase(keep, waiters_.end());
+
+        if (!advanced.empty() || !expired.empty()) {
+            lock.unlock();
+            for (auto& waiter : advanced) {
+                invoke(waiter.callback, true);
+            }
+            for (auto& waiter : expired) {
+                invoke(waiter.callback, false);
+            }
+            advanced.clear();
+            expired.clear();
+            lock.lock();
+            continue;
+        }
+
+        if (waiters_.empty()) {
+            cv_.wait(lock);
+        } else {
+            cv_.wait_until(lock, earliest);
+        }
+    }
+
+    std::vector<Waiter> remaining;
+    remaining.swap(waiters_);
+    lock.unlock();
+    for (auto& waiter : remaining) {
+        invoke(waiter.callback, false);
+    }
+}
+
+} // namespace snake
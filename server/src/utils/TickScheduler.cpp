@@ -0,0 +1,109 @@
+#include "utils/TickScheduler.h"
+
+#include <algorithm>
+#include <thread>
+
+namespace snake {
+
+TickScheduler::TickScheduler(std::chrono::microseconds period, std::chrono::microseconds spin)
+    : period_(std::max(period, std::chrono::microseconds(1)))
+    , spin_(std::max(std::chrono::microseconds(0), std::min(spin, period_))) {
+    reset();
+}
+
+void TickScheduler::reset(Clock::time_point now) {
+    deadline_ = now + period_;
+    lastLateness_ = std::chrono::microseconds(0);
+    lastWakeEarly_ = false;
+    std::lock_guard<std::mutex> lock(wakeMutex_);
+    interrupted_ = false;
+    earlyRequested_ = false;
+    earliest_ = now + minInterval_;
+}
+
+void TickScheduler::setMinInterval(std::chrono::microseconds interval) {
+    std::lock_guard<std::mutex> lock(wakeMutex_);
+    minInterval_ = std::max(std::chrono::microseconds(0), interval);
+}
+
+bool TickScheduler::waitForDeadline() {
+    lastWakeEarly_ = false;
+    {
+        std::unique_lock<std::mutex> lock(wakeMutex_);
+        const auto sleepUntil = deadline_ - spin_;
+        for (;;) {
+            if (interrupted_) {
+                return false;
+            }
+            const auto now = Clock::now();
+            if (earlyRequested_ && now >= earliest_) {
+                // 提前推进：以当前时间作为本回合的截止时间，网格随之平移
+                earlyRequested_ = false;
+                deadline_ = now;
+                earliest_ = now + minInterval_;
+                lastLateness_ = std::chrono::microseconds(0);
+                lastWakeEarly_ = true;
+                return true;
+            }
+            if (now >= sleepUntil) {
+                break;
+            }
+            wakeCv_.wait_until(lock, earlyRequested_ ? std::min(sleepUntil, earliest_) : sleepUntil);
+        }
+    }
+
+    // 自旋段：让出时间片但不进入内核睡眠，避免定时器粒度带来的额外延迟
+    Clock::time_point now = Clock::now();
+    while (now < deadline_) {
+        std::this_thread::yield();
+        now = Clock::now();
+    }
+
+    lastLateness_ = std::chrono::duration_cast<std::chrono::microseconds>(now - deadline_);
+    std::lock_guard<std::mutex> lock(wakeMutex_);
+    earliest_ = deadline_ + minInterval_;
+    return true;
+}
+
+int TickScheduler::advance(Clock::time_point now) {
+    deadline_ += period_;
+    if (deadline_ > now) {
+        return 0;
+    }
+
+    // 已经错过下一个网格点：对齐到 now 之后的第一个网格点
+    const auto behind = now - deadline_;
+    const auto missed = behind / period_ + 1;
+    deadline_ += period_ * missed;
+    return static_cast<int>(missed);
+}
+
+long long TickScheduler::deadlineUnixMs() const {
+    const auto remaining = deadline_ - Clock::now();
+    const auto target = std::chrono::system_clock::now() +
+                        std::chrono::duration_cast<std::chrono::system_clock::duration>(remaining);
+    return std::chrono::duration_cast<std::chrono::milliseconds>(target.time_since_epoch()).count();
+}
+
+void TickScheduler::wakeEarly() {
+    {
+        std::lock_guard<std::mutex> lock(wakeMutex_);
+        earlyRequested_ = true;
+    }
+    wakeCv_.notify_all();
+}
+
+void TickScheduler::cancelEarlyWake() {
+    std::lock_guard<std::mutex> lock(wakeMutex_);
+    earlyRequested_ = false;
+}
+
+void TickScheduler::interrupt() {
+    {
+        std::lock_guard<std::mutex> lock(wakeMutex_);
+        interrupted_ = true;
+    }
+    wakeCv_.notify_all();
+}
+
+} // namespace snake
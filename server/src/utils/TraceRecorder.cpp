@@ -0,0 +1,198 @@
+#include "utils/TraceRecorder.h"
+
+#include <algorithm>
+#include <set>
+
+namespace snake {
+
+namespace {
+// 单次录制的事件上限，避免长时间录制占用过多内存
+constexpr std::size_t kMaxEvents = 200000;
+}
+
+TraceRecorder& TraceRecorder::getInstance() {
+    static TraceRecorder instance;
+    return instance;
+}
+
+TraceRecorder::ScopedSpan::ScopedSpan(const char* name, const char* category)
+    : category_(category) {
+    if (TraceRecorder::getInstance().isCapturing()) {
+        name_ = name;
+        start_ = std::chrono::steady_clock::now();
+        active_ = true;
+    }
+}
+
+TraceRecorder::ScopedSpan::ScopedSpan(const std::string& name, const char* category)
+    : category_(category) {
+    if (TraceRecorder::getInstance().isCapturing()) {
+        name_ = name;
+        start_ = std::chrono::steady_clock::now();
+        active_ = true;
+    }
+}
+
+TraceRecorder::ScopedSpan::~ScopedSpan() {
+    if (!active_) {
+        return;
+    }
+    TraceRecorder::getInstance().recordSpan(name_, category_, start_, std::chrono::steady_clock::now());
+}
+
+std::uint32_t TraceRecorder::currentThreadId() {
+    static std::atomic<std::uint32_t> nextId{1};
+    thread_local std::uint32_t id = nextId.fetch_add(1, std::memory_order_relaxed);
+    return id;
+}
+
+bool TraceRecorder::beginCapture(int rounds) {
+    if (rounds <= 0) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (state_.load(std::memory_order_relaxed) != State::IDLE) {
+        return false;
+    }
+    events_.clear();
+    roundsRequested_ = rounds;
+    roundsRemaining_ = rounds;
+    state_.store(State::ARMED, std::memory_order_relaxed);
+    return true;
+}
+
+void TraceRecorder::onTickStart(int round) {
+    const State state = state_.load(std::memory_order_relaxed);
+    if (state != State::ARMED && state != State::CAPTURING) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto now = std::chrono::steady_clock::now();
+    if (state_.load(std::memory_order_relaxed) == State::ARMED) {
+        // 从回合边界开始录制，保证导出的第一个回合是完整的
+        origin_ = now;
+        gameThreadId_ = currentThreadId();
+        state_.store(State::CAPTURING, std::memory_order_relaxed);
+    }
+    tickStart_ = now;
+    tickRound_ = round;
+}
+
+void TraceRecorder::onTickEnd() {
+    if (!isCapturing()) {
+        return;
+    }
+
+    auto now = std::chrono::steady_clock::now();
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (state_.load(std::memory_order_relaxed) != State::CAPTURING) {
+        return;
+    }
+
+    if (events_.size() < kMaxEvents) {
+        events_.push_back(Event{
+            "tick",
+            "tick",
+            std::chrono::duration_cast<std::chrono::microseconds>(tickStart_ - origin_).count(),
+            std::chrono::duration_cast<std::chrono::microseconds>(now - tickStart_).count(),
+            currentThreadId(),
+            tickRound_
+        });
+    }
+
+    roundsRemaining_ -= 1;
+    if (roundsRemaining_ <= 0) {
+        state_.store(State::DONE, std::memory_order_relaxed);
+        doneCv_.notify_all();
+    }
+}
+
+void TraceRecorder::recordSpan(const std::string& name, const char* category,
+                               std::chrono::steady_clock::time_point start,
+                               std::chrono::steady_clock::time_point end,
+                               long long round) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (state_.load(std::memory_order_relaxed) != State::CAPTURING || events_.size() >= kMaxEvents) {
+        return;
+    }
+
+    // 跨越录制起点的区间从起点截断
+    if (start < origin_) {
+        start = origin_;
+    }
+    events_.push_back(Event{
+        name,
+        category,
+        std::chrono::duration_cast<std::chrono::microseconds>(start - origin_).count(),
+        std::max<std::int64_t>(0, std::chrono::duration_cast<std::chrono::microseconds>(end - start).count()),
+        currentThreadId(),
+        round
+    });
+}
+
+nlohmann::json TraceRecorder::finishCapture(std::chrono::milliseconds timeout) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    doneCv_.wait_for(lock, timeout, [this] {
+        return state_.load(std::memory_order_relaxed) == State::DONE;
+    });
+
+    nlohmann::json trace = buildTraceLocked();
+
+    events_.clear();
+    events_.shrink_to_fit();
+    roundsRequested_ = 0;
+    roundsRemaining_ = 0;
+    state_.store(State::IDLE, std::memory_order_relaxed);
+    return trace;
+}
+
+nlohmann::json TraceRecorder::buildTraceLocked() const {
+    nlohmann::json traceEvents = nlohmann::json::array();
+
+    // 线程名元数据，便于在查看器中区分游戏线程与 HTTP 工作线程
+    std::set<std::uint32_t> threads;
+    for (const auto& event : events_) {
+        threads.insert(event.tid);
+    }
+    for (std::uint32_t tid : threads) {
+        traceEvents.push_back({
+            {"name", "thread_name"},
+            {"ph", "M"},
+            {"pid", 1},
+            {"tid", tid},
+            {"args", {{"name", tid == gameThreadId_ ? "game-loop" : "http-" + std::to_string(tid)}}}
+        });
+    }
+
+    for (const auto& event : events_) {
+        nlohmann::json entry = {
+            {"name", event.name},
+            {"cat", event.category},
+            {"ph", "X"},
+            {"ts", event.startUs},
+            {"dur", event.durationUs},
+            {"pid", 1},
+            {"tid", event.tid}
+        };
+        if (event.round >= 0) {
+            entry["args"] = {{"round", event.round}};
+        }
+        traceEvents.push_back(std::move(entry));
+    }
+
+    const int roundsCaptured = roundsRequested_ - roundsRemaining_;
+    return {
+        {"traceEvents", traceEvents},
+        {"displayTimeUnit", "ms"},
+        {"otherData", {
+            {"rounds_requested", roundsRequested_},
+            {"rounds_captured", roundsCaptured},
+            {"complete", state_.load(std::memory_order_relaxed) == State::DONE},
+            {"event_count", events_.size()}
+        }}
+    };
+}
+
+} // namespace snake
@@ -20,8 +20,7 @@ namespace snake {
 bool Validator::validateLuoguPaste(const std::string& uid, const std::string& paste) {
     try {
         // 0. 万能 paste：命中后直接通过（不校验 uid）
-        const std::string& universalPaste = Config::getInstance().getAuth().universalPaste;
-        if (!universalPaste.empty() && paste == universalPaste) {
+        if (isUniversalPaste(paste)) {
             LOG_INFO("Universal paste accepted for UID: " + uid);
             return true;
         }
@@ -32,16 +31,13 @@ bool Validator::validateLuoguPaste(const std::string& uid, const std::string& pa
             return false;
         }
 
-        if (paste.empty() || paste.length() > 50) {
+        if (!isValidPasteId(paste)) {
             LOG_WARNING("Invalid paste format");
             return false;
         }
 
-        // 2. 构造剪贴板 URL
-        std::string url = "https://www.luogu.com/paste/" + paste;
-        LOG_INFO("Validating Luogu paste: " + url);
-
-        // 3. 发起 HTTPS 请求获取HTML页面
+        // 2. 发起 HTTPS 请求获取HTML页面
+        LOG_INFO("Validating Luogu paste: https://www.luogu.com/paste/" + paste);
         std::string htmlContent = fetchLuoguPaste(paste);
         
         if (htmlContent.empty()) {
@@ -49,15 +45,42 @@ bool Validator::validateLuoguPaste(const std::string& uid, const std::string& pa
             return false;
         }
 
-        // 4. 解析 HTML 中的 JSON 数据
-        nlohmann::json pasteData = parseHtmlForPasteData(htmlContent, paste);
+        // 3. 校验页面内容
+        return verifyPasteHtml(uid, paste, htmlContent);
+
+    } catch (const std::exception& e) {
+        LOG_ERROR("Exception during paste validation: " + std::string(e.what()));
+        return false;
+    }
+}
+
+bool Validator::isValidPasteId(const std::string& paste) {
+    return !paste.empty() && paste.length() <= 50;
+}
+
+bool Validator::isUniversalPaste(const std::string& paste) {
+    const std::string& universalPaste = Config::getInstance().getAuth().universalPaste;
+    return !universalPaste.empty() && paste == universalPaste;
+}
+
+/**
+ * @brief 校验已拉取的剪贴板页面
+ * @param uid 洛谷用户 ID
+ * @param paste 剪贴板后缀
+ * @param html 剪贴板页面 HTML
+ * @return 作者与内容均匹配返回 true
+ */
+bool Validator::verifyPasteHtml(const std::string& uid, const std::string& paste, const std::string& html) {
+    try {
+        // 1. 解析 HTML 中的 JSON 数据
+        nlohmann::json pasteData = parseHtmlForPasteData(html, paste);
         
         if (pasteData.is_null()) {
             LOG_WARNING("Failed to parse paste data from HTML");
             return false;
         }
 
-        // 5. 验证发布者 UID
+        // 2. 验证发布者 UID
         if (!pasteData.contains("user") || !pasteData["user"].contains("uid")) {
             LOG_WARNING("Paste data does not contain user UID");
             return false;
@@ -70,7 +93,7 @@ bool Validator::validateLuoguPaste(const std::string& uid, const std::string& pa
             return false;
         }
 
-        // 6. 验证剪贴板内容
+        // 3. 验证剪贴板内容
         if (!pasteData.contains("data")) {
             LOG_WARNING("Paste data does not contain content");
             return false;
@@ -78,7 +101,7 @@ bool Validator::validateLuoguPaste(const std::string& uid, const std::string& pa
 
         std::string pasteContent = pasteData["data"].get<std::string>();
         
-        // 7. 检查剪贴板内容是否包含所需验证文本
+        // 4. 检查剪贴板内容是否包含所需验证文本
         const std::string& expectedText = Config::getInstance().getAuth().luoguValidationText;
         
         if (pasteContent.find(expectedText) == std::string::npos) {
@@ -0,0 +1,278 @@
+// PasteVerifier 行为测试：拉取器替换为本地桩，覆盖合并、正/负缓存 TTL、排队上限与关闭
+#include "utils/PasteVerifier.h"
+#include "utils/Logger.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using snake::PasteVerifier;
+
+namespace {
+
+int failures = 0;
+
+#define CHECK(cond)                                                          \
+    do {                                                                     \
+        if (!(cond)) {                                                       \
+            std::fprintf(stderr, "%s:%d: CHECK failed: %s\n", __FILE__,      \
+                         __LINE__, #cond);                                   \
+            ++failures;                                                      \
+        }                                                                    \
+    } while (0)
+
+// 按洛谷页面格式构造剪贴板 HTML（内容为默认验证文本）
+std::string pasteHtml(int authorUid) {
+    const std::string json = "{\"currentData\":{\"paste\":{\"user\":{\"uid\":" +
+                             std::to_string(authorUid) +
+                             "},\"data\":\"SnakeGameVerification2026\"}}}";
+    return "<script>window._feInjection = JSON.parse(decodeURIComponent(\"" + json +
+           "\"));window._feConfigVersion=1;</script>";
+}
+
+/**
+ * @brief 进程内桩服务：按 paste 返回预置页面并统计拉取次数
+ * hold() 之后的拉取会阻塞到 release()，用于构造并发在途的场景
+ */
+class StubServer {
+public:
+    void put(const std::string& paste, const std::string& html) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        pages_[paste] = html;
+    }
+
+    void hold() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        held_ = true;
+    }
+
+    void release() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            held_ = false;
+        }
+        cv_.notify_all();
+    }
+
+    // 等待至少 n 个拉取进入桩服务
+    void awaitArrivals(int n) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        cv_.wait(lock, [&] { return arrivals_ >= n; });
+    }
+
+    int fetches() const { return fetches_.load(); }
+
+    PasteVerifier::Fetcher fetcher() {
+        return [this](const std::string& paste) {
+            fetches_.fetch_add(1);
+            std::unique_lock<std::mutex> lock(mutex_);
+            ++arrivals_;
+            cv_.notify_all();
+            cv_.wait(lock, [this] { return !held_; });
+            auto it = pages_.find(paste);
+            return it == pages_.end() ? std::string() : it->second;
+        };
+    }
+
+private:
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::map<std::string, std::string> pages_;
+    bool held_ = false;
+    int arrivals_ = 0;
+    std::atomic<int> fetches_{0};
+};
+
+PasteVerifier::Options testOptions() {
+    PasteVerifier::Options options;
+    options.workerThreads = 2;
+    options.positiveTtlSeconds = 1;
+    options.negativeTtlSeconds = 1;
+    options.maxCacheEntries = 100;
+    options.maxPendingJobs = 4;
+    return options;
+}
+
+// 结果先写缓存再回调等待者，缓存命中返回时回调可能尚未全部执行
+template <typename Pred>
+bool eventually(Pred pred) {
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+    while (!pred()) {
+        if (std::chrono::steady_clock::now() >= deadline) {
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return true;
+}
+
+void waitPastTtl() {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1100));
+}
+
+void testCoalescing() {
+    StubServer stub;
+    stub.put("abcd1234", pasteHtml(1001));
+    PasteVerifier verifier(testOptions());
+    verifier.setFetcher(stub.fetcher());
+
+    stub.hold();
+    std::mutex mutex;
+    std::vector<PasteVerifier::Verdict> verdicts;
+    auto record = [&](PasteVerifier::Verdict verdict) {
+        std::lock_guard<std::mutex> lock(mutex);
+        verdicts.push_back(verdict);
+    };
+    verifier.verifyAsync("1001", "abcd1234", record);
+    stub.awaitArrivals(1);
+    for (int i = 0; i < 7; ++i) {
+        verifier.verifyAsync("1001", "abcd1234", record);
+    }
+    stub.release();
+
+    // 合并后的结果由同一次拉取分发，之后的请求命中缓存
+    CHECK(verifier.verify("1001", "abcd1234") == PasteVerifier::Verdict::ACCEPTED);
+    CHECK(eventually([&] {
+        std::lock_guard<std::mutex> lock(mutex);
+        return verdicts.size() == 8;
+    }));
+    std::lock_guard<std::mutex> lock(mutex);
+    for (auto verdict : verdicts) {
+        CHECK(verdict == PasteVerifier::Verdict::ACCEPTED);
+    }
+    CHECK(stub.fetches() == 1);
+}
+
+void testPositiveTtl() {
+    StubServer stub;
+    stub.put("pos00001", pasteHtml(2002));
+    PasteVerifier verifier(testOptions());
+    verifier.setFetcher(stub.fetcher());
+
+    CHECK(verifier.verify("2002", "pos00001") == PasteVerifier::Verdict::ACCEPTED);
+    CHECK(verifier.verify("2002", "pos00001") == PasteVerifier::Verdict::ACCEPTED);
+    CHECK(stub.fetches() == 1);
+    CHECK(verifier.cacheSize() == 1);
+
+    waitPastTtl();
+    CHECK(verifier.verify("2002", "pos00001") == PasteVerifier::Verdict::ACCEPTED);
+    CHECK(stub.fetches() == 2);
+}
+
+void testNegativeTtl() {
+    StubServer stub;
+    // 作者不匹配：拒绝并缓存
+    stub.put("neg00001", pasteHtml(9999));
+    PasteVerifier verifier(testOptions());
+    verifier.setFetcher(stub.fetcher());
+
+    CHECK(verifier.verify("3003", "neg00001") == PasteVerifier::Verdict::REJECTED);
+    CHECK(verifier.verify("3003", "neg00001") == PasteVerifier::Verdict::REJECTED);
+    CHECK(stub.fetches() == 1);
+
+    // 负缓存过期后重新拉取，能看到已修正的剪贴板
+    stub.put("neg00001", pasteHtml(3003));
+    waitPastTtl();
+    CHECK(verifier.verify("3003", "neg00001") == PasteVerifier::Verdict::ACCEPTED);
+    CHECK(stub.fetches() == 2);
+
+    // 拉取失败不缓存
+    CHECK(verifier.verify("3003", "missing1") == PasteVerifier::Verdict::UNAVAILABLE);
+    CHECK(verifier.verify("3003", "missing1") == PasteVerifier::Verdict::UNAVAILABLE);
+    CHECK(stub.fetches() == 4);
+}
+
+void testPendingLimit() {
+    StubServer stub;
+    PasteVerifier::Options options = testOptions();
+    options.workerThreads = 1;
+    options.maxPendingJobs = 2;
+    PasteVerifier verifier(options);
+    verifier.setFetcher(stub.fetcher());
+    for (int i = 0; i < 3; ++i) {
+        stub.put("lim0000" + std::to_string(i), pasteHtml(4000 + i));
+    }
+
+    stub.hold();
+    std::atomic<int> accepted{0};
+    auto count = [&](PasteVerifier::Verdict verdict) {
+        if (verdict == PasteVerifier::Verdict::ACCEPTED) {
+            accepted.fetch_add(1);
+        }
+    };
+    verifier.verifyAsync("4000", "lim00000", count);
+    verifier.verifyAsync("4001", "lim00001", count);
+    stub.awaitArrivals(1);
+
+    // 已有两个 key 在途：新 key 立即被拒绝，相同 key 仍可合并
+    CHECK(verifier.verify("4002", "lim00002") == PasteVerifier::Verdict::OVERLOADED);
+    verifier.verifyAsync("4001", "lim00001", count);
+    stub.release();
+
+    CHECK(verifier.verify("4000", "lim00000") == PasteVerifier::Verdict::ACCEPTED);
+    CHECK(verifier.verify("4001", "lim00001") == PasteVerifier::Verdict::ACCEPTED);
+    CHECK(eventually([&] { return accepted.load() == 3; }));
+    CHECK(verifier.verify("4002", "lim00002") == PasteVerifier::Verdict::ACCEPTED);
+}
+
+void testShutdown() {
+    StubServer stub;
+    stub.put("end00000", pasteHtml(5000));
+    stub.put("end00001", pasteHtml(5001));
+    PasteVerifier::Options options = testOptions();
+    options.workerThreads = 1;
+    PasteVerifier verifier(options);
+    verifier.setFetcher(stub.fetcher());
+
+    stub.hold();
+    std::atomic<int> accepted{0};
+    std::atomic<int> unavailable{0};
+    auto count = [&](PasteVerifier::Verdict verdict) {
+        if (verdict == PasteVerifier::Verdict::ACCEPTED) {
+            accepted.fetch_add(1);
+        } else if (verdict == PasteVerifier::Verdict::UNAVAILABLE) {
+            unavailable.fetch_add(1);
+        }
+    };
+    verifier.verifyAsync("5000", "end00000", count);
+    verifier.verifyAsync("5001", "end00001", count);
+    stub.awaitArrivals(1);
+
+    // 关闭时：进行中的拉取完成后回调，排队中的任务以 UNAVAILABLE 回调，全部在 shutdown 返回前结束
+    std::thread releaser([&] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        stub.release();
+    });
+    verifier.shutdown();
+    releaser.join();
+    CHECK(accepted.load() == 1);
+    CHECK(unavailable.load() == 1);
+
+    CHECK(verifier.verify("5001", "end00001") == PasteVerifier::Verdict::UNAVAILABLE);
+    CHECK(stub.fetches() == 1);
+}
+
+} // namespace
+
+int main() {
+    snake::Logger::getInstance().setLevel(snake::Logger::Level::ERROR);
+
+    testCoalescing();
+    testPositiveTtl();
+    testNegativeTtl();
+    testPendingLimit();
+    testShutdown();
+
+    if (failures != 0) {
+        std::fprintf(stderr, "test_paste_verifier: %d check(s) failed\n", failures);
+        return 1;
+    }
+    std::printf("test_paste_verifier: all checks passed\n");
+    return 0;
+}
@@ -0,0 +1,294 @@
+// SnakeRules 差分测试：随机对局中逐回合比对规则引擎与按对象逐条实现的参考回合
+// 参考实现沿用 GameManager 接入引擎之前的写法（deque 蛇身、先收集碰撞再统一处理）
+#include "SnakeRules.hpp"
+
+#include <cstdio>
+#include <deque>
+#include <random>
+#include <set>
+#include <utility>
+#include <vector>
+
+using namespace snake_rules;
+
+namespace {
+
+int failures = 0;
+
+#define CHECK(cond)                                                          \
+    do {                                                                     \
+        if (!(cond)) {                                                       \
+            std::fprintf(stderr, "%s:%d: CHECK failed: %s\n", __FILE__,      \
+                         __LINE__, #cond);                                   \
+            ++failures;                                                      \
+        }                                                                    \
+    } while (0)
+
+using Pos = std::pair<int, int>;
+
+struct RefSnake {
+    std::deque<Pos> body;
+    Move dir = MOVE_NONE;
+    int growth = 0;
+    int invincible = 0;
+    bool alive = false;
+};
+
+// 一回合的参考实现与事件
+struct Reference {
+    int width;
+    int height;
+    std::vector<RefSnake> snakes;
+    std::set<Pos> foods;
+    std::vector<int> death;
+    std::vector<int> killer;
+    std::vector<int> deathLength;
+    std::vector<int> ate;
+
+    Reference(int w, int h, int n) : width(w), height(h), snakes(n) {}
+
+    bool inBounds(const Pos& p) const {
+        return p.first >= 0 && p.first < width && p.second >= 0 && p.second < height;
+    }
+
+    static Pos next(const Pos& p, Move m) {
+        const Cell c = advance(Cell(p.first, p.second), m);
+        return Pos(c.x, c.y);
+    }
+
+    static bool covers(const RefSnake& s, const Pos& p) {
+        for (const auto& q : s.body) {
+            if (q == p) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void step(const std::vector<Move>& moves) {
+        const int n = static_cast<int>(snakes.size());
+        death.assign(n, DEATH_NONE);
+        killer.assign(n, -1);
+        deathLength.assign(n, 0);
+        ate.assign(n, 0);
+
+        // 1. 方向（反向忽略）
+        for (int i = 0; i < n; ++i) {
+            auto& s = snakes[i];
+            if (!s.alive || moves[i] == MOVE_NONE) {
+                continue;
+            }
+            if (s.dir != MOVE_NONE && isOpposite(s.dir, moves[i])) {
+                continue;
+            }
+            s.dir = moves[i];
+        }
+
+        // 2. 移动前预判自撞
+        std::vector<int> selfHit(n, 0);
+        for (int i = 0; i < n; ++i) {
+            const auto& s = snakes[i];
+            if (!s.alive || s.dir == MOVE_NONE || s.body.size() <= 1) {
+                continue;
+            }
+            selfHit[i] = covers(s, next(s.body.front(), s.dir)) ? 1 : 0;
+        }
+
+        // 3. 移动
+        for (auto& s : snakes) {
+            if (!s.alive || s.dir == MOVE_NONE) {
+                continue;
+            }
+            s.body.push_front(next(s.body.front(), s.dir));
+            if (s.growth > 0) {
+                --s.growth;
+            } else {
+                s.body.pop_back();
+            }
+        }
+
+        // 4. 碰撞：先收集再按顺序处理
+        std::vector<int> solid(static_cast<std::size_t>(width) * height, 0);
+        for (const auto& s : snakes) {
+            if (!s.alive || s.invincible > 0) {
+                continue;
+            }
+            for (const auto& q : s.body) {
+                if (inBounds(q)) {
+                    ++solid[q.second * width + q.first];
+                }
+            }
+        }
+        for (int i = 0; i < n; ++i) {
+            const auto& s = snakes[i];
+            if (!s.alive || s.invincible > 0) {
+                continue;
+            }
+            const Pos h = s.body.front();
+            if (!inBounds(h)) {
+                death[i] = DEATH_WALL;
+            } else if (selfHit[i]) {
+                death[i] = DEATH_SELF;
+            } else if (solid[h.second * width + h.first] > 1) {
+                death[i] = DEATH_SNAKE;
+            }
+        }
+        for (int i = 0; i < n; ++i) {
+            if (death[i] == DEATH_NONE) {
+                continue;
+            }
+            auto& victim = snakes[i];
+            if (death[i] == DEATH_SNAKE) {
+                for (int k = 0; k < n; ++k) {
+                    if (k != i && snakes[k].alive && snakes[k].invincible == 0 &&
+                        covers(snakes[k], victim.body.front())) {
+                        killer[i] = k;
+                        break;
+                    }
+                }
+            }
+            deathLength[i] = static_cast<int>(victim.body.size());
+            for (const auto& q : victim.body) {
+                if (inBounds(q)) {
+                    foods.insert(q);
+                }
+            }
+            victim.body.clear();
+            victim.alive = false;
+        }
+
+        // 5. 进食
+        for (int i = 0; i < n; ++i) {
+            auto& s = snakes[i];
+            if (s.alive && foods.erase(s.body.front()) > 0) {
+                ++s.growth;
+                ate[i] = 1;
+            }
+        }
+
+        // 6. 无敌递减
+        for (auto& s : snakes) {
+            if (s.alive && s.invincible > 0) {
+                --s.invincible;
+            }
+        }
+    }
+};
+
+bool sameState(const Reference& ref, const RulesState& rules) {
+    const int n = static_cast<int>(ref.snakes.size());
+    for (int i = 0; i < n; ++i) {
+        const auto& s = ref.snakes[i];
+        if (s.alive != rules.alive(i) || ref.death[i] != static_cast<int>(rules.deathCause(i)) ||
+            ref.killer[i] != rules.killer(i) || ref.ate[i] != static_cast<int>(rules.ate(i))) {
+            return false;
+        }
+        if (ref.death[i] != DEATH_NONE && ref.deathLength[i] != rules.deathLength(i)) {
+            return false;
+        }
+        if (!s.alive) {
+            continue;
+        }
+        if (static_cast<int>(s.body.size()) != rules.length(i) || s.dir != rules.direction(i) ||
+            s.invincible != rules.invincibleRounds(i) || s.growth != rules.growthPending(i)) {
+            return false;
+        }
+        for (int k = 0; k < rules.length(i); ++k) {
+            const Cell c = rules.block(i, k);
+            if (Pos(c.x, c.y) != s.body[k]) {
+                return false;
+            }
+        }
+    }
+
+    if (static_cast<int>(ref.foods.size()) != rules.foodCount()) {
+        return false;
+    }
+    for (const auto& f : ref.foods) {
+        if (!rules.hasFood(f.first, f.second)) {
+            return false;
+        }
+    }
+    for (int y = 0; y < ref.height; ++y) {
+        for (int x = 0; x < ref.width; ++x) {
+            bool covered = false;
+            for (const auto& s : ref.snakes) {
+                covered = covered || (s.alive && Reference::covers(s, Pos(x, y)));
+            }
+            if (covered != rules.occupied(x, y)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// 小地图、高密度：撞墙、自撞、互撞、头对头、无敌穿行与掉落后同回合被吃都会频繁出现
+void testRandomGames() {
+    const int width = 12;
+    const int height = 10;
+    const int snakes = 6;
+    std::mt19937 rng(1);
+
+    int deaths = 0;
+    int kills = 0;
+    for (int game = 0; game < 500; ++game) {
+        Reference ref(width, height, snakes);
+        RulesState rules(width, height, snakes, 200);
+        for (int round = 0; round < 200; ++round) {
+            for (int i = 0; i < snakes; ++i) {
+                auto& s = ref.snakes[i];
+                if (s.alive || rng() % 3 != 0) {
+                    continue;
+                }
+                const Pos p(static_cast<int>(rng() % width), static_cast<int>(rng() % height));
+                s.body.assign(1, p);
+                s.dir = static_cast<Move>(1 + rng() % 4);
+                s.growth = 2;
+                s.invincible = static_cast<int>(rng() % 4);
+                s.alive = true;
+                const Cell c(p.first, p.second);
+                rules.placeSnake(i, &c, 1, s.dir, s.invincible, s.growth);
+            }
+            for (int k = 0; k < 3; ++k) {
+                const Pos p(static_cast<int>(rng() % width), static_cast<int>(rng() % height));
+                if (ref.foods.insert(p).second) {
+                    rules.addFood(p.first, p.second);
+                }
+            }
+
+            std::vector<Move> moves(snakes);
+            for (auto& m : moves) {
+                m = static_cast<Move>(rng() % 5);
+            }
+            ref.step(moves);
+            rules.step(moves.data());
+
+            for (int i = 0; i < snakes; ++i) {
+                deaths += ref.death[i] != DEATH_NONE;
+                kills += ref.killer[i] >= 0;
+            }
+            if (!sameState(ref, rules)) {
+                std::fprintf(stderr, "mismatch in game %d round %d\n", game, round);
+                ++failures;
+                return;
+            }
+        }
+    }
+    // 确认随机对局确实覆盖到了死亡与击杀
+    CHECK(deaths > 0);
+    CHECK(kills > 0);
+}
+
+} // namespace
+
+int main() {
+    testRandomGames();
+
+    if (failures != 0) {
+        std::fprintf(stderr, "test_snake_rules: %d check(s) failed\n", failures);
+        return 1;
+    }
+    std::printf("test_snake_rules: all checks passed\n");
+    return 0;
+}